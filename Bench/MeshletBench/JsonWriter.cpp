@@ -0,0 +1,164 @@
+#include "JsonWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "Log/Log.h"
+
+void JsonWriter::BeginObject()
+{
+    BeginValue();
+    m_Buffer += '{';
+    m_FirstInScope.emplace_back(true);
+}
+
+void JsonWriter::EndObject()
+{
+    ASSERT(!m_FirstInScope.empty() && !m_AfterKey, "Unbalanced JSON object!")
+
+    m_FirstInScope.pop_back();
+    m_Buffer += '}';
+}
+
+void JsonWriter::BeginArray()
+{
+    BeginValue();
+    m_Buffer += '[';
+    m_FirstInScope.emplace_back(true);
+}
+
+void JsonWriter::EndArray()
+{
+    ASSERT(!m_FirstInScope.empty() && !m_AfterKey, "Unbalanced JSON array!")
+
+    m_FirstInScope.pop_back();
+    m_Buffer += ']';
+}
+
+JsonWriter& JsonWriter::Key(const std::string& key)
+{
+    BeginValue();
+    WriteEscaped(key);
+    m_Buffer += ':';
+    m_AfterKey = true;
+
+    return *this;
+}
+
+void JsonWriter::Value(const double value)
+{
+    BeginValue();
+
+    // JSON has no representation of NaN or infinity.
+    if (!std::isfinite(value))
+    {
+        m_Buffer += "null";
+        return;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    m_Buffer += buffer;
+}
+
+void JsonWriter::Value(const uint64_t value)
+{
+    BeginValue();
+    m_Buffer += std::to_string(value);
+}
+
+void JsonWriter::Value(const uint32_t value)
+{
+    Value(static_cast<uint64_t>(value));
+}
+
+void JsonWriter::Value(const bool value)
+{
+    BeginValue();
+    m_Buffer += value ? "true" : "false";
+}
+
+void JsonWriter::Value(const std::string& value)
+{
+    BeginValue();
+    WriteEscaped(value);
+}
+
+void JsonWriter::Value(const char* value)
+{
+    Value(std::string(value));
+}
+
+bool JsonWriter::WriteToFile(const std::string& filePath) const
+{
+    ASSERT(m_FirstInScope.empty(), "Some of the JSON scopes were not closed!")
+
+    std::ofstream file(filePath, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file << m_Buffer << '\n';
+
+    return file.good();
+}
+
+void JsonWriter::BeginValue()
+{
+    // A value following a key doesn't need a separator.
+    if (m_AfterKey)
+    {
+        m_AfterKey = false;
+        return;
+    }
+
+    if (!m_FirstInScope.empty())
+    {
+        if (!m_FirstInScope.back())
+        {
+            m_Buffer += ',';
+        }
+
+        m_FirstInScope.back() = false;
+    }
+}
+
+void JsonWriter::WriteEscaped(const std::string& value)
+{
+    m_Buffer += '"';
+
+    for (const char c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            m_Buffer += "\\\"";
+            break;
+        case '\\':
+            m_Buffer += "\\\\";
+            break;
+        case '\n':
+            m_Buffer += "\\n";
+            break;
+        case '\t':
+            m_Buffer += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                m_Buffer += buffer;
+            }
+            else
+            {
+                m_Buffer += c;
+            }
+        }
+    }
+
+    m_Buffer += '"';
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal streaming JSON writer for the benchmark results. Commas and nesting are tracked, so the scopes only have to
+ * be opened and closed in the right order.
+ */
+class JsonWriter
+{
+
+  public:
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    JsonWriter& Key(const std::string& key);
+
+    void Value(const double value);
+    void Value(const uint64_t value);
+    void Value(const uint32_t value);
+    void Value(const bool value);
+    void Value(const std::string& value);
+    void Value(const char* value);
+
+    template <typename T>
+    void Field(const std::string& key, const T& value)
+    {
+        Key(key);
+        Value(value);
+    }
+
+    const std::string& GetString() const
+    {
+        return m_Buffer;
+    }
+
+    /**
+     * @brief Writes the document into the given file.
+     * @return false if the file couldn't be written.
+     */
+    bool WriteToFile(const std::string& filePath) const;
+
+  private:
+    void BeginValue();
+    void WriteEscaped(const std::string& value);
+
+    std::string m_Buffer;
+    // One entry per open scope. True until the first element of the scope has been written.
+    std::vector<bool> m_FirstInScope;
+    bool m_AfterKey = false;
+};
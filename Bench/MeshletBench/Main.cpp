@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "JsonWriter.h"
+#include "MeshFile.h"
+#include "MeshletBenchmarks.h"
+#include "SyntheticMesh.h"
+#include "ThreadUtils.h"
+
+static void PrintUsage()
+{
+    std::printf("Usage: MeshletBench [--triangles <count>] [--threads <max threads>] [--views <count>]\n"
+                "                    [--cache <size>] [--mesh <file>]... [--json <output file>]\n"
+                "  --triangles  triangles of the synthetic grid, 0 skips the grid (default 4000000)\n"
+                "  --mesh       a model file (OBJ, ...) to benchmark, can be repeated\n"
+                "  --json       where to write the results (default MeshletBench.json)\n");
+}
+
+int main(int argc, char** argv)
+{
+    size_t triangleCount = 4'000'000;
+    uint32_t maxThreads = ThreadUtils::GetThreadCount();
+    uint32_t viewCount = 64;
+    uint32_t cacheSize = 32;
+    std::vector<std::string> meshFiles;
+    std::string jsonPath = "MeshletBench.json";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--triangles") == 0 && i + 1 < argc)
+        {
+            triangleCount = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            maxThreads = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--views") == 0 && i + 1 < argc)
+        {
+            viewCount = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cacheSize = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--mesh") == 0 && i + 1 < argc)
+        {
+            meshFiles.emplace_back(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<BenchMesh> meshes;
+
+    if (triangleCount > 0)
+    {
+        meshes.emplace_back(SyntheticMesh::CreateGridWithTriangles(triangleCount));
+    }
+
+    bool valid = true;
+
+    for (const std::string& file : meshFiles)
+    {
+        BenchMesh mesh;
+
+        if (!MeshFile::Load(file, mesh))
+        {
+            valid = false;
+            continue;
+        }
+
+        meshes.emplace_back(std::move(mesh));
+    }
+
+    JsonWriter json;
+    json.BeginObject();
+    json.Field("threads", maxThreads);
+    json.Field("views", viewCount);
+    json.Key("meshes").BeginArray();
+
+    for (BenchMesh& mesh : meshes)
+    {
+        json.BeginObject();
+        json.Field("name", mesh.name);
+        json.Field("triangles", static_cast<uint64_t>(mesh.indices.size() / 3));
+        json.Field("vertices", static_cast<uint64_t>(mesh.vertices.size()));
+
+        valid &= MeshletBenchmarks::RunAdjacency(mesh, maxThreads, json);
+        valid &= MeshletBenchmarks::RunVertexWelding(mesh, maxThreads, json);
+        valid &= MeshletBenchmarks::RunTipsify(mesh, cacheSize, json);
+        valid &= MeshletBenchmarks::RunIndexCodec(mesh, cacheSize, json);
+        valid &= MeshletBenchmarks::RunVertexQuantization(mesh, json);
+        valid &= MeshletBenchmarks::RunMeshCache(mesh, json);
+        valid &= MeshletBenchmarks::RunModelLoadScaling(mesh, maxThreads, json);
+        valid &= MeshletBenchmarks::RunLodGenerator(mesh, maxThreads, json);
+        valid &= MeshletBenchmarks::RunVertexCacheOptimizers(mesh, cacheSize, json);
+        valid &= MeshletBenchmarks::RunOverdraw(mesh, cacheSize, json);
+
+        // The pipeline metrics leave the mesh optimized by Tipsify, the same way Mesh does before meshletizing.
+        valid &= MeshletBenchmarks::RunPipelineMetrics(mesh, cacheSize, json);
+        valid &= MeshletBenchmarks::RunMeshletizeScaling(mesh, maxThreads, json);
+        valid &= MeshletBenchmarks::RunFixedMeshletizer(mesh, json);
+        valid &= MeshletBenchmarks::RunBuilderComparison(mesh, viewCount, json);
+        valid &= MeshletBenchmarks::RunConeCulling(mesh, viewCount, json);
+        valid &= MeshletBenchmarks::RunMeshletGroups(mesh, viewCount, json);
+        valid &= MeshletBenchmarks::RunClusterLOD(mesh, json);
+
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.Field("valid", valid);
+    json.EndObject();
+
+    if (!json.WriteToFile(jsonPath))
+    {
+        std::fprintf(stderr, "Failed to write the results into %s!\n", jsonPath.c_str());
+        return 1;
+    }
+
+    std::printf("\nResults written into %s\n", jsonPath.c_str());
+
+    return valid ? 0 : 1;
+}
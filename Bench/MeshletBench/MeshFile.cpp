@@ -0,0 +1,67 @@
+#include "MeshFile.h"
+
+#include <cstdio>
+#include <filesystem>
+
+#include "assimp/Importer.hpp"
+#include "assimp/postprocess.h"
+#include "assimp/scene.h"
+
+bool MeshFile::Load(const std::string& filePath, BenchMesh& outMesh)
+{
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(filePath.data(), aiProcess_Triangulate | aiProcess_GenNormals |
+                                                                  aiProcess_JoinIdenticalVertices);
+
+    if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || scene->mRootNode == nullptr)
+    {
+        std::fprintf(stderr, "Failed to import %s! %s\n", filePath.c_str(), importer.GetErrorString());
+        return false;
+    }
+
+    outMesh = {};
+    outMesh.name = std::filesystem::path(filePath).filename().string();
+
+    // The node transformations are ignored, the meshes are only concatenated.
+    for (uint32_t m = 0; m < scene->mNumMeshes; m++)
+    {
+        const aiMesh* mesh = scene->mMeshes[m];
+        const uint32_t baseVertex = outMesh.vertices.size();
+
+        for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+        {
+            MeshVertex vertex{};
+            vertex.Position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+
+            if (mesh->HasNormals())
+            {
+                vertex.Normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+            }
+
+            if (mesh->mTextureCoords[0] != nullptr)
+            {
+                vertex.TexCoords = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
+            }
+
+            outMesh.vertices.emplace_back(vertex);
+        }
+
+        for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+        {
+            const aiFace& face = mesh->mFaces[i];
+
+            // Points and lines survive the triangulation.
+            if (face.mNumIndices != 3)
+            {
+                continue;
+            }
+
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                outMesh.indices.emplace_back(baseVertex + face.mIndices[j]);
+            }
+        }
+    }
+
+    return !outMesh.indices.empty();
+}
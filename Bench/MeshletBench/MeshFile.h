@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#include "SyntheticMesh.h"
+
+class MeshFile
+{
+
+  public:
+    /**
+     * @brief Imports a model file (OBJ or any other format supported by assimp) with the same post-processing as
+     * Model does and merges all of its meshes into a single one. Nothing is uploaded to the GPU.
+     * @param outMesh - the merged mesh. The name is set to the file name.
+     * @return false if the file could not be imported.
+     */
+    static bool Load(const std::string& filePath, BenchMesh& outMesh);
+};
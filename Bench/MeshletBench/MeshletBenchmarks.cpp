@@ -0,0 +1,1860 @@
+#include "MeshletBenchmarks.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+#include "Mesh/ClusterLOD.h"
+#include "Mesh/IndexCodec.h"
+#include "Mesh/LODGenerator.h"
+#include "Mesh/MeshCache.h"
+#include "Mesh/MeshUtils.h"
+#include "Mesh/MeshletBuilder.h"
+#include "Mesh/MeshletCulling.h"
+#include "Mesh/MeshletEncoding.h"
+#include "Mesh/MeshletGeneration.h"
+#include "Mesh/MeshletGrouping.h"
+#include "Mesh/OverdrawOptimizer.h"
+#include "Mesh/VertexWelder.h"
+#include "Mesh/VertexCacheOptimizer.h"
+#include "Mesh/VertexQuantization.h"
+#include "MemoryStats.h"
+#include "MeshletValidation.h"
+#include "ReferenceTipsify.h"
+#include "ThreadUtils.h"
+#include "glm/geometric.hpp"
+#include "src/meshoptimizer.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(const Clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool MeshletBenchmarks::RunMeshletizeScaling(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Meshletization scaling: %s (%zu triangles)\n", mesh.name.c_str(), triangleCount);
+
+    std::vector<uint32_t> meshletVertices, meshletTriangles;
+
+    Clock::time_point start = Clock::now();
+    std::vector<NewMeshlet> meshlets = MeshletGeneration::MeshletizeNv(
+        Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, mesh.indices, mesh.vertices.size(),
+        meshletVertices, meshletTriangles);
+    const double serialMs = ElapsedMs(start);
+
+    bool valid = MeshletValidation::Validate(mesh.indices, meshlets, meshletVertices, meshletTriangles,
+                                             Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_TRIANGLES);
+
+    std::printf("%-12s %10s %12s %10s %10s %s\n", "mode", "time [ms]", "Mtris/s", "speedup", "meshlets", "valid");
+    std::printf("%-12s %10.2f %12.2f %10.2f %10zu %s\n", "serial", serialMs, triangleCount / serialMs / 1000.0, 1.0,
+                meshlets.size(), valid ? "yes" : "NO");
+
+    json.Key("meshletizeScaling").BeginObject();
+    json.Field("serialMs", serialMs);
+    json.Field("serialTrianglesPerSecond", triangleCount / serialMs * 1000.0);
+    json.Field("meshletCount", static_cast<uint64_t>(meshlets.size()));
+    json.Key("parallel").BeginArray();
+
+    // Powers of two up to the maximum, the maximum itself is always included.
+    std::vector<uint32_t> threadCounts;
+
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.emplace_back(threads);
+    }
+
+    threadCounts.emplace_back(maxThreads);
+
+    std::vector<NewMeshlet> reference;
+
+    for (const uint32_t threads : threadCounts)
+    {
+        meshletVertices.clear();
+        meshletTriangles.clear();
+
+        start = Clock::now();
+        meshlets = MeshletGeneration::MeshletizeNvParallel(Constants::MAX_MESHLET_VERTICES,
+                                                           Constants::MAX_MESHLET_INDICES, mesh.indices,
+                                                           mesh.vertices.size(), meshletVertices, meshletTriangles,
+                                                           threads);
+        const double parallelMs = ElapsedMs(start);
+
+        bool parallelValid = MeshletValidation::Validate(mesh.indices, meshlets, meshletVertices, meshletTriangles,
+                                                         Constants::MAX_MESHLET_VERTICES,
+                                                         Constants::MAX_MESHLET_TRIANGLES);
+
+        // The output has to be the same no matter how many threads were used.
+        if (reference.empty())
+        {
+            reference = meshlets;
+        }
+        else
+        {
+            parallelValid &= reference.size() == meshlets.size() &&
+                             std::memcmp(reference.data(), meshlets.data(), meshlets.size() * sizeof(NewMeshlet)) == 0;
+        }
+
+        valid &= parallelValid;
+
+        std::printf("%-3u %-8s %10.2f %12.2f %10.2f %10zu %s\n", threads, "threads", parallelMs,
+                    triangleCount / parallelMs / 1000.0, serialMs / parallelMs, meshlets.size(),
+                    parallelValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("threads", threads);
+        json.Field("ms", parallelMs);
+        json.Field("trianglesPerSecond", triangleCount / parallelMs * 1000.0);
+        json.Field("speedup", serialMs / parallelMs);
+        json.Field("valid", parallelValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunAdjacency(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json)
+{
+    const uint32_t* indices = mesh.indices.data();
+    const size_t indexCount = mesh.indices.size();
+    const size_t vertexCount = mesh.vertices.size();
+
+    std::printf("\n--- Adjacency: %s (%zu indices)\n", mesh.name.c_str(), indexCount);
+
+    VertexTriangleAdjacency reference;
+
+    Clock::time_point start = Clock::now();
+    MeshUtils::BuildVertexTriangleAdjacency(indices, indexCount, vertexCount, reference);
+    const double serialMs = ElapsedMs(start);
+
+    std::printf("%-12s %10s %12s %10s %s\n", "mode", "time [ms]", "Mindices/s", "speedup", "same");
+    std::printf("%-12s %10.2f %12.2f %10.2f %s\n", "serial", serialMs, indexCount / serialMs / 1000.0, 1.0, "yes");
+
+    json.Key("adjacency").BeginObject();
+    json.Field("serialMs", serialMs);
+    json.Key("parallel").BeginArray();
+
+    std::vector<uint32_t> threadCounts;
+
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.emplace_back(threads);
+    }
+
+    threadCounts.emplace_back(maxThreads);
+
+    bool valid = true;
+    VertexTriangleAdjacency adjacency;
+
+    for (const uint32_t threads : threadCounts)
+    {
+        start = Clock::now();
+        MeshUtils::BuildVertexTriangleAdjacencyParallel(indices, indexCount, vertexCount, adjacency, threads);
+        const double parallelMs = ElapsedMs(start);
+
+        const bool same = adjacency.vertexCount == reference.vertexCount && adjacency.offsets == reference.offsets &&
+                          adjacency.adjacencyList == reference.adjacencyList;
+        valid &= same;
+
+        std::printf("%-3u %-8s %10.2f %12.2f %10.2f %s\n", threads, "threads", parallelMs,
+                    indexCount / parallelMs / 1000.0, serialMs / parallelMs, same ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("threads", threads);
+        json.Field("ms", parallelMs);
+        json.Field("speedup", serialMs / parallelMs);
+        json.Field("same", same);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    // --- Half-edges
+    EdgeAdjacency edges;
+
+    start = Clock::now();
+    MeshUtils::BuildEdgeAdjacency(indices, indexCount, reference, edges, maxThreads);
+    const double edgeMs = ElapsedMs(start);
+
+    size_t boundaryEdges = 0;
+    bool edgesValid = true;
+
+    for (size_t i = 0; i < edges.opposite.size(); i++)
+    {
+        if (edges.IsBoundary(i))
+        {
+            boundaryEdges++;
+            continue;
+        }
+
+        const uint32_t opposite = edges.opposite[i];
+
+        edgesValid &= edges.opposite[opposite] == i && indices[opposite] == indices[EdgeAdjacency::GetNext(i)] &&
+                      indices[EdgeAdjacency::GetNext(opposite)] == indices[i];
+    }
+
+    valid &= edgesValid;
+
+    std::printf("half-edges: %.2f ms, %zu of %zu without an opposite edge, %s\n", edgeMs, boundaryEdges,
+                edges.opposite.size(), edgesValid ? "valid" : "INVALID");
+
+    json.Field("halfEdgeMs", edgeMs);
+    json.Field("boundaryHalfEdges", static_cast<uint64_t>(boundaryEdges));
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunVertexWelding(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json)
+{
+    std::printf("\n--- Vertex welding: %s (%zu indices)\n", mesh.name.c_str(), mesh.indices.size());
+
+    std::vector<MeshVertex> splitVertices(mesh.indices.size());
+
+    for (size_t i = 0; i < mesh.indices.size(); i++)
+    {
+        splitVertices[i] = mesh.vertices[mesh.indices[i]];
+    }
+
+    std::vector<uint32_t> referencedVertices = mesh.indices;
+    std::sort(referencedVertices.begin(), referencedVertices.end());
+    const size_t expectedCount =
+        std::unique(referencedVertices.begin(), referencedVertices.end()) - referencedVertices.begin();
+
+    json.Key("vertexWelding").BeginObject();
+    json.Key("weld").BeginArray();
+
+    bool valid = true;
+    std::vector<uint32_t> indices;
+    std::vector<MeshVertex> vertices;
+
+    for (const uint32_t threads : {1u, maxThreads})
+    {
+        indices.resize(mesh.indices.size());
+
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            indices[i] = i;
+        }
+
+        vertices = splitVertices;
+
+        const Clock::time_point start = Clock::now();
+        const size_t weldedCount = VertexWelder::Weld(indices, vertices, 0.f, 0.f, threads);
+        const double weldMs = ElapsedMs(start);
+
+        bool weldValid = weldedCount == expectedCount;
+
+        for (size_t i = 0; weldValid && i < indices.size(); i++)
+        {
+            weldValid &= std::memcmp(&vertices[indices[i]].Position, &mesh.vertices[mesh.indices[i]].Position,
+                                     sizeof(glm::vec3)) == 0;
+        }
+
+        valid &= weldValid;
+
+        std::printf("%-3u threads %10.2f ms %10.2f Mvertices/s, %zu -> %zu vertices %s\n", threads, weldMs,
+                    splitVertices.size() / weldMs / 1000.0, splitVertices.size(), weldedCount,
+                    weldValid ? "valid" : "INVALID");
+
+        json.BeginObject();
+        json.Field("threads", threads);
+        json.Field("ms", weldMs);
+        json.Field("vertices", static_cast<uint64_t>(weldedCount));
+        json.Field("valid", weldValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    // --- Normals of the welded mesh.
+    const Clock::time_point start = Clock::now();
+    MeshUtils::GenerateNormals(indices, vertices, maxThreads);
+    const double normalsMs = ElapsedMs(start);
+
+    const bool normalsValid = std::all_of(vertices.begin(), vertices.end(), [](const MeshVertex& vertex) {
+        return std::abs(glm::length(vertex.Normal) - 1.f) < 1e-3f;
+    });
+
+    valid &= normalsValid;
+
+    std::printf("normals %.2f ms %s\n", normalsMs, normalsValid ? "valid" : "INVALID");
+
+    json.Field("normalsMs", normalsMs);
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+struct BuilderResult
+{
+    const char* name = "";
+    double milliseconds = 0.0;
+    std::vector<NewMeshlet> meshlets = {};
+    std::vector<uint32_t> meshletVertices = {};
+    // Packed the same way as MeshletizeNv does it (see MeshUtils::PackTriangleIntoUInt).
+    std::vector<uint32_t> meshletTriangles = {};
+};
+
+// Converts the output of meshopt_buildMeshlets to the layout used by MeshletGeneration.
+static BuilderResult BuildMeshoptMeshlets(const BenchMesh& mesh, const float coneWeight)
+{
+    const size_t maxMeshlets = meshopt_buildMeshletsBound(mesh.indices.size(), Constants::MAX_MESHLET_VERTICES,
+                                                          Constants::MAX_MESHLET_TRIANGLES);
+
+    std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+    std::vector<uint32_t> meshletVertices(maxMeshlets * Constants::MAX_MESHLET_VERTICES);
+    std::vector<uint8_t> meshletTriangles(maxMeshlets * Constants::MAX_MESHLET_TRIANGLES * 3);
+
+    Clock::time_point start = Clock::now();
+    const size_t meshletCount = meshopt_buildMeshlets(
+        meshlets.data(), meshletVertices.data(), meshletTriangles.data(), mesh.indices.data(), mesh.indices.size(),
+        &mesh.vertices[0].Position.x, mesh.vertices.size(), sizeof(MeshVertex), Constants::MAX_MESHLET_VERTICES,
+        Constants::MAX_MESHLET_TRIANGLES, coneWeight);
+
+    BuilderResult result = {.name = "meshopt", .milliseconds = ElapsedMs(start)};
+
+    for (size_t m = 0; m < meshletCount; m++)
+    {
+        const meshopt_Meshlet& meshlet = meshlets[m];
+
+        result.meshlets.emplace_back(NewMeshlet{
+            .vertexOffset = meshlet.vertex_offset,
+            .triangleOffset = static_cast<uint32_t>(result.meshletTriangles.size()),
+            .vertexCount = meshlet.vertex_count,
+            .triangleCount = meshlet.triangle_count,
+        });
+
+        for (uint32_t t = 0; t < meshlet.triangle_count; t++)
+        {
+            const uint8_t* triangle = &meshletTriangles[meshlet.triangle_offset + t * 3];
+            result.meshletTriangles.emplace_back(triangle[0] | (triangle[1] << 8) | (triangle[2] << 16));
+        }
+    }
+
+    result.meshletVertices = std::move(meshletVertices);
+
+    return result;
+}
+
+// Cameras placed randomly on a sphere three times larger than the bounding sphere of the mesh.
+static std::vector<glm::vec3> CreateRandomCameras(const BenchMesh& mesh, const uint32_t viewCount)
+{
+    glm::vec3 minPoint(std::numeric_limits<float>::max()), maxPoint(std::numeric_limits<float>::lowest());
+
+    for (const MeshVertex& vertex : mesh.vertices)
+    {
+        minPoint = glm::min(minPoint, vertex.Position);
+        maxPoint = glm::max(maxPoint, vertex.Position);
+    }
+
+    const glm::vec3 meshCenter = (minPoint + maxPoint) * 0.5f;
+    const float meshRadius = glm::length(maxPoint - meshCenter);
+
+    std::mt19937 random(1234);
+    std::normal_distribution<float> distribution;
+
+    std::vector<glm::vec3> cameras;
+
+    for (uint32_t v = 0; v < viewCount; v++)
+    {
+        glm::vec3 direction(distribution(random), distribution(random), distribution(random));
+        cameras.emplace_back(meshCenter + glm::normalize(direction) * meshRadius * 3.f);
+    }
+
+    return cameras;
+}
+
+template <uint32_t MaxVerts, uint32_t MaxTris>
+static bool CompareFixedMeshletizer(const BenchMesh& mesh, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    // Best of several runs, a single one is too noisy for the smaller meshes.
+    constexpr uint32_t RUNS = 5;
+
+    std::vector<NewMeshlet> runtimeMeshlets, fixedMeshlets;
+    std::vector<uint32_t> runtimeVertices, runtimeTriangles, fixedVertices, fixedTriangles;
+
+    double runtimeMs = std::numeric_limits<double>::max();
+    double fixedMs = std::numeric_limits<double>::max();
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        runtimeMeshlets.clear();
+        runtimeVertices.clear();
+        runtimeTriangles.clear();
+
+        Clock::time_point start = Clock::now();
+
+        MeshletBuilder builder(MaxVerts, MaxTris * 3, runtimeMeshlets, runtimeVertices, runtimeTriangles);
+        builder.PushIndices(mesh.indices.data(), mesh.indices.size());
+        builder.Finish();
+
+        runtimeMs = std::min(runtimeMs, ElapsedMs(start));
+
+        fixedVertices.clear();
+        fixedTriangles.clear();
+
+        start = Clock::now();
+        fixedMeshlets = MeshletGeneration::Meshletize<MaxVerts, MaxTris>(mesh.indices.data(), mesh.indices.size(),
+                                                                          fixedVertices, fixedTriangles);
+        fixedMs = std::min(fixedMs, ElapsedMs(start));
+    }
+
+    const bool identical = runtimeMeshlets.size() == fixedMeshlets.size() &&
+                           std::memcmp(runtimeMeshlets.data(), fixedMeshlets.data(),
+                                       runtimeMeshlets.size() * sizeof(NewMeshlet)) == 0 &&
+                           runtimeVertices == fixedVertices && runtimeTriangles == fixedTriangles;
+
+    const bool valid = identical && MeshletValidation::Validate(mesh.indices, fixedMeshlets, fixedVertices,
+                                                                fixedTriangles, MaxVerts, MaxTris);
+
+    std::printf("%4u/%-7u %12.2f %12.2f %10.2f %10zu %s\n", MaxVerts, MaxTris, runtimeMs, fixedMs,
+                runtimeMs / fixedMs, fixedMeshlets.size(), valid ? "yes" : "NO");
+
+    json.BeginObject();
+    json.Field("maxVertices", MaxVerts);
+    json.Field("maxTriangles", MaxTris);
+    json.Field("runtimeMs", runtimeMs);
+    json.Field("fixedMs", fixedMs);
+    json.Field("fixedTrianglesPerSecond", triangleCount / fixedMs * 1000.0);
+    json.Field("speedup", runtimeMs / fixedMs);
+    json.Field("meshletCount", static_cast<uint64_t>(fixedMeshlets.size()));
+    json.Field("identical", identical);
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunFixedMeshletizer(const BenchMesh& mesh, JsonWriter& json)
+{
+    std::printf("\n--- Fixed limit meshletizer: %s (%zu triangles)\n", mesh.name.c_str(), mesh.indices.size() / 3);
+    std::printf("%-12s %12s %12s %10s %10s %s\n", "limits", "runtime [ms]", "fixed [ms]", "speedup", "meshlets",
+                "valid");
+
+    json.Key("fixedMeshletizer").BeginArray();
+
+    bool valid = true;
+
+    valid &= CompareFixedMeshletizer<64, 84>(mesh, json);
+    valid &= CompareFixedMeshletizer<64, 126>(mesh, json);
+    valid &= CompareFixedMeshletizer<64, 128>(mesh, json);
+    valid &= CompareFixedMeshletizer<128, 256>(mesh, json);
+
+    json.EndArray();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunBuilderComparison(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json)
+{
+    std::printf("\n--- Meshlet builder comparison: %s (%zu triangles, %u views)\n", mesh.name.c_str(),
+                mesh.indices.size() / 3, viewCount);
+
+    const float coneWeight = 0.25f;
+
+    std::vector<BuilderResult> results;
+
+    for (const EMeshletStrategy strategy : {EMeshletStrategy::Greedy, EMeshletStrategy::Spatial})
+    {
+        MeshBuildOptions options;
+        options.meshletStrategy = strategy;
+        options.meshletConeWeight = coneWeight;
+
+        BuilderResult result = {.name = strategy == EMeshletStrategy::Greedy ? "greedy" : "spatial"};
+
+        Clock::time_point start = Clock::now();
+        result.meshlets = MeshletGeneration::Meshletize(options, Constants::MAX_MESHLET_VERTICES,
+                                                        Constants::MAX_MESHLET_INDICES, mesh.indices, mesh.vertices,
+                                                        result.meshletVertices, result.meshletTriangles);
+        result.milliseconds = ElapsedMs(start);
+
+        results.emplace_back(std::move(result));
+    }
+
+    results.emplace_back(BuildMeshoptMeshlets(mesh, coneWeight));
+
+    const std::vector<glm::vec3> cameras = CreateRandomCameras(mesh, viewCount);
+
+    std::printf("%-10s %10s %10s %12s %12s %12s %12s %s\n", "builder", "time [ms]", "meshlets", "vertex fill",
+                "tri fill", "avg radius", "cull rate", "valid");
+
+    json.Key("builders").BeginArray();
+
+    bool valid = true;
+
+    for (const BuilderResult& result : results)
+    {
+        const bool resultValid = MeshletValidation::Validate(mesh.indices, result.meshlets, result.meshletVertices,
+                                                             result.meshletTriangles, Constants::MAX_MESHLET_VERTICES,
+                                                             Constants::MAX_MESHLET_TRIANGLES);
+        valid &= resultValid;
+
+        double vertexFill = 0.0, triangleFill = 0.0, radiusSum = 0.0;
+        size_t culled = 0;
+
+        std::vector<uint8_t> triangles;
+
+        for (const NewMeshlet& meshlet : result.meshlets)
+        {
+            vertexFill += static_cast<double>(meshlet.vertexCount) / Constants::MAX_MESHLET_VERTICES;
+            triangleFill += static_cast<double>(meshlet.triangleCount) / Constants::MAX_MESHLET_TRIANGLES;
+
+            triangles.clear();
+
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+            {
+                const uint32_t packed = result.meshletTriangles[meshlet.triangleOffset + t];
+                triangles.insert(triangles.end(), {static_cast<uint8_t>(packed & 0xFF),
+                                                   static_cast<uint8_t>((packed >> 8) & 0xFF),
+                                                   static_cast<uint8_t>((packed >> 16) & 0xFF)});
+            }
+
+            const meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+                &result.meshletVertices[meshlet.vertexOffset], triangles.data(), meshlet.triangleCount,
+                &mesh.vertices[0].Position.x, mesh.vertices.size(), sizeof(MeshVertex));
+
+            radiusSum += bounds.radius;
+
+            const glm::vec3 apex(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+            const glm::vec3 axis(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+
+            for (const glm::vec3& camera : cameras)
+            {
+                if (glm::dot(glm::normalize(apex - camera), axis) >= bounds.cone_cutoff)
+                {
+                    culled++;
+                }
+            }
+        }
+
+        const double meshletCount = std::max<double>(result.meshlets.size(), 1.0);
+
+        std::printf("%-10s %10.2f %10zu %11.1f%% %11.1f%% %12.5f %11.1f%% %s\n", result.name, result.milliseconds,
+                    result.meshlets.size(), vertexFill / meshletCount * 100.0, triangleFill / meshletCount * 100.0,
+                    radiusSum / meshletCount, 100.0 * culled / (meshletCount * viewCount),
+                    resultValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("builder", result.name);
+        json.Field("ms", result.milliseconds);
+        json.Field("meshletCount", static_cast<uint64_t>(result.meshlets.size()));
+        json.Field("vertexFill", vertexFill / meshletCount);
+        json.Field("triangleFill", triangleFill / meshletCount);
+        json.Field("averageRadius", radiusSum / meshletCount);
+        json.Field("coneCullRate", culled / (meshletCount * viewCount));
+        json.Field("valid", resultValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunConeCulling(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json)
+{
+    std::printf("\n--- Meshlet cone culling: %s (%zu triangles, %u views)\n", mesh.name.c_str(),
+                mesh.indices.size() / 3, viewCount);
+
+    const std::vector<glm::vec3> cameras = CreateRandomCameras(mesh, viewCount);
+
+    std::printf("%-10s %12s %12s %14s %12s %12s %s\n", "builder", "bounds [ms]", "cull rate", "meshopt rate",
+                "wrong culls", "outside", "valid");
+
+    json.Key("coneCulling").BeginArray();
+
+    bool valid = true;
+
+    for (const EMeshletStrategy strategy : {EMeshletStrategy::Greedy, EMeshletStrategy::Spatial})
+    {
+        MeshBuildOptions options;
+        options.meshletStrategy = strategy;
+
+        std::vector<uint32_t> meshletVertices, meshletTriangles;
+        const std::vector<NewMeshlet> meshlets =
+            MeshletGeneration::Meshletize(options, Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES,
+                                          mesh.indices, mesh.vertices, meshletVertices, meshletTriangles);
+
+        Clock::time_point start = Clock::now();
+        const std::vector<MeshletBounds> bounds =
+            MeshletGeneration::ComputeMeshletBounds(mesh.vertices, meshletVertices, meshletTriangles, meshlets);
+        const double boundsMs = ElapsedMs(start);
+
+        // Culls of a meshlet with at least one triangle facing the camera and vertices outside of the sphere.
+        size_t culled = 0, meshoptCulled = 0, wrongCulls = 0, outside = 0;
+
+        std::vector<uint8_t> triangles;
+
+        for (size_t m = 0; m < meshlets.size(); m++)
+        {
+            const NewMeshlet& meshlet = meshlets[m];
+            const MeshletBounds& meshletBounds = bounds[m];
+
+            for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+            {
+                const glm::vec3& position = mesh.vertices[meshletVertices[meshlet.vertexOffset + v]].Position;
+
+                if (glm::length(position - meshletBounds.spherePos) > meshletBounds.sphereRadius * 1.0001f)
+                {
+                    outside++;
+                }
+            }
+
+            triangles.clear();
+
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+            {
+                const uint32_t packed = meshletTriangles[meshlet.triangleOffset + t];
+                triangles.insert(triangles.end(), {static_cast<uint8_t>(packed & 0xFF),
+                                                   static_cast<uint8_t>((packed >> 8) & 0xFF),
+                                                   static_cast<uint8_t>((packed >> 16) & 0xFF)});
+            }
+
+            const meshopt_Bounds reference = meshopt_computeMeshletBounds(
+                &meshletVertices[meshlet.vertexOffset], triangles.data(), meshlet.triangleCount,
+                &mesh.vertices[0].Position.x, mesh.vertices.size(), sizeof(MeshVertex));
+
+            const glm::vec3 referenceApex(reference.cone_apex[0], reference.cone_apex[1], reference.cone_apex[2]);
+            const glm::vec3 referenceAxis(reference.cone_axis[0], reference.cone_axis[1], reference.cone_axis[2]);
+
+            for (const glm::vec3& camera : cameras)
+            {
+                if (glm::dot(glm::normalize(referenceApex - camera), referenceAxis) >= reference.cone_cutoff)
+                {
+                    meshoptCulled++;
+                }
+
+                if (!MeshletCulling::IsBackfacing(meshletBounds, camera))
+                {
+                    continue;
+                }
+
+                culled++;
+
+                // Every triangle of a culled meshlet has to face away from the camera.
+                for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+                {
+                    const glm::vec3& a = mesh.vertices[meshletVertices[meshlet.vertexOffset + triangles[t * 3]]].Position;
+                    const glm::vec3& b =
+                        mesh.vertices[meshletVertices[meshlet.vertexOffset + triangles[t * 3 + 1]]].Position;
+                    const glm::vec3& c =
+                        mesh.vertices[meshletVertices[meshlet.vertexOffset + triangles[t * 3 + 2]]].Position;
+
+                    const glm::vec3 normal = glm::cross(b - a, c - a);
+
+                    if (glm::dot(normal, camera - a) > 1e-5f * glm::length(normal) * glm::length(camera - a))
+                    {
+                        wrongCulls++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        const double cullCount = std::max<double>(meshlets.size(), 1.0) * viewCount;
+        const bool resultValid = wrongCulls == 0 && outside == 0;
+        valid &= resultValid;
+
+        std::printf("%-10s %12.2f %11.1f%% %13.1f%% %12zu %12zu %s\n",
+                    strategy == EMeshletStrategy::Greedy ? "greedy" : "spatial", boundsMs, 100.0 * culled / cullCount,
+                    100.0 * meshoptCulled / cullCount, wrongCulls, outside, resultValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("builder", strategy == EMeshletStrategy::Greedy ? "greedy" : "spatial");
+        json.Field("boundsMs", boundsMs);
+        json.Field("cullRate", culled / cullCount);
+        json.Field("meshoptCullRate", meshoptCulled / cullCount);
+        json.Field("wrongCulls", static_cast<uint64_t>(wrongCulls));
+        json.Field("verticesOutsideSphere", static_cast<uint64_t>(outside));
+        json.Field("valid", resultValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    return valid;
+}
+
+// Checks that the optimized index buffer holds the same triangles (with the same winding) in any order.
+static bool HasSameTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& optimized)
+{
+    if (indices.size() - indices.size() % 3 != optimized.size())
+    {
+        return false;
+    }
+
+    const auto collect = [](const std::vector<uint32_t>& source) {
+        std::vector<std::array<uint32_t, 3>> triangles(source.size() / 3);
+
+        for (size_t t = 0; t < triangles.size(); t++)
+        {
+            std::array<uint32_t, 3> triangle = {source[t * 3], source[t * 3 + 1], source[t * 3 + 2]};
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles[t] = triangle;
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+
+    return collect(indices) == collect(optimized);
+}
+
+bool MeshletBenchmarks::RunTipsify(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Tipsify: %s (%zu triangles, cache %u)\n", mesh.name.c_str(), triangleCount, cacheSize);
+
+    Clock::time_point start = Clock::now();
+    const std::vector<uint32_t> reference = ReferenceTipsify::Tipsify(mesh.indices, mesh.vertices.size(), cacheSize);
+    const double referenceMs = ElapsedMs(start);
+
+    start = Clock::now();
+    std::vector<uint32_t> optimized = MeshUtils::Tipsify(mesh.indices, mesh.vertices.size(), cacheSize);
+    const double freshMs = ElapsedMs(start);
+
+    // With the scratch of the previous run the only allocation left is the returned index buffer.
+    TipsifyScratch scratch;
+    MeshUtils::Tipsify(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), cacheSize, scratch,
+                       optimized.data());
+
+    double reusedMs = std::numeric_limits<double>::max();
+
+    for (uint32_t run = 0; run < 3; run++)
+    {
+        start = Clock::now();
+        MeshUtils::Tipsify(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), cacheSize, scratch,
+                           optimized.data());
+        reusedMs = std::min(reusedMs, ElapsedMs(start));
+    }
+
+    const VertexCacheStatistics referenceStats =
+        MeshUtils::AnalyzeVertexCache(reference, mesh.vertices.size(), cacheSize);
+    const VertexCacheStatistics optimizedStats =
+        MeshUtils::AnalyzeVertexCache(optimized, mesh.vertices.size(), cacheSize);
+
+    const bool referenceValid = HasSameTriangles(mesh.indices, reference);
+    const bool optimizedValid = HasSameTriangles(mesh.indices, optimized);
+
+    std::printf("%-16s %10s %12s %10s %8s %s\n", "implementation", "time [ms]", "Mtris/s", "speedup", "ACMR", "valid");
+    std::printf("%-16s %10.2f %12.2f %10.2f %8.3f %s\n", "reference", referenceMs, triangleCount / referenceMs / 1000.0,
+                1.0, referenceStats.acmr, referenceValid ? "yes" : "NO");
+    std::printf("%-16s %10.2f %12.2f %10.2f %8.3f %s\n", "fresh scratch", freshMs, triangleCount / freshMs / 1000.0,
+                referenceMs / freshMs, optimizedStats.acmr, optimizedValid ? "yes" : "NO");
+    std::printf("%-16s %10.2f %12.2f %10.2f %8.3f %s\n", "reused scratch", reusedMs,
+                triangleCount / reusedMs / 1000.0, referenceMs / reusedMs, optimizedStats.acmr,
+                optimizedValid ? "yes" : "NO");
+
+    json.Key("tipsify").BeginObject();
+    json.Field("cacheSize", cacheSize);
+    json.Field("referenceMs", referenceMs);
+    json.Field("freshScratchMs", freshMs);
+    json.Field("reusedScratchMs", reusedMs);
+    json.Field("speedup", referenceMs / reusedMs);
+    json.Field("referenceAcmr", referenceStats.acmr);
+    json.Field("acmr", optimizedStats.acmr);
+    json.Field("valid", referenceValid && optimizedValid);
+    json.EndObject();
+
+    return optimizedValid;
+}
+
+bool MeshletBenchmarks::RunVertexCacheOptimizers(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Vertex cache optimizers: %s (%zu triangles, cache %u)\n", mesh.name.c_str(), triangleCount,
+                cacheSize);
+    std::printf("%-10s %10s %12s %10s %10s %10s %10s %s\n", "optimizer", "time [ms]", "Mtris/s", "FIFO ACMR",
+                "FIFO ATVR", "LRU ACMR", "LRU ATVR", "valid");
+
+    json.Key("vertexCacheOptimizers").BeginArray();
+
+    bool valid = true;
+
+    const std::pair<EVertexCacheOptimizer, const char*> optimizers[] = {
+        {EVertexCacheOptimizer::None, "none"},
+        {EVertexCacheOptimizer::Tipsify, "tipsify"},
+        {EVertexCacheOptimizer::Forsyth, "forsyth"},
+    };
+
+    for (const auto& [optimizer, name] : optimizers)
+    {
+        MeshBuildOptions options;
+        options.vertexCacheOptimizer = optimizer;
+        options.vertexCacheSize = cacheSize;
+
+        const Clock::time_point start = Clock::now();
+        const std::vector<uint32_t> optimized = VertexCacheOptimizer::Optimize(options, mesh.indices, mesh.vertices.size());
+        const double ms = ElapsedMs(start);
+
+        const VertexCacheStatistics fifo =
+            MeshUtils::AnalyzeVertexCache(optimized, mesh.vertices.size(), cacheSize, EVertexCacheModel::Fifo);
+        const VertexCacheStatistics lru =
+            MeshUtils::AnalyzeVertexCache(optimized, mesh.vertices.size(), cacheSize, EVertexCacheModel::Lru);
+
+        const bool optimizedValid = HasSameTriangles(mesh.indices, optimized);
+        valid &= optimizedValid;
+
+        std::printf("%-10s %10.2f %12.2f %10.3f %10.3f %10.3f %10.3f %s\n", name, ms, triangleCount / ms / 1000.0,
+                    fifo.acmr, fifo.atvr, lru.acmr, lru.atvr, optimizedValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("optimizer", name);
+        json.Field("ms", ms);
+        json.Field("fifoAcmr", fifo.acmr);
+        json.Field("fifoAtvr", fifo.atvr);
+        json.Field("lruAcmr", lru.acmr);
+        json.Field("lruAtvr", lru.atvr);
+        json.Field("valid", optimizedValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunOverdraw(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Overdraw: %s (%zu triangles, cache %u)\n", mesh.name.c_str(), triangleCount, cacheSize);
+
+    const std::vector<uint32_t> tipsified = MeshUtils::Tipsify(mesh.indices, mesh.vertices.size(), cacheSize);
+
+    const VertexCacheStatistics tipsifyCache = MeshUtils::AnalyzeVertexCache(tipsified, mesh.vertices.size(), cacheSize);
+
+    Clock::time_point start = Clock::now();
+    const OverdrawStatistics tipsifyOverdraw = OverdrawOptimizer::EstimateOverdraw(tipsified, mesh.vertices);
+    const double estimateMs = ElapsedMs(start);
+
+    std::printf("%-16s %10s %8s %10s\n", "ordering", "time [ms]", "ACMR", "overdraw");
+    std::printf("%-16s %10s %8.3f %10.3f (estimated in %.2f ms)\n", "tipsify", "-", tipsifyCache.acmr,
+                tipsifyOverdraw.overdraw, estimateMs);
+
+    json.Key("overdraw").BeginObject();
+    json.Field("estimateMs", estimateMs);
+    json.Field("tipsifyAcmr", tipsifyCache.acmr);
+    json.Field("tipsifyOverdraw", tipsifyOverdraw.overdraw);
+    json.Key("thresholds").BeginArray();
+
+    bool valid = true;
+
+    for (const float threshold : {1.05f, 1.2f, 1.5f})
+    {
+        start = Clock::now();
+        const std::vector<uint32_t> optimized =
+            OverdrawOptimizer::Optimize(tipsified, mesh.vertices, cacheSize, threshold);
+        const double optimizeMs = ElapsedMs(start);
+
+        const VertexCacheStatistics cache = MeshUtils::AnalyzeVertexCache(optimized, mesh.vertices.size(), cacheSize);
+        const OverdrawStatistics overdraw = OverdrawOptimizer::EstimateOverdraw(optimized, mesh.vertices);
+
+        const bool optimizedValid = HasSameTriangles(mesh.indices, optimized);
+        valid &= optimizedValid;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "threshold %.2f", threshold);
+
+        std::printf("%-16s %10.2f %8.3f %10.3f %s\n", name, optimizeMs, cache.acmr, overdraw.overdraw,
+                    optimizedValid ? "" : "INVALID");
+
+        json.BeginObject();
+        json.Field("threshold", threshold);
+        json.Field("ms", optimizeMs);
+        json.Field("acmr", cache.acmr);
+        json.Field("overdraw", overdraw.overdraw);
+        json.Field("valid", optimizedValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunPipelineMetrics(BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Geometry pipeline: %s (%zu triangles, %zu vertices)\n", mesh.name.c_str(), triangleCount,
+                mesh.vertices.size());
+
+    json.Key("pipeline").BeginObject();
+
+    bool valid = true;
+
+    // --- Bounding box
+    Clock::time_point start = Clock::now();
+    const AABB boundingBox = MeshUtils::CreateBoundingBox(mesh.vertices);
+    const double boundingBoxMs = ElapsedMs(start);
+
+    glm::vec3 minPoint(std::numeric_limits<float>::max()), maxPoint(std::numeric_limits<float>::lowest());
+
+    for (const MeshVertex& vertex : mesh.vertices)
+    {
+        minPoint = glm::min(minPoint, vertex.Position);
+        maxPoint = glm::max(maxPoint, vertex.Position);
+    }
+
+    const bool boundingBoxValid = boundingBox.minPoint.x == minPoint.x && boundingBox.minPoint.y == minPoint.y &&
+                                  boundingBox.minPoint.z == minPoint.z && boundingBox.maxPoint.x == maxPoint.x &&
+                                  boundingBox.maxPoint.y == maxPoint.y && boundingBox.maxPoint.z == maxPoint.z;
+    valid &= boundingBoxValid;
+
+    std::printf("%-22s %10.2f ms %10.2f Mverts/s %s\n", "bounding box", boundingBoxMs,
+                mesh.vertices.size() / boundingBoxMs / 1000.0, boundingBoxValid ? "valid" : "INVALID");
+
+    json.Key("boundingBox").BeginObject();
+    json.Field("ms", boundingBoxMs);
+    json.Field("verticesPerSecond", mesh.vertices.size() / boundingBoxMs * 1000.0);
+    json.Field("valid", boundingBoxValid);
+    json.EndObject();
+
+    // --- Vertex cache optimization
+    const VertexCacheStatistics before = MeshUtils::AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), cacheSize);
+
+    start = Clock::now();
+    mesh.indices = MeshUtils::Tipsify(mesh.indices, mesh.vertices.size(), cacheSize);
+    const double tipsifyMs = ElapsedMs(start);
+
+    const VertexCacheStatistics after = MeshUtils::AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), cacheSize);
+
+    std::printf("%-22s %10.2f ms %10.2f Mtris/s\n", "tipsify", tipsifyMs, triangleCount / tipsifyMs / 1000.0);
+    std::printf("%-22s ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (FIFO %u)\n", "vertex cache", before.acmr, after.acmr,
+                before.atvr, after.atvr, cacheSize);
+
+    json.Key("tipsify").BeginObject();
+    json.Field("cacheSize", cacheSize);
+    json.Field("ms", tipsifyMs);
+    json.Field("trianglesPerSecond", triangleCount / tipsifyMs * 1000.0);
+    json.Field("acmrBefore", before.acmr);
+    json.Field("acmrAfter", after.acmr);
+    json.Field("atvrBefore", before.atvr);
+    json.Field("atvrAfter", after.atvr);
+    json.EndObject();
+
+    // --- Vertex fetch remap. The meshlet vertex references are what the mesh shaders actually read.
+    const auto analyzeMeshletFetch = [&]() {
+        std::vector<uint32_t> fetchVertices, fetchTriangles;
+        MeshletGeneration::MeshletizeNv(Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES,
+                                        mesh.indices, mesh.vertices.size(), fetchVertices, fetchTriangles);
+
+        return MeshUtils::AnalyzeVertexFetch(fetchVertices, mesh.vertices.size(), sizeof(MeshVertex));
+    };
+
+    const VertexFetchStatistics indexFetchBefore =
+        MeshUtils::AnalyzeVertexFetch(mesh.indices, mesh.vertices.size(), sizeof(MeshVertex));
+    const VertexFetchStatistics meshletFetchBefore = analyzeMeshletFetch();
+
+    start = Clock::now();
+    MeshUtils::OptimizeVertexFetch(mesh.indices, mesh.vertices);
+    const double vertexFetchMs = ElapsedMs(start);
+
+    const VertexFetchStatistics indexFetchAfter =
+        MeshUtils::AnalyzeVertexFetch(mesh.indices, mesh.vertices.size(), sizeof(MeshVertex));
+    const VertexFetchStatistics meshletFetchAfter = analyzeMeshletFetch();
+
+    std::printf("%-22s %10.2f ms %10.2f Mverts/s\n", "vertex fetch remap", vertexFetchMs,
+                mesh.vertices.size() / vertexFetchMs / 1000.0);
+    std::printf("%-22s overfetch indices %.3f -> %.3f, meshlets %.3f -> %.3f (64 B lines, 16 KiB)\n",
+                "vertex fetch", indexFetchBefore.overfetch, indexFetchAfter.overfetch, meshletFetchBefore.overfetch,
+                meshletFetchAfter.overfetch);
+
+    json.Key("vertexFetch").BeginObject();
+    json.Field("ms", vertexFetchMs);
+    json.Field("indexOverfetchBefore", indexFetchBefore.overfetch);
+    json.Field("indexOverfetchAfter", indexFetchAfter.overfetch);
+    json.Field("meshletOverfetchBefore", meshletFetchBefore.overfetch);
+    json.Field("meshletOverfetchAfter", meshletFetchAfter.overfetch);
+    json.Field("meshletBytesBefore", static_cast<uint64_t>(meshletFetchBefore.bytesFetched));
+    json.Field("meshletBytesAfter", static_cast<uint64_t>(meshletFetchAfter.bytesFetched));
+    json.EndObject();
+
+    // --- Meshletization
+    std::vector<uint32_t> meshletVertices, meshletTriangles;
+
+    start = Clock::now();
+    const std::vector<NewMeshlet> meshlets = MeshletGeneration::MeshletizeNv(
+        Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, mesh.indices, mesh.vertices.size(),
+        meshletVertices, meshletTriangles);
+    const double meshletizeMs = ElapsedMs(start);
+
+    const bool meshletsValid = MeshletValidation::Validate(mesh.indices, meshlets, meshletVertices, meshletTriangles,
+                                                           Constants::MAX_MESHLET_VERTICES,
+                                                           Constants::MAX_MESHLET_TRIANGLES);
+    valid &= meshletsValid;
+
+    double vertexFill = 0.0, triangleFill = 0.0;
+
+    for (const NewMeshlet& meshlet : meshlets)
+    {
+        vertexFill += static_cast<double>(meshlet.vertexCount) / Constants::MAX_MESHLET_VERTICES;
+        triangleFill += static_cast<double>(meshlet.triangleCount) / Constants::MAX_MESHLET_TRIANGLES;
+    }
+
+    const double meshletCount = std::max<double>(meshlets.size(), 1.0);
+
+    std::printf("%-22s %10.2f ms %10.2f Mtris/s %zu meshlets, fill %.1f%% vertices %.1f%% triangles %s\n",
+                "meshletize", meshletizeMs, triangleCount / meshletizeMs / 1000.0, meshlets.size(),
+                vertexFill / meshletCount * 100.0, triangleFill / meshletCount * 100.0,
+                meshletsValid ? "valid" : "INVALID");
+
+    json.Key("meshletize").BeginObject();
+    json.Field("ms", meshletizeMs);
+    json.Field("trianglesPerSecond", triangleCount / meshletizeMs * 1000.0);
+    json.Field("meshletCount", static_cast<uint64_t>(meshlets.size()));
+    json.Field("vertexFill", vertexFill / meshletCount);
+    json.Field("triangleFill", triangleFill / meshletCount);
+    json.Field("valid", meshletsValid);
+    json.EndObject();
+
+    // --- Meshlet bounds
+    start = Clock::now();
+    const std::vector<MeshletBounds> bounds =
+        MeshletGeneration::ComputeMeshletBounds(mesh.vertices, meshletVertices, meshletTriangles, meshlets);
+    const double boundsMs = ElapsedMs(start);
+
+    // The minimal enclosing sphere can't be smaller than half of the largest distance between two of the vertices,
+    // so radius / (diameter / 2) tells how far from the optimum the sphere is at most (1 is the best).
+    double tightnessSum = 0.0;
+    size_t outside = 0;
+
+    for (size_t m = 0; m < meshlets.size(); m++)
+    {
+        const NewMeshlet& meshlet = meshlets[m];
+        const uint32_t* vertices = &meshletVertices[meshlet.vertexOffset];
+
+        float diameter = 0.f;
+
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            const glm::vec3& position = mesh.vertices[vertices[i]].Position;
+
+            if (glm::length(position - bounds[m].spherePos) > bounds[m].sphereRadius * 1.0001f)
+            {
+                outside++;
+            }
+
+            for (uint32_t j = i + 1; j < meshlet.vertexCount; j++)
+            {
+                diameter = std::max(diameter, glm::length(position - mesh.vertices[vertices[j]].Position));
+            }
+        }
+
+        tightnessSum += diameter > 0.f ? bounds[m].sphereRadius / (diameter * 0.5f) : 1.0;
+    }
+
+    valid &= outside == 0;
+
+    std::printf("%-22s %10.2f ms %10.2f Mmeshlets/s, sphere tightness %.3f, %zu vertices outside\n", "meshlet bounds",
+                boundsMs, meshlets.size() / boundsMs / 1000.0, tightnessSum / meshletCount, outside);
+
+    json.Key("meshletBounds").BeginObject();
+    json.Field("ms", boundsMs);
+    json.Field("meshletsPerSecond", meshlets.size() / boundsMs * 1000.0);
+    json.Field("sphereTightness", tightnessSum / meshletCount);
+    json.Field("verticesOutsideSphere", static_cast<uint64_t>(outside));
+    json.EndObject();
+
+    // --- Compact encoding
+    start = Clock::now();
+    const CompactMeshletData compact = MeshletEncoding::Encode(meshlets, meshletVertices, meshletTriangles);
+    const double encodeMs = ElapsedMs(start);
+
+    std::vector<NewMeshlet> decodedMeshlets;
+    std::vector<uint32_t> decodedVertices, decodedTriangles;
+    MeshletEncoding::Decode(compact, decodedMeshlets, decodedVertices, decodedTriangles);
+
+    // MeshletizeNv writes the meshlets contiguously, so the decoded buffers have to be identical.
+    const bool roundTripValid = decodedVertices == meshletVertices && decodedTriangles == meshletTriangles &&
+                                decodedMeshlets.size() == meshlets.size() &&
+                                std::memcmp(decodedMeshlets.data(), meshlets.data(),
+                                            meshlets.size() * sizeof(NewMeshlet)) == 0;
+    valid &= roundTripValid;
+
+    const size_t uint32Bytes =
+        meshlets.size() * sizeof(NewMeshlet) + (meshletVertices.size() + meshletTriangles.size()) * sizeof(uint32_t);
+
+    size_t wideMeshlets = 0;
+
+    for (const CompactMeshlet& meshlet : compact.meshlets)
+    {
+        wideMeshlets += meshlet.HasWideVertices();
+    }
+
+    std::printf("%-22s %10.2f ms %zu -> %zu bytes (%.1f%% smaller), %zu wide meshlets %s\n", "compact encoding",
+                encodeMs, uint32Bytes, compact.GetSizeInBytes(),
+                100.0 * (1.0 - static_cast<double>(compact.GetSizeInBytes()) / std::max<size_t>(uint32Bytes, 1)),
+                wideMeshlets, roundTripValid ? "valid" : "INVALID");
+
+    json.Key("compactEncoding").BeginObject();
+    json.Field("ms", encodeMs);
+    json.Field("uint32Bytes", static_cast<uint64_t>(uint32Bytes));
+    json.Field("compactBytes", static_cast<uint64_t>(compact.GetSizeInBytes()));
+    json.Field("wideMeshlets", static_cast<uint64_t>(wideMeshlets));
+    json.Field("valid", roundTripValid);
+    json.EndObject();
+
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunMeshletGroups(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json)
+{
+    std::printf("\n--- Meshlet groups: %s (%zu triangles, %u views)\n", mesh.name.c_str(), mesh.indices.size() / 3,
+                viewCount);
+
+    std::vector<uint32_t> meshletVertices, meshletTriangles;
+    std::vector<NewMeshlet> meshlets = MeshletGeneration::MeshletizeNv(
+        Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, mesh.indices, mesh.vertices.size(),
+        meshletVertices, meshletTriangles);
+
+    std::vector<MeshletBounds> bounds =
+        MeshletGeneration::ComputeMeshletBounds(mesh.vertices, meshletVertices, meshletTriangles, meshlets);
+
+    std::vector<MeshletGroup> groups;
+
+    const Clock::time_point start = Clock::now();
+    MeshletGrouping::SortIntoGroups(meshlets, bounds, 0, meshlets.size(), groups);
+    const double groupMs = ElapsedMs(start);
+
+    const std::vector<glm::vec3> cameras = CreateRandomCameras(mesh, viewCount);
+
+    // Meshlets culled one by one, groups culled and the meshlets of the culled groups.
+    size_t meshletsCulled = 0, groupsCulled = 0, meshletsInCulledGroups = 0;
+    size_t wrongCulls = 0, outside = 0;
+    double radiusSum = 0.0;
+
+    for (const MeshletGroup& group : groups)
+    {
+        radiusSum += group.bounds.sphereRadius;
+
+        for (uint32_t m = group.meshletOffset; m < group.meshletOffset + group.meshletCount; m++)
+        {
+            if (glm::length(bounds[m].spherePos - group.bounds.spherePos) + bounds[m].sphereRadius >
+                group.bounds.sphereRadius * 1.0001f)
+            {
+                outside++;
+            }
+        }
+
+        for (const glm::vec3& camera : cameras)
+        {
+            const bool groupCulled = MeshletCulling::IsBackfacing(group.bounds, camera);
+
+            groupsCulled += groupCulled;
+
+            for (uint32_t m = group.meshletOffset; m < group.meshletOffset + group.meshletCount; m++)
+            {
+                const bool meshletCulled = MeshletCulling::IsBackfacing(bounds[m], camera);
+
+                meshletsCulled += meshletCulled;
+                meshletsInCulledGroups += groupCulled;
+                wrongCulls += groupCulled && !meshletCulled;
+            }
+        }
+    }
+
+    const double viewMeshlets = std::max<double>(meshlets.size(), 1.0) * viewCount;
+    const double viewGroups = std::max<double>(groups.size(), 1.0) * viewCount;
+    const bool valid = wrongCulls == 0 && outside == 0;
+
+    std::printf("%zu groups of %u meshlets in %.2f ms, avg radius %.5f\n", groups.size(),
+                Constants::MESHLET_GROUP_SIZE, groupMs, radiusSum / std::max<size_t>(groups.size(), 1));
+    std::printf("group cull rate %.1f%%, meshlets rejected by the groups %.1f%% (per meshlet %.1f%%)\n",
+                100.0 * groupsCulled / viewGroups, 100.0 * meshletsInCulledGroups / viewMeshlets,
+                100.0 * meshletsCulled / viewMeshlets);
+    std::printf("wrong culls %zu, spheres outside %zu %s\n", wrongCulls, outside, valid ? "" : "INVALID");
+
+    json.Key("meshletGroups").BeginObject();
+    json.Field("groupCount", static_cast<uint64_t>(groups.size()));
+    json.Field("groupMs", groupMs);
+    json.Field("groupCullRate", groupsCulled / viewGroups);
+    json.Field("meshletsRejectedByGroups", meshletsInCulledGroups / viewMeshlets);
+    json.Field("meshletCullRate", meshletsCulled / viewMeshlets);
+    json.Field("wrongCulls", static_cast<uint64_t>(wrongCulls));
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunClusterLOD(const BenchMesh& mesh, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Cluster LOD: %s (%zu triangles)\n", mesh.name.c_str(), triangleCount);
+
+    Clock::time_point start = Clock::now();
+    const ClusterLODData data = ClusterLOD::Build(mesh.indices, mesh.vertices);
+    const double buildMs = ElapsedMs(start);
+
+    std::printf("build %.2f ms, %zu meshlets in %zu levels:", buildMs, data.meshlets.size(),
+                data.levelMeshletCounts.size());
+
+    for (const uint32_t count : data.levelMeshletCounts)
+    {
+        std::printf(" %u", count);
+    }
+
+    std::printf("\n");
+
+    // --- The cut is only crack-free and unique if the parents are never finer than their children.
+    size_t violations = 0;
+
+    for (const LODCluster& cluster : data.clusters)
+    {
+        if (cluster.parentError == std::numeric_limits<float>::max())
+        {
+            continue;
+        }
+
+        const float distance = glm::length(cluster.parentSpherePos - cluster.lodSpherePos);
+
+        if (cluster.parentError < cluster.lodError ||
+            distance + cluster.lodSphereRadius > cluster.parentSphereRadius * 1.0001f)
+        {
+            violations++;
+        }
+    }
+
+    const bool valid = violations == 0;
+
+    json.Key("clusterLod").BeginObject();
+    json.Field("buildMs", buildMs);
+    json.Field("meshletCount", static_cast<uint64_t>(data.meshlets.size()));
+    json.Key("levelMeshletCounts").BeginArray();
+
+    for (const uint32_t count : data.levelMeshletCounts)
+    {
+        json.Value(count);
+    }
+
+    json.EndArray();
+    json.Field("monotonicityViolations", static_cast<uint64_t>(violations));
+
+    // --- Triangles of the cut for a camera at different distances.
+    glm::vec3 minPoint(std::numeric_limits<float>::max()), maxPoint(std::numeric_limits<float>::lowest());
+
+    for (const MeshVertex& vertex : mesh.vertices)
+    {
+        minPoint = glm::min(minPoint, vertex.Position);
+        maxPoint = glm::max(maxPoint, vertex.Position);
+    }
+
+    const glm::vec3 meshCenter = (minPoint + maxPoint) * 0.5f;
+    const float meshRadius = glm::length(maxPoint - meshCenter);
+
+    // One pixel on a 1080p screen with 60 degree vertical FOV (tan(30 degrees) = 0.57735).
+    const float errorThreshold = 2.f * 0.57735f / 1080.f;
+
+    std::printf("%-16s %12s %12s %10s\n", "camera distance", "meshlets", "triangles", "ratio");
+
+    json.Key("cuts").BeginArray();
+
+    for (const float distance : {1.5f, 3.f, 10.f, 30.f})
+    {
+        const glm::vec3 camera = meshCenter + glm::vec3(0.f, 0.f, 1.f) * meshRadius * distance;
+        const std::vector<uint32_t> selected = ClusterLOD::SelectClusters(data, camera, errorThreshold);
+
+        size_t selectedTriangles = 0;
+
+        for (const uint32_t meshlet : selected)
+        {
+            selectedTriangles += data.meshlets[meshlet].triangleCount;
+        }
+
+        std::printf("%-16.1f %12zu %12zu %9.1f%%\n", distance, selected.size(), selectedTriangles,
+                    100.0 * selectedTriangles / std::max<size_t>(triangleCount, 1));
+
+        json.BeginObject();
+        json.Field("distanceInRadii", distance);
+        json.Field("meshlets", static_cast<uint64_t>(selected.size()));
+        json.Field("triangles", static_cast<uint64_t>(selectedTriangles));
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.Field("valid", valid);
+    json.EndObject();
+
+    std::printf("monotonicity violations: %zu %s\n", violations, valid ? "" : "INVALID");
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunLodGenerator(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json)
+{
+    std::printf("\n--- LOD generator: %s (%zu triangles)\n", mesh.name.c_str(), mesh.indices.size() / 3);
+
+    const LODGenerationOptions options = {.levelCount = Constants::MAX_LOD_LEVELS};
+
+    Clock::time_point start = Clock::now();
+    const std::vector<GeneratedLOD> serialLevels = LODGenerator::Generate(mesh.indices, mesh.vertices, options, 1);
+    const double serialMs = ElapsedMs(start);
+
+    start = Clock::now();
+    const std::vector<GeneratedLOD> levels = LODGenerator::Generate(mesh.indices, mesh.vertices, options, maxThreads);
+    const double parallelMs = ElapsedMs(start);
+
+    bool valid = serialLevels.size() == levels.size();
+
+    for (size_t i = 0; valid && i < levels.size(); i++)
+    {
+        valid &= serialLevels[i].indices == levels[i].indices && serialLevels[i].error == levels[i].error;
+    }
+
+    std::printf("serial %.2f ms, %u threads %.2f ms (%.2fx)\n", serialMs, maxThreads, parallelMs,
+                serialMs / parallelMs);
+    std::printf("%-6s %12s %12s\n", "level", "triangles", "error");
+    std::printf("%-6u %12zu %12g\n", 0u, mesh.indices.size() / 3, 0.0);
+
+    json.Key("lodGenerator").BeginObject();
+    json.Field("serialMs", serialMs);
+    json.Field("parallelMs", parallelMs);
+    json.Key("levels").BeginArray();
+
+    size_t previousIndexCount = mesh.indices.size();
+    float previousError = 0.f;
+
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        const std::vector<uint32_t>& indices = levels[i].indices;
+
+        valid &= indices.size() < previousIndexCount && levels[i].error >= previousError &&
+                 std::all_of(indices.begin(), indices.end(),
+                             [&](const uint32_t index) { return index < mesh.vertices.size(); });
+
+        previousIndexCount = indices.size();
+        previousError = levels[i].error;
+
+        std::printf("%-6zu %12zu %12g\n", i + 1, indices.size() / 3, levels[i].error);
+
+        json.BeginObject();
+        json.Field("triangles", static_cast<uint64_t>(indices.size() / 3));
+        json.Field("error", levels[i].error);
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunIndexCodec(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    std::printf("\n--- Index codec: %s (%zu triangles)\n", mesh.name.c_str(), triangleCount);
+
+    struct Input
+    {
+        const char* name;
+        std::vector<uint32_t> indices;
+    };
+
+    const Input inputs[] = {
+        {"original", mesh.indices},
+        {"tipsify", MeshUtils::Tipsify(mesh.indices, mesh.vertices.size(), cacheSize)},
+    };
+
+    std::printf("%-10s %12s %12s %12s %12s %s\n", "order", "bytes/tri", "encode [ms]", "decode [ms]", "Mtris/s",
+                "valid");
+
+    json.Key("indexCodec").BeginArray();
+
+    bool valid = true;
+
+    for (const Input& input : inputs)
+    {
+        Clock::time_point start = Clock::now();
+        const std::vector<uint8_t> encoded = IndexCodec::Encode(input.indices, mesh.vertices.size());
+        const double encodeMs = ElapsedMs(start);
+
+        std::vector<uint32_t> decoded(input.indices.size());
+        double decodeMs = std::numeric_limits<double>::max();
+        bool inputValid = true;
+
+        for (uint32_t run = 0; run < 3; run++)
+        {
+            start = Clock::now();
+            inputValid &= IndexCodec::Decode(encoded.data(), encoded.size(), decoded.data());
+            decodeMs = std::min(decodeMs, ElapsedMs(start));
+        }
+
+        inputValid &= decoded == input.indices;
+        valid &= inputValid;
+
+        const double bytesPerTriangle = static_cast<double>(encoded.size()) / triangleCount;
+
+        std::printf("%-10s %12.3f %12.2f %12.2f %12.2f %s\n", input.name, bytesPerTriangle, encodeMs, decodeMs,
+                    triangleCount / decodeMs / 1000.0, inputValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("order", input.name);
+        json.Field("bytes", static_cast<uint64_t>(encoded.size()));
+        json.Field("bytesPerTriangle", bytesPerTriangle);
+        json.Field("encodeMs", encodeMs);
+        json.Field("decodeMs", decodeMs);
+        json.Field("valid", inputValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+
+    return valid;
+}
+
+bool MeshletBenchmarks::RunVertexQuantization(const BenchMesh& mesh, JsonWriter& json)
+{
+    const size_t vertexCount = mesh.vertices.size();
+
+    std::printf("\n--- Vertex quantization: %s (%zu vertices)\n", mesh.name.c_str(), vertexCount);
+
+    Clock::time_point start = Clock::now();
+    const VertexQuantizationInfo info = VertexQuantization::ComputeInfo(mesh.vertices);
+    const std::vector<QuantizedVertex> quantized = VertexQuantization::Encode(mesh.vertices, info);
+    const double encodeMs = ElapsedMs(start);
+
+    start = Clock::now();
+    std::vector<MeshVertex> decoded(vertexCount);
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        decoded[i] = VertexQuantization::Decode(quantized[i], info);
+    }
+
+    const double decodeMs = ElapsedMs(start);
+
+    // --- Accuracy. The angles are in degrees, the tangents are only compared where the source has them.
+    const auto angle = [](const glm::vec3& a, const glm::vec3& b) {
+        const float cosine = glm::dot(glm::normalize(a), glm::normalize(b));
+        return std::acos(std::clamp(cosine, -1.f, 1.f)) * 180.0 / 3.14159265358979;
+    };
+
+    double maxPositionError = 0.0, positionErrorSum = 0.0;
+    double maxNormalError = 0.0, normalErrorSum = 0.0;
+    double maxTangentError = 0.0, tangentErrorSum = 0.0;
+    double maxBiTangentError = 0.0;
+    double maxTexCoordError = 0.0;
+    size_t tangentCount = 0;
+    size_t handednessMismatches = 0;
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        const MeshVertex& source = mesh.vertices[i];
+        const MeshVertex& vertex = decoded[i];
+
+        const double positionError = glm::length(vertex.Position - source.Position);
+        maxPositionError = std::max(maxPositionError, positionError);
+        positionErrorSum += positionError;
+
+        const double normalError = angle(vertex.Normal, source.Normal);
+        maxNormalError = std::max(maxNormalError, normalError);
+        normalErrorSum += normalError;
+
+        maxTexCoordError = std::max<double>(maxTexCoordError, glm::length(vertex.TexCoords - source.TexCoords));
+
+        if (glm::dot(source.Tangent, source.Tangent) == 0.f)
+        {
+            continue;
+        }
+
+        // The frame is orthonormalized, so the source tangent is projected onto the plane of the normal first.
+        const glm::vec3 tangent = source.Tangent - source.Normal * glm::dot(source.Normal, source.Tangent);
+        const glm::vec3 biTangent = glm::cross(source.Normal, tangent);
+        const bool leftHanded = glm::dot(biTangent, source.BiTangent) < 0.f;
+
+        const double tangentError = angle(vertex.Tangent, tangent);
+        maxTangentError = std::max(maxTangentError, tangentError);
+        tangentErrorSum += tangentError;
+        maxBiTangentError = std::max(maxBiTangentError, angle(vertex.BiTangent, leftHanded ? -biTangent : biTangent));
+
+        handednessMismatches += (glm::dot(vertex.BiTangent, source.BiTangent) < 0.f) != leftHanded;
+        tangentCount++;
+    }
+
+    const double positionBound = VertexQuantization::GetMaxPositionError(info);
+    const double maxExtent = std::max({info.positionScale.x, info.positionScale.y, info.positionScale.z,
+                                       std::numeric_limits<float>::min()}) * 65535.0;
+    const double averageCount = std::max<double>(vertexCount, 1.0);
+    const double averageTangentCount = std::max<double>(tangentCount, 1.0);
+
+    const bool valid = maxPositionError <= positionBound && maxNormalError < 0.05 && maxTangentError < 2.0 &&
+                       maxBiTangentError < 2.0 && handednessMismatches == 0;
+
+    // --- Bandwidth. The meshlet vertex references are what the mesh shaders read, in the order Mesh::Build makes.
+    std::vector<uint32_t> indices = VertexCacheOptimizer::Optimize(MeshBuildOptions{}, mesh.indices, vertexCount);
+    std::vector<MeshVertex> vertices = mesh.vertices;
+    MeshUtils::OptimizeVertexFetch(indices, vertices);
+
+    std::vector<uint32_t> meshletVertices, meshletTriangles;
+    MeshletGeneration::MeshletizeNv(Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, indices,
+                                    vertexCount, meshletVertices, meshletTriangles);
+
+    const VertexFetchStatistics fullFetch =
+        MeshUtils::AnalyzeVertexFetch(meshletVertices, vertexCount, sizeof(MeshVertex));
+    const VertexFetchStatistics quantizedFetch =
+        MeshUtils::AnalyzeVertexFetch(meshletVertices, vertexCount, sizeof(QuantizedVertex));
+
+    std::printf("%-12s %10.2f ms %10.2f Mverts/s\n", "encode", encodeMs, vertexCount / encodeMs / 1000.0);
+    std::printf("%-12s %10.2f ms %10.2f Mverts/s\n", "decode", decodeMs, vertexCount / decodeMs / 1000.0);
+    std::printf("%-12s max %.3g (%.3g of the extent, bound %.3g), avg %.3g\n", "position", maxPositionError,
+                maxPositionError / maxExtent, positionBound, positionErrorSum / averageCount);
+    std::printf("%-12s max %.4f deg, avg %.4f deg\n", "normal", maxNormalError, normalErrorSum / averageCount);
+    std::printf("%-12s max %.4f deg, avg %.4f deg, bitangent max %.4f deg, %zu handedness mismatches\n", "tangent",
+                maxTangentError, tangentErrorSum / averageTangentCount, maxBiTangentError, handednessMismatches);
+    std::printf("%-12s max %.3g\n", "uv", maxTexCoordError);
+    std::printf("%-12s %zu -> %zu bytes/vertex, %.2f -> %.2f MB, meshlet fetch %.2f -> %.2f MB %s\n", "bandwidth",
+                sizeof(MeshVertex), sizeof(QuantizedVertex), vertexCount * sizeof(MeshVertex) / 1e6,
+                vertexCount * sizeof(QuantizedVertex) / 1e6, fullFetch.bytesFetched / 1e6,
+                quantizedFetch.bytesFetched / 1e6, valid ? "valid" : "INVALID");
+
+    json.Key("vertexQuantization").BeginObject();
+    json.Field("encodeMs", encodeMs);
+    json.Field("decodeMs", decodeMs);
+    json.Field("maxPositionError", maxPositionError);
+    json.Field("avgPositionError", positionErrorSum / averageCount);
+    json.Field("relativePositionError", maxPositionError / maxExtent);
+    json.Field("positionErrorBound", positionBound);
+    json.Field("maxNormalErrorDeg", maxNormalError);
+    json.Field("avgNormalErrorDeg", normalErrorSum / averageCount);
+    json.Field("maxTangentErrorDeg", maxTangentError);
+    json.Field("avgTangentErrorDeg", tangentErrorSum / averageTangentCount);
+    json.Field("maxBiTangentErrorDeg", maxBiTangentError);
+    json.Field("handednessMismatches", static_cast<uint64_t>(handednessMismatches));
+    json.Field("maxTexCoordError", maxTexCoordError);
+    json.Field("fullVertexBytes", static_cast<uint64_t>(vertexCount * sizeof(MeshVertex)));
+    json.Field("quantizedVertexBytes", static_cast<uint64_t>(vertexCount * sizeof(QuantizedVertex)));
+    json.Field("fullMeshletFetchBytes", static_cast<uint64_t>(fullFetch.bytesFetched));
+    json.Field("quantizedMeshletFetchBytes", static_cast<uint64_t>(quantizedFetch.bytesFetched));
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
+
+/**
+ * @brief Cooks the mesh with the same steps as Mesh::Build, which can't be called without the Vulkan headers.
+ */
+static MeshData CookMesh(const MeshBuildOptions& options, const std::vector<uint32_t>& meshIndices,
+                         std::vector<MeshVertex> vertices)
+{
+    std::vector<uint32_t> indices = VertexCacheOptimizer::Optimize(options, meshIndices, vertices.size());
+    MeshUtils::OptimizeVertexFetch(indices, vertices);
+
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletTriangles;
+    std::vector<NewMeshlet> meshlets =
+        MeshletGeneration::Meshletize(options, Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES,
+                                      indices, vertices, meshletVertices, meshletTriangles);
+
+    const VertexQuantizationInfo quantization = VertexQuantization::QuantizePositions(options.vertexFormat, vertices);
+
+    std::vector<MeshletBounds> meshletBounds =
+        MeshletGeneration::ComputeMeshletBounds(vertices, meshletVertices, meshletTriangles, meshlets);
+
+    std::vector<MeshletGroup> meshletGroups;
+    MeshletGrouping::SortIntoGroups(meshlets, meshletBounds, 0, meshlets.size(), meshletGroups);
+
+    MeshData cooked;
+    cooked.header.meshletCount = meshlets.size();
+    cooked.header.meshletGroupCount = meshletGroups.size();
+
+    cooked.Set(EMeshSection::Indices, indices);
+    VertexQuantization::SetVertices(cooked, options.vertexFormat, std::move(vertices), quantization);
+    cooked.Set(EMeshSection::Meshlets, meshlets);
+    cooked.Set(EMeshSection::MeshletVertices, meshletVertices);
+    cooked.Set(EMeshSection::MeshletTriangles, meshletTriangles);
+    cooked.Set(EMeshSection::MeshletBounds, meshletBounds);
+    cooked.Set(EMeshSection::MeshletGroups, meshletGroups);
+
+    return cooked;
+}
+
+bool MeshletBenchmarks::RunMeshCache(const BenchMesh& mesh, JsonWriter& json)
+{
+    namespace fs = std::filesystem;
+
+    std::printf("\n--- Mesh cache: %s (%zu triangles)\n", mesh.name.c_str(), mesh.indices.size() / 3);
+
+    // --- The raw mesh stands in for the source file, so the hash of the sources is a part of the hit.
+    const fs::path directory = fs::temp_directory_path() / "MeshletBenchCache";
+    const std::string sourcePath = (directory / (mesh.name + ".bin")).string();
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    {
+        std::ofstream source(sourcePath, std::ios::binary | std::ios::trunc);
+        source.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t));
+        source.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(MeshVertex));
+    }
+
+    MeshBuildOptions options;
+    options.cache.directory = directory.string();
+
+    // --- Cook, the same steps as Mesh::Build.
+    Clock::time_point start = Clock::now();
+
+    std::vector<MeshData> meshes(1);
+    meshes[0] = CookMesh(options, mesh.indices, mesh.vertices);
+    const MeshData& cooked = meshes[0];
+
+    const double cookMs = ElapsedMs(start);
+
+    // --- Miss: hash the source and write the file.
+    start = Clock::now();
+    const MeshCache writer(EMeshCacheKind::Model, {sourcePath}, options);
+    const bool stored = writer.Store(meshes);
+    const double storeMs = ElapsedMs(start);
+
+    // --- Hit: hash the source, map and validate the file and read every section like the mesh constructors do.
+    double hashMs = 0.0;
+    double readMs = 0.0;
+    size_t fileSize = 0;
+    size_t encodedIndexSize = 0;
+    bool valid = stored;
+
+    {
+        start = Clock::now();
+        MeshCache reader(EMeshCacheKind::Model, {sourcePath}, options);
+        hashMs = ElapsedMs(start);
+
+        valid &= reader.Load() && reader.GetMeshCount() == 1;
+
+        if (valid)
+        {
+            const MeshDataView& view = reader.GetMesh(0);
+
+            std::vector<uint32_t> decodedIndices;
+            valid &= view.header.indicesEncoded &&
+                     IndexCodec::Decode(view.Get<uint8_t>(EMeshSection::Indices),
+                                        view.GetSize(EMeshSection::Indices), decodedIndices);
+
+            // The rest is only uploaded, the copy stands in for the copy to the staging buffers.
+            std::vector<uint8_t> staging[MESH_SECTION_COUNT];
+
+            for (size_t section = static_cast<size_t>(EMeshSection::Vertices); section < MESH_SECTION_COUNT;
+                 section++)
+            {
+                staging[section].assign(view.sections[section], view.sections[section] + view.sectionSizes[section]);
+            }
+
+            readMs = ElapsedMs(start);
+            fileSize = fs::file_size(reader.GetPath(), error);
+            encodedIndexSize = view.GetSize(EMeshSection::Indices);
+
+            const std::vector<uint32_t> indices = cooked.GetView().Copy<uint32_t>(EMeshSection::Indices);
+            valid &= decodedIndices == indices;
+
+            for (size_t section = static_cast<size_t>(EMeshSection::Vertices); section < MESH_SECTION_COUNT;
+                 section++)
+            {
+                valid &= staging[section] == cooked.sections[section];
+            }
+        }
+    }
+
+    size_t cookedSize = 0;
+
+    for (const std::vector<uint8_t>& section : cooked.sections)
+    {
+        cookedSize += section.size();
+    }
+
+    std::printf("%-8s %10.2f ms\n", "cook", cookMs);
+    std::printf("%-8s %10.2f ms\n", "store", storeMs);
+    std::printf("%-8s %10.2f ms (hash %.2f ms), %.2f GB/s of the file, %.1fx faster than the cook\n", "hit", readMs,
+                hashMs, fileSize / (readMs * 1e6), cookMs / readMs);
+    std::printf("file %.2f MB, %.2f MB cooked, indices %.2f bytes/triangle %s\n", fileSize / 1e6, cookedSize / 1e6,
+                encodedIndexSize / (mesh.indices.size() / 3.0), valid ? "valid" : "INVALID");
+
+    json.Key("meshCache").BeginObject();
+    json.Field("cookMs", cookMs);
+    json.Field("storeMs", storeMs);
+    json.Field("hashMs", hashMs);
+    json.Field("hitMs", readMs);
+    json.Field("fileBytes", static_cast<uint64_t>(fileSize));
+    json.Field("cookedBytes", static_cast<uint64_t>(cookedSize));
+    json.Field("valid", valid);
+    json.EndObject();
+
+    fs::remove_all(directory, error);
+
+    return valid;
+}
+
+/**
+ * @brief Splits the mesh into sub-meshes of consecutive triangles, each with only the vertices it references, like the
+ * meshes of an imported scene.
+ */
+static std::vector<BenchMesh> SplitMesh(const BenchMesh& mesh, const size_t subMeshCount)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+    std::vector<BenchMesh> subMeshes(subMeshCount);
+    std::vector<uint32_t> remap(mesh.vertices.size());
+    // Sub-mesh the remap of the vertex belongs to.
+    std::vector<size_t> remapOwner(mesh.vertices.size(), SIZE_MAX);
+
+    for (size_t s = 0; s < subMeshCount; s++)
+    {
+        BenchMesh& subMesh = subMeshes[s];
+        subMesh.name = mesh.name + "_" + std::to_string(s);
+
+        const size_t first = triangleCount * s / subMeshCount;
+        const size_t last = triangleCount * (s + 1) / subMeshCount;
+
+        for (size_t i = first * 3; i < last * 3; i++)
+        {
+            const uint32_t vertex = mesh.indices[i];
+
+            if (remapOwner[vertex] != s)
+            {
+                remapOwner[vertex] = s;
+                remap[vertex] = static_cast<uint32_t>(subMesh.vertices.size());
+                subMesh.vertices.emplace_back(mesh.vertices[vertex]);
+            }
+
+            subMesh.indices.emplace_back(remap[vertex]);
+        }
+    }
+
+    return subMeshes;
+}
+
+bool MeshletBenchmarks::RunModelLoadScaling(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json)
+{
+    constexpr size_t SUB_MESH_COUNT = 64;
+
+    const size_t triangleCount = mesh.indices.size() / 3;
+    const std::vector<BenchMesh> subMeshes = SplitMesh(mesh, std::min<size_t>(SUB_MESH_COUNT, triangleCount));
+
+    std::printf("\n--- Model load scaling: %s (%zu triangles in %zu meshes)\n", mesh.name.c_str(), triangleCount,
+                subMeshes.size());
+
+    const MeshBuildOptions options;
+    const MeshImportOptions& importOptions = options.meshImport;
+
+    // --- The CPU side of Model::ProcessMesh: weld, then cook. Every mesh goes into its own slot.
+    auto loadMeshes = [&](const uint32_t threads, std::vector<MeshData>& outMeshes) {
+        outMeshes.assign(subMeshes.size(), MeshData());
+
+        ThreadUtils::ParallelFor(subMeshes.size(), threads, [&](const size_t index, const uint32_t) {
+            std::vector<uint32_t> indices = subMeshes[index].indices;
+            std::vector<MeshVertex> vertices = subMeshes[index].vertices;
+
+            VertexWelder::Weld(indices, vertices, importOptions.weldPositionEpsilon,
+                               importOptions.weldAttributeEpsilon);
+
+            outMeshes[index] = CookMesh(options, indices, std::move(vertices));
+        });
+    };
+
+    // Powers of two up to the maximum, the maximum itself is always included.
+    std::vector<uint32_t> threadCounts;
+
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.emplace_back(threads);
+    }
+
+    threadCounts.emplace_back(maxThreads);
+
+    std::printf("%-12s %10s %12s %10s %14s %s\n", "mode", "time [ms]", "Mtris/s", "speedup", "peak RSS [MB]",
+                "valid");
+
+    json.Key("modelLoadScaling").BeginObject();
+    json.Field("meshCount", static_cast<uint64_t>(subMeshes.size()));
+    json.Key("parallel").BeginArray();
+
+    std::vector<MeshData> reference;
+    std::vector<MeshData> meshes;
+    double serialMs = 0.0;
+    bool valid = true;
+
+    for (const uint32_t threads : threadCounts)
+    {
+        // The meshes of the previous run are kept as the reference, so the peak is measured on top of them.
+        MemoryStats::ResetPeak();
+        const size_t residentBytes = MemoryStats::GetResidentBytes();
+
+        const Clock::time_point start = Clock::now();
+        loadMeshes(threads, meshes);
+        const double ms = ElapsedMs(start);
+
+        const size_t peakResidentBytes = MemoryStats::GetPeakResidentBytes();
+        const size_t peakBytes = peakResidentBytes > residentBytes ? peakResidentBytes - residentBytes : 0;
+
+        // The meshes have to be the same, in the same order, no matter how many threads were used.
+        bool parallelValid = true;
+
+        if (reference.empty())
+        {
+            serialMs = ms;
+            reference = std::move(meshes);
+        }
+        else
+        {
+            for (size_t m = 0; m < meshes.size(); m++)
+            {
+                for (size_t section = 0; section < MESH_SECTION_COUNT; section++)
+                {
+                    parallelValid &= meshes[m].sections[section] == reference[m].sections[section];
+                }
+
+                parallelValid &= std::memcmp(&meshes[m].header, &reference[m].header, sizeof(MeshDataHeader)) == 0;
+            }
+        }
+
+        valid &= parallelValid;
+
+        std::printf("%-3u %-8s %10.2f %12.2f %10.2f %14.1f %s\n", threads, "threads", ms, triangleCount / ms / 1000.0,
+                    serialMs / ms, peakBytes / (1024.0 * 1024.0), parallelValid ? "yes" : "NO");
+
+        json.BeginObject();
+        json.Field("threads", threads);
+        json.Field("ms", ms);
+        json.Field("trianglesPerSecond", triangleCount / ms * 1000.0);
+        json.Field("speedup", serialMs / ms);
+        json.Field("peakResidentBytes", static_cast<uint64_t>(peakBytes));
+        json.Field("valid", parallelValid);
+        json.EndObject();
+    }
+
+    json.EndArray();
+    json.Field("valid", valid);
+    json.EndObject();
+
+    return valid;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+
+#include "JsonWriter.h"
+#include "SyntheticMesh.h"
+
+class MeshletBenchmarks
+{
+
+  public:
+    /**
+     * @brief Runs the geometry pipeline of Mesh step by step (bounding box, Tipsify, vertex fetch remap,
+     * MeshletizeNv, meshlet bounds) and reports the throughput and the quality of every step: ACMR/ATVR before and
+     * after Tipsify, vertex overfetch before and after the remap, meshlet fill rates, bounding sphere tightness and
+     * the size of the compact meshlet encoding. The mesh indices and vertices are replaced by the optimized ones.
+     * @return true if all of the results were valid.
+     */
+    static bool RunPipelineMetrics(BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json);
+
+    /**
+     * @brief Compares MeshUtils::Tipsify (with a fresh and with a reused scratch) against the original
+     * implementation (ReferenceTipsify). Reports the timings and the ACMR of both.
+     * @return true if both emitted exactly the triangles of the mesh.
+     */
+    static bool RunTipsify(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json);
+
+    /**
+     * @brief Runs every vertex cache optimizer (EVertexCacheOptimizer) and reports its time and the ACMR/ATVR
+     * for both a FIFO and an LRU cache of cacheSize entries.
+     * @return true if every optimizer emitted exactly the triangles of the mesh.
+     */
+    static bool RunVertexCacheOptimizers(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json);
+
+    /**
+     * @brief Runs the overdraw optimization after Tipsify with several thresholds and reports the ACMR and the
+     * overdraw estimated by OverdrawOptimizer::EstimateOverdraw, next to the ones of Tipsify alone.
+     * @return true if every reordering emitted exactly the triangles of the mesh.
+     */
+    static bool RunOverdraw(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json);
+
+    /**
+     * @brief Meshletizes the mesh serially and then in parallel with 1 to maxThreads threads and prints the timings.
+     * @return true if all of the produced meshlets were valid.
+     */
+    static bool RunMeshletizeScaling(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json);
+
+    /**
+     * @brief Builds the vertex-triangle adjacency serially and in parallel with 1 to maxThreads threads, checks that
+     * all of the results are the same and times the half-edge adjacency built from it.
+     * @return true if the adjacencies matched and every paired half-edge points back to the same edge.
+     */
+    static bool RunAdjacency(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json);
+
+    /**
+     * @brief Splits the mesh into one vertex per index (as an OBJ import without welding) and welds it back with
+     * VertexWelder on 1 and maxThreads threads, then times MeshUtils::GenerateNormals on the welded mesh.
+     * @return true if the welded meshes have the original vertex count and the same triangles, and the generated
+     * normals are unit length.
+     */
+    static bool RunVertexWelding(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json);
+
+    /**
+     * @brief Compares the runtime-parameterised meshletizer (MeshletBuilder) with the compile-time specialised
+     * MeshletGeneration::Meshletize<MaxVerts, MaxTris> for every instantiated pair of limits.
+     * @return true if both produced valid and identical meshlets for every pair.
+     */
+    static bool RunFixedMeshletizer(const BenchMesh& mesh, JsonWriter& json);
+
+    /**
+     * @brief Compares the greedy and the spatial meshlet builders with meshopt_buildMeshlets. Reports the meshlet
+     * fill rates, the average bounding sphere radius and how many meshlets get rejected by cone culling for random
+     * views. All of the builders use the same bounds (meshopt_computeMeshletBounds), so only the meshlet shapes differ.
+     * @return true if all of the produced meshlets were valid.
+     */
+    static bool RunBuilderComparison(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json);
+
+    /**
+     * @brief Computes the meshlet bounds with MeshletGeneration::ComputeMeshletBounds and reports the fraction of
+     * meshlets rejected by the cone test for random views, next to the rate meshopt_computeMeshletBounds achieves.
+     * Every rejection is checked against the actual triangles, so a non-conservative cone is reported as a failure.
+     * @return true if no front-facing meshlet was culled and all of the vertices are inside the bounding spheres.
+     */
+    static bool RunConeCulling(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json);
+
+    /**
+     * @brief Sorts the meshlets into task shader groups (MeshletGrouping) and reports how many meshlets the group
+     * cone test rejects for random views, compared to testing every meshlet on its own.
+     * @return true if no group was culled while one of its meshlets wasn't and the group spheres contain the
+     * meshlet spheres.
+     */
+    static bool RunMeshletGroups(const BenchMesh& mesh, const uint32_t viewCount, JsonWriter& json);
+
+    /**
+     * @brief Builds the cluster LOD hierarchy and reports the meshlets per level, the build time and the size of the
+     * cut for a camera at several distances. Checks that the errors and spheres grow towards the roots.
+     * @return true if the hierarchy is monotonic.
+     */
+    static bool RunClusterLOD(const BenchMesh& mesh, JsonWriter& json);
+
+    /**
+     * @brief Generates a LOD chain with LODGenerator serially and with maxThreads threads and reports the triangles
+     * and the error of every level.
+     * @return true if both of the chains are the same, the triangle counts fall and the errors grow.
+     */
+    static bool RunLodGenerator(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json);
+
+    /**
+     * @brief Encodes the index buffer with IndexCodec as it is and after Tipsify, and reports the bytes per triangle
+     * and the encode and decode throughput.
+     * @return true if every decoded buffer is the same as the encoded one.
+     */
+    static bool RunIndexCodec(const BenchMesh& mesh, const uint32_t cacheSize, JsonWriter& json);
+
+    /**
+     * @brief Quantizes the vertices to QuantizedVertex and decodes them back. Reports the position, normal, tangent
+     * frame and UV errors and the bytes the meshlets fetch in both formats.
+     * @return true if the errors are within their bounds and the handedness of every frame is kept.
+     */
+    static bool RunVertexQuantization(const BenchMesh& mesh, JsonWriter& json);
+
+    /**
+     * @brief Cooks the mesh the way Mesh::Build does, stores it in a MeshCache in the temporary directory and loads
+     * it back. Compares the time of the cook with the time of the hit and with the read speed of the file.
+     * @return true if the loaded mesh is the same as the cooked one.
+     */
+    static bool RunMeshCache(const BenchMesh& mesh, JsonWriter& json);
+
+    /**
+     * @brief Splits the mesh into sub-meshes like the meshes of an imported scene and runs the CPU side of the model
+     * load (welding and cooking) on them in parallel, the way Model does, with 1 up to maxThreads threads.
+     * @return true if the meshes are the same for every thread count.
+     */
+    static bool RunModelLoadScaling(const BenchMesh& mesh, const uint32_t maxThreads, JsonWriter& json);
+};
@@ -0,0 +1,74 @@
+#include "MeshletValidation.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+using Triangle = std::array<uint32_t, 3>;
+
+// Rotates the triangle so it starts with the smallest index. The winding is kept.
+static Triangle CanonicalTriangle(const uint32_t a, const uint32_t b, const uint32_t c)
+{
+    if (a <= b && a <= c)
+        return {a, b, c};
+
+    if (b <= a && b <= c)
+        return {b, c, a};
+
+    return {c, a, b};
+}
+
+bool MeshletValidation::Validate(const std::vector<uint32_t>& indices, const std::vector<NewMeshlet>& meshlets,
+                                 const std::vector<uint32_t>& meshletVertices,
+                                 const std::vector<uint32_t>& meshletTriangles, const uint32_t maxVerts,
+                                 const uint32_t maxTriangles)
+{
+    std::vector<Triangle> expected, actual;
+    expected.reserve(indices.size() / 3);
+    actual.reserve(indices.size() / 3);
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        expected.emplace_back(CanonicalTriangle(indices[i], indices[i + 1], indices[i + 2]));
+    }
+
+    for (size_t m = 0; m < meshlets.size(); m++)
+    {
+        const NewMeshlet& meshlet = meshlets[m];
+
+        if (meshlet.vertexCount > maxVerts || meshlet.triangleCount > maxTriangles || meshlet.triangleCount == 0 ||
+            meshlet.vertexOffset + meshlet.vertexCount > meshletVertices.size() ||
+            meshlet.triangleOffset + meshlet.triangleCount > meshletTriangles.size())
+        {
+            std::printf("Meshlet %zu is out of limits or out of bounds!\n", m);
+            return false;
+        }
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const uint32_t packed = meshletTriangles[meshlet.triangleOffset + t];
+            const uint32_t local[3] = {packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF};
+
+            if (local[0] >= meshlet.vertexCount || local[1] >= meshlet.vertexCount || local[2] >= meshlet.vertexCount)
+            {
+                std::printf("Meshlet %zu references a vertex outside of the meshlet!\n", m);
+                return false;
+            }
+
+            actual.emplace_back(CanonicalTriangle(meshletVertices[meshlet.vertexOffset + local[0]],
+                                                  meshletVertices[meshlet.vertexOffset + local[1]],
+                                                  meshletVertices[meshlet.vertexOffset + local[2]]));
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+
+    if (expected != actual)
+    {
+        std::printf("Meshlet triangles don't match the index buffer!\n");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh/Meshlet.h"
+
+class MeshletValidation
+{
+
+  public:
+    /**
+     * @brief Checks that the meshlets respect the limits, that their local indices point inside of the meshlet and
+     * that the meshlets contain exactly the triangles of the index buffer (with the same winding). The order of the
+     * triangles doesn't matter.
+     * @return true if the meshlets are valid.
+     */
+    static bool Validate(const std::vector<uint32_t>& indices, const std::vector<NewMeshlet>& meshlets,
+                         const std::vector<uint32_t>& meshletVertices, const std::vector<uint32_t>& meshletTriangles,
+                         const uint32_t maxVerts, const uint32_t maxTriangles);
+};
@@ -0,0 +1,122 @@
+#include "ReferenceTipsify.h"
+
+#include <queue>
+#include <unordered_map>
+
+#include "Mesh/MeshUtils.h"
+
+static int SkipDeadEnd(const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack, uint32_t i)
+{
+    while (!stack.empty())
+    {
+        const uint32_t d = stack.back();
+        stack.pop();
+
+        if (liveTriangles[d] > 0)
+        {
+            return d;
+        }
+    }
+
+    while (i < liveTriangles.size())
+    {
+        if (liveTriangles[i] > 0)
+        {
+            return i;
+        }
+
+        i++;
+    }
+
+    return -1;
+}
+
+static int GetNextVertex(uint32_t i, const uint32_t cacheSize, const std::unordered_map<uint32_t, bool>& candidates,
+                         const std::vector<uint32_t>& timeStamps, uint32_t& timeStamp,
+                         const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack)
+{
+    int bestCandidate = -1;
+    int priority = -1;
+    int prevPriority = 0;
+
+    for (const auto& pair : candidates)
+    {
+        const uint32_t candidate = pair.first;
+        if (liveTriangles[candidate] > 0)
+        {
+            priority = 0;
+
+            if (timeStamp - timeStamps[candidate] + 2 * liveTriangles[candidate] <= cacheSize)
+            {
+                priority = timeStamp - timeStamps[candidate];
+            }
+
+            if (priority > prevPriority)
+            {
+                prevPriority = priority;
+                bestCandidate = candidate;
+            }
+        }
+    }
+
+    if (bestCandidate == -1)
+    {
+        bestCandidate = SkipDeadEnd(liveTriangles, stack, i);
+    }
+
+    return bestCandidate;
+}
+
+std::vector<uint32_t> ReferenceTipsify::Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                                const uint32_t cacheSize)
+{
+    VertexTriangleAdjacency adj = MeshUtils::BuildVertexTriangleAdjacency(indices, vertexCount);
+
+    std::vector<uint32_t> liveTriangles(adj.vertexCount);
+    std::vector<uint32_t> cachingTimeStamps(vertexCount);
+    std::queue<uint32_t> deadEndStack;
+
+    std::vector<bool> emmitedTriangles(indices.size() / 3);
+
+    int f = 0;
+
+    uint32_t timeStamp = cacheSize + 1;
+    uint32_t cursor = 1;
+
+    std::vector<uint32_t> outputIndices;
+
+    while (f >= 0)
+    {
+        std::unordered_map<uint32_t, bool> ringCandidates;
+
+        std::vector<VertexTriangleAdjacency::Triangle> triangles = adj.GetTriangles(f);
+        std::vector<uint32_t> triangleIndices = adj.GetTriangleIndices(f);
+
+        for (size_t i = 0; i < triangles.size(); i++)
+        {
+            if (!emmitedTriangles[triangleIndices[i]])
+            {
+                for (size_t t = 0; t < 3; t++)
+                {
+                    const uint32_t v = triangles[i].vertices[t];
+                    outputIndices.emplace_back(v);
+                    deadEndStack.push(v);
+                    ringCandidates.emplace(v, true);
+
+                    liveTriangles[v]--;
+
+                    if (timeStamp - cachingTimeStamps[v] > cacheSize)
+                    {
+                        cachingTimeStamps[v] = timeStamp++;
+                    }
+                }
+                emmitedTriangles[triangleIndices[i]] = true;
+            }
+        }
+
+        f = GetNextVertex(cursor, cacheSize, ringCandidates, cachingTimeStamps, timeStamp, liveTriangles,
+                          deadEndStack);
+    }
+
+    return outputIndices;
+}
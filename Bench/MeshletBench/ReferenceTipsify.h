@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * The original MeshUtils::Tipsify (before it was made allocation-free), kept as the baseline of the benchmark.
+ * It allocates the candidates and the adjacent triangles for every fanning vertex.
+ */
+class ReferenceTipsify
+{
+  public:
+    static std::vector<uint32_t> Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                         const uint32_t cacheSize);
+};
@@ -0,0 +1,67 @@
+#include "SyntheticMesh.h"
+
+#include <cmath>
+
+#include "glm/glm.hpp"
+
+BenchMesh SyntheticMesh::CreateGrid(const uint32_t quadsX, const uint32_t quadsY)
+{
+    BenchMesh mesh;
+    mesh.name = "grid_" + std::to_string(quadsX) + "x" + std::to_string(quadsY);
+
+    const uint32_t columns = quadsX + 1;
+    const uint32_t rows = quadsY + 1;
+
+    mesh.vertices.reserve(columns * rows);
+    mesh.indices.reserve(quadsX * quadsY * 6);
+
+    const float frequency = 8.f;
+
+    for (uint32_t y = 0; y < rows; y++)
+    {
+        for (uint32_t x = 0; x < columns; x++)
+        {
+            const float u = static_cast<float>(x) / quadsX;
+            const float v = static_cast<float>(y) / quadsY;
+
+            const float su = std::sin(u * frequency), cu = std::cos(u * frequency);
+            const float sv = std::sin(v * frequency), cv = std::cos(v * frequency);
+
+            const float height = 0.1f * su * cv;
+
+            // Partial derivatives of the height field.
+            const float du = 0.1f * frequency * cu * cv;
+            const float dv = -0.1f * frequency * su * sv;
+
+            MeshVertex vertex{};
+            vertex.Position = glm::vec3(u, v, height);
+            vertex.Normal = glm::normalize(glm::vec3(-du, -dv, 1.f));
+            vertex.Tangent = glm::normalize(glm::vec3(1.f, 0.f, du));
+            vertex.BiTangent = glm::normalize(glm::vec3(0.f, 1.f, dv));
+            vertex.TexCoords = glm::vec2(u, v);
+
+            mesh.vertices.emplace_back(vertex);
+        }
+    }
+
+    for (uint32_t y = 0; y < quadsY; y++)
+    {
+        for (uint32_t x = 0; x < quadsX; x++)
+        {
+            const uint32_t i0 = y * columns + x;
+            const uint32_t i1 = i0 + 1;
+            const uint32_t i2 = i0 + columns;
+            const uint32_t i3 = i2 + 1;
+
+            mesh.indices.insert(mesh.indices.end(), {i0, i1, i3, i0, i3, i2});
+        }
+    }
+
+    return mesh;
+}
+
+BenchMesh SyntheticMesh::CreateGridWithTriangles(const size_t triangleCount)
+{
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(triangleCount / 2.0)));
+    return CreateGrid(side, side);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mesh/MeshVertex.h"
+
+struct BenchMesh
+{
+    std::string name;
+    std::vector<uint32_t> indices;
+    std::vector<MeshVertex> vertices;
+};
+
+class SyntheticMesh
+{
+
+  public:
+    /**
+     * @brief Creates a wavy grid of quadsX * quadsY quads (2 triangles each). The surface is bent, so the normals
+     * differ across the grid and the meshlet cones are not trivial.
+     */
+    static BenchMesh CreateGrid(const uint32_t quadsX, const uint32_t quadsY);
+
+    /**
+     * @brief Creates a grid with roughly the requested amount of triangles.
+     */
+    static BenchMesh CreateGridWithTriangles(const size_t triangleCount);
+};
@@ -0,0 +1,38 @@
+// Selection of the cluster LOD cut (MeshBuildOptions::buildClusterLod, see Src/Mesh/ClusterLOD.h).
+//
+// Mirrors ClusterLOD::IsClusterSelected. The clusters are bound to the binding 5 of the mesh descriptor set:
+//
+//   layout(set = 0, binding = 5) readonly buffer Clusters { LODCluster clusters[]; };
+
+#ifndef CLUSTER_LOD_GLSL
+#define CLUSTER_LOD_GLSL
+
+struct LODCluster
+{
+    vec3 lodSpherePos;
+    float lodSphereRadius;
+    float lodError;
+    vec3 parentSpherePos;
+    float parentSphereRadius;
+    float parentError;
+    uint level;
+};
+
+// Error per unit of distance from the camera, conservative for the whole sphere.
+float ProjectClusterError(vec3 spherePos, float sphereRadius, float error, vec3 cameraPosition)
+{
+    float distance = max(length(spherePos - cameraPosition) - sphereRadius, 1.175494e-38);
+    return error / distance;
+}
+
+// The cluster is drawn when its own error is small enough, but the error of its parents is not.
+bool IsClusterSelected(LODCluster cluster, vec3 cameraPosition, float errorThreshold)
+{
+    float error = ProjectClusterError(cluster.lodSpherePos, cluster.lodSphereRadius, cluster.lodError, cameraPosition);
+    float parentError = ProjectClusterError(cluster.parentSpherePos, cluster.parentSphereRadius, cluster.parentError,
+                                            cameraPosition);
+
+    return error <= errorThreshold && parentError > errorThreshold;
+}
+
+#endif
@@ -0,0 +1,59 @@
+// Decoding of the compact meshlet encoding (EMeshletEncoding::Compact, see Src/Mesh/MeshletEncoding.h).
+//
+// The including shader has to declare the meshlet buffers beforehand, e.g.:
+//
+//   layout(set = 0, binding = 1) readonly buffer Meshlets { CompactMeshlet meshlets[]; };
+//   layout(set = 0, binding = 2) readonly buffer MeshletVertices { uint meshletVertexWords[]; };
+//   layout(set = 0, binding = 3) readonly buffer MeshletTriangles { uint meshletTriangleWords[]; };
+//
+// with the CompactMeshlet struct declared first:
+//
+//   struct CompactMeshlet { uint vertexBase; uint vertexOffset; uint triangleOffset; uint packedCounts; };
+
+#ifndef MESHLET_ENCODING_GLSL
+#define MESHLET_ENCODING_GLSL
+
+#define COMPACT_MESHLET_WIDE_VERTICES_FLAG (1u << 16)
+
+uint GetMeshletVertexCount(CompactMeshlet meshlet)
+{
+    return meshlet.packedCounts & 0xFFu;
+}
+
+uint GetMeshletTriangleCount(CompactMeshlet meshlet)
+{
+    return (meshlet.packedCounts >> 8) & 0xFFu;
+}
+
+uint ReadMeshletVertexSlot(uint slot)
+{
+    return (meshletVertexWords[slot >> 1] >> ((slot & 1u) * 16u)) & 0xFFFFu;
+}
+
+// Returns the index into the vertex buffer of the given meshlet vertex.
+uint DecodeMeshletVertex(CompactMeshlet meshlet, uint localIndex)
+{
+    if ((meshlet.packedCounts & COMPACT_MESHLET_WIDE_VERTICES_FLAG) != 0u)
+    {
+        uint slot = meshlet.vertexOffset + localIndex * 2u;
+        return ReadMeshletVertexSlot(slot) | (ReadMeshletVertexSlot(slot + 1u) << 16);
+    }
+
+    return meshlet.vertexBase + ReadMeshletVertexSlot(meshlet.vertexOffset + localIndex);
+}
+
+uint ReadMeshletTriangleByte(uint byteOffset)
+{
+    return (meshletTriangleWords[byteOffset >> 2] >> ((byteOffset & 3u) * 8u)) & 0xFFu;
+}
+
+// Returns the local (meshlet) vertex indices of the given triangle.
+uvec3 DecodeMeshletTriangle(CompactMeshlet meshlet, uint triangleIndex)
+{
+    uint byteOffset = meshlet.triangleOffset + triangleIndex * 3u;
+
+    return uvec3(ReadMeshletTriangleByte(byteOffset), ReadMeshletTriangleByte(byteOffset + 1u),
+                 ReadMeshletTriangleByte(byteOffset + 2u));
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Culling of the meshlet groups (see Src/Mesh/MeshletGrouping.h).
+//
+// Every task shader workgroup handles one group of up to 32 meshlets. The groups are bound to the binding 6 of the
+// mesh descriptor set, next to the meshlet bounds:
+//
+//   layout(set = 0, binding = 4) readonly buffer Bounds { MeshletBounds bounds[]; };
+//   layout(set = 0, binding = 6) readonly buffer Groups { MeshletGroup groups[]; };
+//
+// The workgroup tests groups[gl_WorkGroupID.x].bounds first and emits no meshlets if it fails. Otherwise the
+// invocation i tests the meshlet groups[...].meshletOffset + i (if i < meshletCount) on its own.
+
+#ifndef MESHLET_GROUP_GLSL
+#define MESHLET_GROUP_GLSL
+
+struct MeshletBounds
+{
+    vec3 normal;
+    float coneCutoff;
+    vec3 spherePos;
+    float sphereRadius;
+    vec3 coneApex;
+};
+
+struct MeshletGroup
+{
+    MeshletBounds bounds;
+    uint meshletOffset;
+    uint meshletCount;
+};
+
+// Mirrors MeshletCulling::IsBackfacing, works for both the meshlets and the groups.
+bool IsBackfacing(MeshletBounds bounds, vec3 cameraPosition)
+{
+    vec3 toApex = bounds.coneApex - cameraPosition;
+    float distance = length(toApex);
+
+    return distance > 0.0 && dot(toApex, bounds.normal) >= bounds.coneCutoff * distance;
+}
+
+// The planes are normalized and point inside the frustum.
+bool IsSphereInFrustum(vec3 spherePos, float sphereRadius, vec4 planes[6])
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(planes[i].xyz, spherePos) + planes[i].w < -sphereRadius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool IsGroupVisible(MeshletGroup group, vec3 cameraPosition, vec4 planes[6])
+{
+    return IsSphereInFrustum(group.bounds.spherePos, group.bounds.sphereRadius, planes) &&
+           !IsBackfacing(group.bounds, cameraPosition);
+}
+
+#endif
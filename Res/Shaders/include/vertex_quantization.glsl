@@ -0,0 +1,65 @@
+// Decoding of the quantized vertices (EVertexFormat::Quantized, see Src/Mesh/VertexQuantization.h).
+//
+// The including shader has to declare the vertex buffer as raw words and the quantization info beforehand, e.g.:
+//
+//   layout(set = 0, binding = 0) readonly buffer Vertices { uint vertexWords[]; };
+//   layout(set = 0, binding = 7) readonly buffer VertexQuantization { vec4 positionOffset; vec4 positionScale; };
+
+#ifndef VERTEX_QUANTIZATION_GLSL
+#define VERTEX_QUANTIZATION_GLSL
+
+// sizeof(QuantizedVertex) / 4
+#define QUANTIZED_VERTEX_WORDS 5u
+
+vec3 DecodeVertexPosition(uint vertexIndex)
+{
+    uint base = vertexIndex * QUANTIZED_VERTEX_WORDS;
+    uint xy = vertexWords[base];
+    uint z = vertexWords[base + 1u] & 0xFFFFu;
+
+    return positionOffset.xyz + vec3(float(xy & 0xFFFFu), float(xy >> 16), float(z)) * positionScale.xyz;
+}
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+
+    return normalize(normal);
+}
+
+vec3 DecodeVertexNormal(uint vertexIndex)
+{
+    return DecodeOctahedral(unpackSnorm2x16(vertexWords[vertexIndex * QUANTIZED_VERTEX_WORDS + 2u]));
+}
+
+// Returns the quaternion of the tangent frame. The sign of w is the handedness of the bitangent.
+vec4 DecodeVertexTangentFrame(uint vertexIndex)
+{
+    return normalize(unpackSnorm4x8(vertexWords[vertexIndex * QUANTIZED_VERTEX_WORDS + 3u]));
+}
+
+// The first column of the rotation matrix of the frame.
+vec3 GetFrameTangent(vec4 q)
+{
+    return vec3(1.0 - 2.0 * (q.y * q.y + q.z * q.z), 2.0 * (q.x * q.y + q.w * q.z), 2.0 * (q.x * q.z - q.w * q.y));
+}
+
+// The second column of the rotation matrix of the frame, flipped for the left handed frames.
+vec3 GetFrameBitangent(vec4 q)
+{
+    vec3 bitangent =
+        vec3(2.0 * (q.x * q.y - q.w * q.z), 1.0 - 2.0 * (q.x * q.x + q.z * q.z), 2.0 * (q.y * q.z + q.w * q.x));
+
+    return q.w < 0.0 ? -bitangent : bitangent;
+}
+
+vec2 DecodeVertexTexCoords(uint vertexIndex)
+{
+    return unpackHalf2x16(vertexWords[vertexIndex * QUANTIZED_VERTEX_WORDS + 4u]);
+}
+
+#endif
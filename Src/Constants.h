@@ -6,5 +6,16 @@ namespace Constants
     constexpr const unsigned int MAX_MESHLET_INDICES = 384;
     constexpr const unsigned int MAX_MESHLET_TRIANGLES = MAX_MESHLET_INDICES / 3;
 
+    // Number of triangles in a single chunk of the index buffer processed by one thread during the parallel
+    // meshletization. It has to be independent of the thread count, so the output stays deterministic.
+    constexpr const unsigned int MESHLETIZE_CHUNK_TRIANGLES = 1 << 16;
+
 	constexpr const unsigned int MAX_LOD_LEVELS = 8;
+
+    // Number of neighbouring clusters merged and simplified together when building the cluster LOD hierarchy.
+    constexpr const unsigned int CLUSTER_LOD_GROUP_SIZE = 4;
+    constexpr const unsigned int MAX_CLUSTER_LOD_LEVELS = 16;
+
+    // Number of meshlets handled by one task shader workgroup, which are culled together by their MeshletGroup.
+    constexpr const unsigned int MESHLET_GROUP_SIZE = 32;
 } // namespace Constants
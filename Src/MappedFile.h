@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file. The pages are loaded by the OS on the first access, so the data can be
+ * copied (or uploaded) straight from the mapping without reading the file into a buffer first.
+ *
+ * Like VkCore::Buffer, the object owns the mapping and unmaps it when it goes out of scope. It can only be moved.
+ */
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Maps the file, closing the previously mapped one.
+     * @return false if the file couldn't be opened or mapped, or if it is empty.
+     */
+    bool Open(const std::string& filePath);
+
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_Data != nullptr;
+    }
+
+    const uint8_t* GetData() const
+    {
+        return m_Data;
+    }
+
+    size_t GetSize() const
+    {
+        return m_Size;
+    }
+
+  private:
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+};
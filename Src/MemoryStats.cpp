@@ -0,0 +1,132 @@
+#include "MemoryStats.h"
+
+#include "Log/Log.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <cstring>
+#endif
+
+#ifdef _WIN32
+
+size_t MemoryStats::GetResidentBytes()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return counters.WorkingSetSize;
+}
+
+size_t MemoryStats::GetPeakResidentBytes()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return counters.PeakWorkingSetSize;
+}
+
+bool MemoryStats::ResetPeak()
+{
+    return false;
+}
+
+#else
+
+/**
+ * @brief Reads a field in kB (like "VmRSS:") of /proc/self/status.
+ */
+static size_t ReadStatusField(const char* field)
+{
+    FILE* file = std::fopen("/proc/self/status", "r");
+
+    if (file == nullptr)
+    {
+        return 0;
+    }
+
+    const size_t fieldLength = std::strlen(field);
+    size_t value = 0;
+    char line[256];
+
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+        if (std::strncmp(line, field, fieldLength) == 0)
+        {
+            std::sscanf(line + fieldLength, "%zu", &value);
+            break;
+        }
+    }
+
+    std::fclose(file);
+
+    return value * 1024;
+}
+
+size_t MemoryStats::GetResidentBytes()
+{
+    return ReadStatusField("VmRSS:");
+}
+
+size_t MemoryStats::GetPeakResidentBytes()
+{
+    return ReadStatusField("VmHWM:");
+}
+
+bool MemoryStats::ResetPeak()
+{
+    // Writing 5 resets the peak resident memory (VmHWM) of the process.
+    FILE* file = std::fopen("/proc/self/clear_refs", "w");
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const bool reset = std::fputs("5", file) >= 0;
+
+    return std::fclose(file) == 0 && reset;
+}
+
+#endif
+
+void MemoryStats::SetStageHook(const StageHook& hook)
+{
+    s_StageHook = hook;
+
+    if (s_StageHook)
+    {
+        ResetPeak();
+    }
+}
+
+void MemoryStats::EndStage(const char* stage)
+{
+    if (!s_StageHook)
+    {
+        return;
+    }
+
+    s_StageHook(stage, GetResidentBytes(), GetPeakResidentBytes());
+
+    ResetPeak();
+}
+
+// The arguments are unused when the logging is compiled out.
+void MemoryStats::LogStage([[maybe_unused]] const char* stage, [[maybe_unused]] const size_t residentBytes,
+                           [[maybe_unused]] const size_t peakBytes)
+{
+    LOGF(Allocation, Info, "%s: resident %.1f MB, peak %.1f MB", stage, residentBytes / (1024.0 * 1024.0),
+         peakBytes / (1024.0 * 1024.0))
+}
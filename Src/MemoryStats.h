@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Resident memory of the process, for finding out which stage of a pipeline (like the import of a model) is
+ * responsible for its peak memory.
+ *
+ * The stages report themselves by EndStage. Nothing is measured until a hook is set, so the stages cost nothing in
+ * a normal run.
+ */
+class MemoryStats
+{
+
+  public:
+    /**
+     * @param stage - name of the finished stage
+     * @param residentBytes - resident memory at the end of the stage
+     * @param peakBytes - peak resident memory during the stage. Since the start of the process, if the peak can't
+     * be reset on the platform.
+     */
+    using StageHook = std::function<void(const char* stage, const size_t residentBytes, const size_t peakBytes)>;
+
+    /**
+     * @brief Returns the resident memory (working set) of the process in bytes, or 0 if it isn't available.
+     */
+    static size_t GetResidentBytes();
+
+    /**
+     * @brief Returns the peak resident memory of the process in bytes, or 0 if it isn't available.
+     */
+    static size_t GetPeakResidentBytes();
+
+    /**
+     * @brief Resets the peak resident memory to the current one.
+     * @return false if the platform doesn't support it (only Linux does).
+     */
+    static bool ResetPeak();
+
+    /**
+     * @brief Sets the hook called at the end of every stage and resets the peak, so the first stage starts with it.
+     * An empty hook turns the measuring off.
+     */
+    static void SetStageHook(const StageHook& hook);
+
+    /**
+     * @brief Calls the hook with the memory of the finished stage and resets the peak for the next one. Should be
+     * called from one thread at a time.
+     */
+    static void EndStage(const char* stage);
+
+    /**
+     * @brief Hook writing the stages into the log.
+     */
+    static void LogStage(const char* stage, const size_t residentBytes, const size_t peakBytes);
+
+  private:
+    inline static StageHook s_StageHook;
+};
@@ -4,55 +4,86 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <immintrin.h>
 #include <limits>
+#include <optional>
 
 #include "../Log/Log.h"
 #include "../Vk/Buffers/Buffer.h"
+#include "../Vk/Buffers/GeometryUploader.h"
 #include "ClassicLODModel.h"
+#include "Mesh/IndexCodec.h"
 #include "Mesh/MeshUtils.h"
+#include "Mesh/OverdrawOptimizer.h"
+#include "Mesh/VertexCacheOptimizer.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "vulkan/vulkan_enums.hpp"
 
-ClassicLODMesh::ClassicLODMesh(const std::vector<LODData>& lodData)
+ClassicLODMesh::ClassicLODMesh(std::vector<ClassicLODData>&& lodData, const MeshBuildOptions& options)
+    : ClassicLODMesh(Build(std::move(lodData), options).GetView(), nullptr, options.residency)
+{
+}
+
+MeshData ClassicLODMesh::Build(std::vector<ClassicLODData>&& lodData, const MeshBuildOptions& options)
 {
     ASSERT(lodData.size() <= 8, "There are more LODs than supported");
     ASSERT(lodData.size() > 0, "There are more no LODs to load");
 
-    m_LodInfo.LodCount = lodData.size();
+    ClassicLODMeshInfo lodInfo;
+    lodInfo.LodCount = lodData.size();
 
-    // Accumulating vertex offset replaced.
-	std::vector<Vertex> allVertices;
-	std::vector<uint32_t> allIndices;
+	// The arrays of every LOD, concatenated once all of them are built.
+	std::vector<std::vector<Vertex>> lodVertices(lodData.size());
+	std::vector<std::vector<uint32_t>> lodIndices(lodData.size());
+
+	// Offsets of the LOD in the concatenated vertices and indices.
+	uint32_t accVertexBase = 0;
+	uint32_t accIndexOffset = 0;
+
+	// Shared by all the LODs, so the working memory of Tipsify is allocated only once.
+	TipsifyScratch tipsifyScratch;
 
     for (uint8_t l = 0; l < lodData.size(); l++)
     {
-			
-		size_t vertexOffset = allVertices.size();
+		std::vector<uint32_t> indices = VertexCacheOptimizer::Optimize(options, lodData.at(l).indices,
+		                                                               lodData.at(l).vertices.size(), tipsifyScratch);
+
+		if (options.optimizeOverdraw)
+		{
+			indices = OverdrawOptimizer::Optimize(indices, lodData[l].vertices, options.vertexCacheSize,
+			                                      options.overdrawThreshold);
+		}
 
-		std::vector<uint32_t> indices = MeshUtils::Tipsify(lodData.at(l).indices, lodData.at(l).vertices.size(), 32);
+		// Only the optimized order is used from now on.
+		std::vector<uint32_t>().swap(lodData[l].indices);
 
-		m_LodInfo.indexCount[l] = indices.size();
-		m_LodInfo.indexOffset[l] = allIndices.size();
-		m_LodInfo.vertexCount[l] = lodData[l].vertices.size();
+		lodVertices[l] = std::move(lodData[l].vertices);
+		MeshUtils::OptimizeVertexFetch(indices, lodVertices[l]);
 
-		for (uint32_t i = 0; i < indices.size(); i++) {
-			allIndices.emplace_back(indices[i] + allVertices.size());
-		}
+		lodInfo.indexCount[l] = indices.size();
+		lodInfo.indexOffset[l] = accIndexOffset;
+		lodInfo.vertexCount[l] = lodVertices[l].size();
+		lodInfo.lodErrors[l] = lodData[l].error;
 
-		for (const auto& vertex : lodData[l].vertices) {
-			allVertices.emplace_back(vertex);
+		for (uint32_t& index : indices) {
+			index += accVertexBase;
 		}
+
+		accVertexBase += lodVertices[l].size();
+		accIndexOffset += indices.size();
+		lodIndices[l] = std::move(indices);
     }
 
-	vertices = allVertices;
+	std::vector<Vertex> allVertices = MeshUtils::Concatenate(lodVertices);
+	std::vector<uint32_t> allIndices = MeshUtils::Concatenate(lodIndices);
 
-	Vec3f max = Vec3f(std::numeric_limits<float>::min());
+	Vec3f max = Vec3f(-std::numeric_limits<float>::max());
 	Vec3f min = Vec3f(std::numeric_limits<float>::max());
 
-	for (size_t i = 0; i < m_LodInfo.vertexCount[0]; i++) {
+	for (size_t i = 0; i < lodInfo.vertexCount[0]; i++) {
 		
-		Vec3f position = Vec3f(glm::value_ptr(vertices[i].Position));
+		Vec3f position = Vec3f(glm::value_ptr(allVertices[i].Position));
 
 		max = Vec3f::Max(max, position);
 		min = Vec3f::Min(min, position);
@@ -60,12 +91,109 @@ ClassicLODMesh::ClassicLODMesh(const std::vector<LODData>& lodData)
 
 	Vec3f sphereCenter = (max + min) / 2.0;
 
-	m_LodInfo.sphereCenter = {sphereCenter.x, sphereCenter.y, sphereCenter.z};
-	m_LodInfo.sphereRadius = (sphereCenter - max).Magnitude();
+	lodInfo.sphereCenter = {sphereCenter.x, sphereCenter.y, sphereCenter.z};
+	lodInfo.sphereRadius = (sphereCenter - max).Magnitude();
+
+	MeshData data;
+
+	data.Set(EMeshSection::Indices, std::move(allIndices));
+	data.Set(EMeshSection::Vertices, std::move(allVertices));
+	data.Set(EMeshSection::LodInfo, &lodInfo, 1);
+
+	return data;
+}
+
+ClassicLODMesh::ClassicLODMesh(const MeshDataView& data, VkCore::GeometryUploader* uploader,
+                               const EMeshResidency residency)
+    : m_Residency(residency)
+{
+	ASSERT(data.GetSize(EMeshSection::LodInfo) == sizeof(ClassicLODMeshInfo), "The LOD info of the mesh is missing!")
+
+	std::memcpy(&m_LodInfo, data.GetData(EMeshSection::LodInfo), sizeof(ClassicLODMeshInfo));
+
+	if (residency == EMeshResidency::KeepAll)
+	{
+		vertices = data.Copy<Vertex>(EMeshSection::Vertices);
+	}
+	else if (residency == EMeshResidency::PositionsOnly)
+	{
+		m_Positions.Assign(data.Get<Vertex>(EMeshSection::Vertices), data.GetCount<Vertex>(EMeshSection::Vertices));
+	}
+
+	// Only created if the caller didn't pass an uploader, waits for the upload in its destructor.
+	std::optional<VkCore::GeometryUploader> ownUploader;
+	VkCore::GeometryUploader& batch = uploader != nullptr ? *uploader : ownUploader.emplace();
 
     m_VertexBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eVertexBuffer);
-    m_VertexBuffer.InitializeOnGpu(vertices.data(), vertices.size() * sizeof(Vertex));
+    batch.Upload(m_VertexBuffer, data.GetData(EMeshSection::Vertices), data.GetSize(EMeshSection::Vertices));
 
     m_IndexBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eIndexBuffer);
-    m_IndexBuffer.InitializeOnGpu(allIndices.data(), allIndices.size() * sizeof(uint32_t));
+
+	const uint8_t* indices = data.Get<uint8_t>(EMeshSection::Indices);
+	const size_t indicesSize = data.GetSize(EMeshSection::Indices);
+
+	if (data.header.indicesEncoded)
+	{
+		EncodedIndexHeader indexHeader;
+
+		const bool valid = IndexCodec::ReadHeader(indices, indicesSize, indexHeader);
+
+		ASSERT(valid, "Failed to decode the indices of a mesh!")
+
+		// Decoded straight into the staging buffer. The rotation of the triangles doesn't change the rendering.
+		const size_t decodedSize = indexHeader.indexCount * sizeof(uint32_t);
+
+		batch.Upload(m_IndexBuffer, decodedSize, [indices, indicesSize, decodedSize](void* mappedData) {
+			const bool decoded = IndexCodec::Decode(indices, indicesSize, static_cast<uint32_t*>(mappedData), false);
+
+			ASSERT(decoded, "Failed to decode the indices of a mesh!")
+
+			// The header only validates the sizes. Degenerate triangles instead of indices out of the vertex buffer.
+			if (!decoded)
+			{
+				std::memset(mappedData, 0, decodedSize);
+			}
+		});
+	}
+	else
+	{
+		batch.Upload(m_IndexBuffer, indices, indicesSize);
+	}
+
+	if (ownUploader.has_value())
+	{
+		ownUploader->Submit();
+	}
+}
+
+void ClassicLODMesh::SetResidency(const EMeshResidency residency)
+{
+	ASSERT(residency >= m_Residency, "The freed geometry of a mesh can't be restored!")
+
+	if (residency <= m_Residency)
+	{
+		return;
+	}
+
+	if (residency == EMeshResidency::PositionsOnly)
+	{
+		m_Positions.Assign(vertices.data(), vertices.size());
+	}
+	else
+	{
+		m_Positions.Clear();
+	}
+
+	std::vector<Vertex>().swap(vertices);
+	m_Residency = residency;
+}
+
+MeshMemoryStats ClassicLODMesh::GetMemoryStats() const
+{
+	MeshMemoryStats stats;
+	stats.cpuVertexBytes = vertices.capacity() * sizeof(Vertex);
+	stats.cpuPositionBytes = m_Positions.GetSizeInBytes();
+	stats.gpuBytes = size_t(m_VertexBuffer.GetSize()) + m_IndexBuffer.GetSize();
+
+	return stats;
 }
@@ -1,6 +1,9 @@
 
 #pragma once
 
+#include "Mesh/MeshBuildOptions.h"
+#include "Mesh/MeshData.h"
+#include "Mesh/MeshResidency.h"
 #include "Mesh/MeshVertex.h"
 #include "Vk/Buffers/Buffer.h"
 #include "vulkan/vulkan_handles.hpp"
@@ -24,13 +27,43 @@ struct ClassicLODMeshInfo
 	alignas(16) glm::vec3 sphereCenter;
 	float sphereRadius;
     uint32_t LodCount = 0;
+
+    // Error of every LOD in the units of the mesh (see LODGenerator::SelectLevel), 0 for the loaded LODs.
+    float lodErrors[8] = {
+        0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+    };
 };
 
-struct LODData;
+namespace VkCore
+{
+    class GeometryUploader;
+}
+
+struct ClassicLODData;
 class ClassicLODMesh
 {
   public:
-    ClassicLODMesh(const std::vector<LODData>& lodData);
+    /**
+     * @param lodData - consumed, the vertices are moved into the mesh.
+     * @param options - only the index and vertex buffer optimizations apply, there are no meshlets.
+     */
+    ClassicLODMesh(std::vector<ClassicLODData>&& lodData, const MeshBuildOptions& options = {});
+
+    /**
+     * @brief Uploads a mesh built by Build, or loaded from the MeshCache.
+     * @param uploader - records the uploads into the batch of the uploader, the data of the view has to stay valid
+     * until it is submitted. If null, the mesh is uploaded in a batch of its own and waited for.
+     * @param residency - what stays on the CPU. Only that is copied out of the view.
+     */
+    ClassicLODMesh(const MeshDataView& data, VkCore::GeometryUploader* uploader = nullptr,
+                   const EMeshResidency residency = EMeshResidency::KeepAll);
+
+    /**
+     * @brief Optimizes the index and vertex buffers of every LOD and merges the LODs into one set of buffers.
+     * Doesn't touch the GPU.
+     * @param lodData - consumed, the vertices of every LOD are moved instead of copied.
+     */
+    static MeshData Build(std::vector<ClassicLODData>&& lodData, const MeshBuildOptions& options = {});
 
     ClassicLODMeshInfo GetMeshInfo() const
     {
@@ -58,11 +91,33 @@ class ClassicLODMesh
         m_IndexBuffer.Destroy();
     }
 
+    /**
+     * @brief Frees the CPU side of the geometry which isn't needed by the residency. The freed data can't be
+     * restored, so a mesh can only go from KeepAll to PositionsOnly to Release.
+     */
+    void SetResidency(const EMeshResidency residency);
+
+    EMeshResidency GetResidency() const
+    {
+        return m_Residency;
+    }
+
+    const MeshPositions& GetPositions() const
+    {
+        return m_Positions;
+    }
+
+    MeshMemoryStats GetMemoryStats() const;
+
+    // Kept only with EMeshResidency::KeepAll.
     std::vector<Vertex> vertices;
 
   private:
     ClassicLODMeshInfo m_LodInfo;
 
+    EMeshResidency m_Residency = EMeshResidency::KeepAll;
+    MeshPositions m_Positions;
+
     VkCore::Buffer m_VertexBuffer;
     VkCore::Buffer m_IndexBuffer;
 };
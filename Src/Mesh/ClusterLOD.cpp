@@ -0,0 +1,404 @@
+#include "ClusterLOD.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <unordered_map>
+#include <utility>
+
+#include "Constants.h"
+#include "Log/Log.h"
+#include "MeshletBuilder.h"
+#include "MeshletGeneration.h"
+#include "ThreadUtils.h"
+#include "glm/geometric.hpp"
+#include "src/meshoptimizer.h"
+
+// Groups whose simplification keeps more than this fraction of the triangles are not worth another level.
+static constexpr float MIN_SIMPLIFICATION_RATIO = 0.85f;
+
+struct LODSphere
+{
+    glm::vec3 center;
+    float radius;
+};
+
+static LODSphere ComputeMeshletSphere(const ClusterLODData& data, const NewMeshlet& meshlet,
+                                      const std::vector<MeshVertex>& vertices)
+{
+    glm::vec3 minPoint(FLT_MAX), maxPoint(-FLT_MAX);
+
+    for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+    {
+        const glm::vec3& position = vertices[data.meshletVertices[meshlet.vertexOffset + v]].Position;
+
+        minPoint = glm::min(minPoint, position);
+        maxPoint = glm::max(maxPoint, position);
+    }
+
+    const glm::vec3 center = (minPoint + maxPoint) * 0.5f;
+    float radius = 0.f;
+
+    for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+    {
+        const glm::vec3& position = vertices[data.meshletVertices[meshlet.vertexOffset + v]].Position;
+        radius = std::max(radius, glm::length(position - center));
+    }
+
+    return {center, radius};
+}
+
+// Smallest sphere containing both of the spheres. It is slightly enlarged, so the parent sphere contains the child
+// ones even after rounding and the projected error stays monotonic.
+static LODSphere MergeSpheres(const LODSphere& a, const LODSphere& b)
+{
+    const glm::vec3 direction = b.center - a.center;
+    const float distance = glm::length(direction);
+
+    if (distance + b.radius <= a.radius)
+    {
+        return a;
+    }
+
+    if (distance + a.radius <= b.radius)
+    {
+        return b;
+    }
+
+    const float radius = (distance + a.radius + b.radius) * 0.5f;
+
+    return {a.center + direction * ((radius - a.radius) / distance), radius * (1.f + 1e-5f)};
+}
+
+/**
+ * Splits the pending clusters into groups of up to Constants::CLUSTER_LOD_GROUP_SIZE neighbours. Two clusters are
+ * neighbours if they share vertices, the more they share, the better they fit into one group (the shared border
+ * can be simplified). The groups are grown greedily from the first ungrouped cluster.
+ * @return groups of indices into the data.meshlets.
+ */
+static std::vector<std::vector<uint32_t>> GroupClusters(const ClusterLODData& data,
+                                                        const std::vector<uint32_t>& pending)
+{
+    // --- (vertex, pending cluster) pairs sorted by the vertex give the clusters sharing every vertex.
+    std::vector<std::pair<uint32_t, uint32_t>> vertexClusters;
+
+    for (uint32_t p = 0; p < pending.size(); p++)
+    {
+        const NewMeshlet& meshlet = data.meshlets[pending[p]];
+
+        for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+        {
+            vertexClusters.emplace_back(data.meshletVertices[meshlet.vertexOffset + v], p);
+        }
+    }
+
+    std::sort(vertexClusters.begin(), vertexClusters.end());
+
+    std::vector<std::unordered_map<uint32_t, uint32_t>> adjacency(pending.size());
+
+    for (size_t begin = 0, end = 0; begin < vertexClusters.size(); begin = end)
+    {
+        while (end < vertexClusters.size() && vertexClusters[end].first == vertexClusters[begin].first)
+        {
+            end++;
+        }
+
+        for (size_t i = begin; i < end; i++)
+        {
+            for (size_t j = i + 1; j < end; j++)
+            {
+                adjacency[vertexClusters[i].second][vertexClusters[j].second]++;
+                adjacency[vertexClusters[j].second][vertexClusters[i].second]++;
+            }
+        }
+    }
+
+    // --- Greedy growth. Ties are broken by the lower index, so the grouping is deterministic.
+    std::vector<bool> grouped(pending.size(), false);
+    std::vector<std::vector<uint32_t>> groups;
+
+    for (uint32_t seed = 0; seed < pending.size(); seed++)
+    {
+        if (grouped[seed])
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> group = {seed};
+        grouped[seed] = true;
+
+        while (group.size() < Constants::CLUSTER_LOD_GROUP_SIZE)
+        {
+            uint32_t best = UINT32_MAX, bestShared = 0;
+
+            for (const uint32_t member : group)
+            {
+                for (const auto& [neighbour, shared] : adjacency[member])
+                {
+                    if (!grouped[neighbour] && (shared > bestShared || (shared == bestShared && neighbour < best)))
+                    {
+                        best = neighbour;
+                        bestShared = shared;
+                    }
+                }
+            }
+
+            if (best == UINT32_MAX)
+            {
+                break;
+            }
+
+            group.emplace_back(best);
+            grouped[best] = true;
+        }
+
+        for (uint32_t& member : group)
+        {
+            member = pending[member];
+        }
+
+        groups.emplace_back(std::move(group));
+    }
+
+    return groups;
+}
+
+struct GroupResult
+{
+    bool simplified = false;
+    LODSphere sphere;
+    float error = 0.f;
+
+    std::vector<NewMeshlet> meshlets;
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletTriangles;
+};
+
+/**
+ * Merges the clusters of the group, simplifies them to a half with the group border locked and meshletizes the
+ * result again.
+ */
+static void SimplifyGroup(const ClusterLODData& data, const std::vector<uint32_t>& group,
+                          const std::vector<MeshVertex>& vertices, GroupResult& result)
+{
+    std::vector<uint32_t> groupIndices;
+
+    for (const uint32_t meshletIndex : group)
+    {
+        const NewMeshlet& meshlet = data.meshlets[meshletIndex];
+        const uint32_t* meshletVertices = &data.meshletVertices[meshlet.vertexOffset];
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const uint32_t triangle = data.meshletTriangles[meshlet.triangleOffset + t];
+
+            groupIndices.emplace_back(meshletVertices[triangle & 0xFF]);
+            groupIndices.emplace_back(meshletVertices[(triangle >> 8) & 0xFF]);
+            groupIndices.emplace_back(meshletVertices[(triangle >> 16) & 0xFF]);
+        }
+    }
+
+    // --- The simplifier works on a local copy of the group vertices, so its cost doesn't depend on the mesh size.
+    std::vector<uint32_t> groupVertices(groupIndices);
+    std::sort(groupVertices.begin(), groupVertices.end());
+    groupVertices.erase(std::unique(groupVertices.begin(), groupVertices.end()), groupVertices.end());
+
+    std::vector<float> positions;
+    positions.reserve(groupVertices.size() * 3);
+
+    for (const uint32_t vertex : groupVertices)
+    {
+        positions.insert(positions.end(),
+                         {vertices[vertex].Position.x, vertices[vertex].Position.y, vertices[vertex].Position.z});
+    }
+
+    std::vector<uint32_t> localIndices(groupIndices.size());
+
+    for (size_t i = 0; i < groupIndices.size(); i++)
+    {
+        localIndices[i] =
+            std::lower_bound(groupVertices.begin(), groupVertices.end(), groupIndices[i]) - groupVertices.begin();
+    }
+
+    const size_t targetIndexCount = (localIndices.size() / 6) * 3;
+
+    std::vector<uint32_t> simplified(localIndices.size());
+    float simplifyError = 0.f;
+
+    const size_t indexCount = meshopt_simplify(simplified.data(), localIndices.data(), localIndices.size(),
+                                               positions.data(), groupVertices.size(), sizeof(float) * 3,
+                                               targetIndexCount, FLT_MAX, meshopt_SimplifyLockBorder, &simplifyError);
+
+    if (indexCount == 0 || indexCount > localIndices.size() * MIN_SIMPLIFICATION_RATIO)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        simplified[i] = groupVertices[simplified[i]];
+    }
+
+    MeshletBuilder builder(Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, result.meshlets,
+                           result.meshletVertices, result.meshletTriangles);
+    builder.PushIndices(simplified.data(), indexCount);
+    builder.Finish();
+
+    // --- The error and the sphere have to cover the children, so the parents are never finer than the children.
+    result.sphere = {data.clusters[group[0]].lodSpherePos, data.clusters[group[0]].lodSphereRadius};
+    result.error = 0.f;
+
+    for (const uint32_t meshletIndex : group)
+    {
+        const LODCluster& cluster = data.clusters[meshletIndex];
+
+        result.sphere = MergeSpheres(result.sphere, {cluster.lodSpherePos, cluster.lodSphereRadius});
+        result.error = std::max(result.error, cluster.lodError);
+    }
+
+    // The simplifier reports the error relative to the size of the group.
+    result.error += simplifyError * meshopt_simplifyScale(positions.data(), groupVertices.size(), sizeof(float) * 3);
+    result.simplified = true;
+}
+
+ClusterLODData ClusterLOD::Build(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+                                 const MeshBuildOptions& options)
+{
+    ClusterLODData data;
+
+    // --- Level 0 are the meshlets of the full detail mesh.
+    data.meshlets =
+        MeshletGeneration::Meshletize(options, Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES,
+                                      indices, vertices, data.meshletVertices, data.meshletTriangles);
+
+    std::vector<uint32_t> pending;
+
+    for (uint32_t m = 0; m < data.meshlets.size(); m++)
+    {
+        const LODSphere sphere = ComputeMeshletSphere(data, data.meshlets[m], vertices);
+
+        data.clusters.emplace_back(LODCluster{
+            .lodSpherePos = sphere.center,
+            .lodSphereRadius = sphere.radius,
+            .lodError = 0.f,
+            .parentSpherePos = sphere.center,
+            .parentSphereRadius = sphere.radius,
+            .parentError = FLT_MAX,
+            .level = 0,
+        });
+
+        pending.emplace_back(m);
+    }
+
+    data.levelMeshletCounts.emplace_back(data.meshlets.size());
+
+    for (uint32_t level = 1; level < Constants::MAX_CLUSTER_LOD_LEVELS && pending.size() > 1; level++)
+    {
+        const std::vector<std::vector<uint32_t>> groups = GroupClusters(data, pending);
+
+        std::vector<GroupResult> results(groups.size());
+
+        ThreadUtils::ParallelFor(groups.size(), 0, [&](const size_t groupIndex, const uint32_t) {
+            SimplifyGroup(data, groups[groupIndex], vertices, results[groupIndex]);
+        });
+
+        // --- Merged in the group order, so the output doesn't depend on the thread count.
+        const size_t levelStart = data.meshlets.size();
+        std::vector<uint32_t> nextPending;
+
+        for (size_t g = 0; g < groups.size(); g++)
+        {
+            const GroupResult& result = results[g];
+
+            // The clusters of a group which couldn't be simplified stay without parents and get another chance
+            // in a different group on the next level.
+            if (!result.simplified)
+            {
+                nextPending.insert(nextPending.end(), groups[g].begin(), groups[g].end());
+                continue;
+            }
+
+            for (const uint32_t child : groups[g])
+            {
+                data.clusters[child].parentSpherePos = result.sphere.center;
+                data.clusters[child].parentSphereRadius = result.sphere.radius;
+                data.clusters[child].parentError = result.error;
+            }
+
+            const uint32_t vertexOffset = data.meshletVertices.size();
+            const uint32_t triangleOffset = data.meshletTriangles.size();
+
+            for (NewMeshlet meshlet : result.meshlets)
+            {
+                meshlet.vertexOffset += vertexOffset;
+                meshlet.triangleOffset += triangleOffset;
+
+                nextPending.emplace_back(data.meshlets.size());
+
+                data.meshlets.emplace_back(meshlet);
+                data.clusters.emplace_back(LODCluster{
+                    .lodSpherePos = result.sphere.center,
+                    .lodSphereRadius = result.sphere.radius,
+                    .lodError = result.error,
+                    .parentSpherePos = result.sphere.center,
+                    .parentSphereRadius = result.sphere.radius,
+                    .parentError = FLT_MAX,
+                    .level = level,
+                });
+            }
+
+            data.meshletVertices.insert(data.meshletVertices.end(), result.meshletVertices.begin(),
+                                        result.meshletVertices.end());
+            data.meshletTriangles.insert(data.meshletTriangles.end(), result.meshletTriangles.begin(),
+                                         result.meshletTriangles.end());
+        }
+
+        // None of the groups could be simplified any further.
+        if (data.meshlets.size() == levelStart)
+        {
+            break;
+        }
+
+        data.levelMeshletCounts.emplace_back(data.meshlets.size() - levelStart);
+        pending = std::move(nextPending);
+    }
+
+    LOGF(Rendering, Verbose, "Cluster LOD: %zu levels, %zu meshlets", data.levelMeshletCounts.size(),
+         data.meshlets.size())
+
+    return data;
+}
+
+float ClusterLOD::ProjectError(const glm::vec3& spherePos, const float sphereRadius, const float error,
+                               const glm::vec3& cameraPosition)
+{
+    // Inside of the sphere the error can't be bounded, so only the finest level passes.
+    const float distance = std::max(glm::length(spherePos - cameraPosition) - sphereRadius, FLT_MIN);
+
+    return error / distance;
+}
+
+bool ClusterLOD::IsClusterSelected(const LODCluster& cluster, const glm::vec3& cameraPosition,
+                                   const float errorThreshold)
+{
+    const float error = ProjectError(cluster.lodSpherePos, cluster.lodSphereRadius, cluster.lodError, cameraPosition);
+    const float parentError =
+        ProjectError(cluster.parentSpherePos, cluster.parentSphereRadius, cluster.parentError, cameraPosition);
+
+    return error <= errorThreshold && parentError > errorThreshold;
+}
+
+std::vector<uint32_t> ClusterLOD::SelectClusters(const ClusterLODData& data, const glm::vec3& cameraPosition,
+                                                 const float errorThreshold)
+{
+    std::vector<uint32_t> selected;
+
+    for (uint32_t c = 0; c < data.clusters.size(); c++)
+    {
+        if (IsClusterSelected(data.clusters[c], cameraPosition, errorThreshold))
+        {
+            selected.emplace_back(c);
+        }
+    }
+
+    return selected;
+}
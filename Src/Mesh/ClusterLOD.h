@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh/MeshBuildOptions.h"
+#include "Mesh/MeshVertex.h"
+#include "Meshlet.h"
+#include "glm/ext/vector_float3.hpp"
+
+/**
+ * Meshlets of all the levels of the cluster LOD hierarchy. The clusters are parallel to the meshlets.
+ */
+struct ClusterLODData
+{
+    std::vector<NewMeshlet> meshlets;
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletTriangles;
+    std::vector<LODCluster> clusters;
+
+    // Number of meshlets of every level. The levels are stored one after another, starting with the full detail.
+    std::vector<uint32_t> levelMeshletCounts;
+};
+
+/**
+ * Builds a hierarchy of meshlets (a DAG) with a continuous level of detail, which doesn't need any authored LOD files.
+ *
+ * Level 0 are the meshlets of the original mesh. Every next level is created by merging groups of neighbouring
+ * meshlets of the previous level, simplifying every group to half of its triangles with the borders of the group
+ * locked and splitting the result into meshlets again. Since the group borders don't move, the neighbouring groups
+ * can be drawn at different levels without cracks. A meshlet can have parents in several groups of the next level,
+ * therefore it is a DAG and not a tree.
+ *
+ * Every meshlet stores the error and the bounding sphere of the group it was created in and of the group it was
+ * simplified in (its parents). The error only grows towards the roots and the parent spheres contain the child ones,
+ * so for a given view exactly one cut through the DAG satisfies IsClusterSelected.
+ */
+class ClusterLOD
+{
+  public:
+    /**
+     * @param indices - triangles of the full detail mesh, ideally optimized for the vertex cache, because the level 0
+     * meshlets are built in the order of the triangles.
+     */
+    static ClusterLODData Build(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+                                const MeshBuildOptions& options = {});
+
+    /**
+     * @brief Projects the error of the sphere onto the screen. The error is divided by the distance from the closest
+     * point of the sphere, so it is conservative for the whole sphere.
+     * @return error per unit of distance from the camera. Multiply it by the projection scale
+     * (viewportHeight / (2 * tan(fovY / 2))) for the error in pixels.
+     */
+    static float ProjectError(const glm::vec3& spherePos, const float sphereRadius, const float error,
+                              const glm::vec3& cameraPosition);
+
+    /**
+     * @brief Decides whether the cluster is a part of the cut for the given view. The cluster is drawn when its own
+     * error is small enough, but the error of its parents is not.
+     * @param errorThreshold - maximum projected error (see ProjectError).
+     */
+    static bool IsClusterSelected(const LODCluster& cluster, const glm::vec3& cameraPosition,
+                                  const float errorThreshold);
+
+    /**
+     * @brief CPU reference of the cut. Returns the indices of the selected meshlets.
+     */
+    static std::vector<uint32_t> SelectClusters(const ClusterLODData& data, const glm::vec3& cameraPosition,
+                                                const float errorThreshold);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Half-edge adjacency of a triangle list, built by MeshUtils::BuildEdgeAdjacency. The half-edge i goes from the
+ * vertex indices[i] to the next vertex of the same triangle, so the half-edges share the numbering of the index
+ * buffer and the triangle of the half-edge i is i / 3.
+ */
+struct EdgeAdjacency
+{
+    // Half-edge without an opposite one - the edge is on the boundary, or it is shared by more than two triangles
+    // (or by two triangles with an inconsistent winding), or its triangle is degenerate.
+    static constexpr uint32_t NO_EDGE = 0xFFFFFFFF;
+
+    // Opposite (twin) half-edge of every half-edge, or NO_EDGE.
+    std::vector<uint32_t> opposite;
+
+    static uint32_t GetTriangle(const uint32_t halfEdge)
+    {
+        return halfEdge / 3;
+    }
+
+    static uint32_t GetNext(const uint32_t halfEdge)
+    {
+        return halfEdge % 3 == 2 ? halfEdge - 2 : halfEdge + 1;
+    }
+
+    static uint32_t GetPrevious(const uint32_t halfEdge)
+    {
+        return halfEdge % 3 == 0 ? halfEdge + 2 : halfEdge - 1;
+    }
+
+    bool IsBoundary(const size_t halfEdge) const
+    {
+        return opposite[halfEdge] == NO_EDGE;
+    }
+
+    /**
+     * @brief Returns the triangle across the edge, or NO_EDGE if there is none.
+     */
+    uint32_t GetNeighbourTriangle(const size_t halfEdge) const
+    {
+        return opposite[halfEdge] == NO_EDGE ? NO_EDGE : opposite[halfEdge] / 3;
+    }
+};
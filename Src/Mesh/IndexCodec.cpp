@@ -0,0 +1,165 @@
+#include "IndexCodec.h"
+
+#include <cstring>
+
+#include "../Log/Log.h"
+#include "src/meshoptimizer.h"
+
+// Version 1 of the meshoptimizer format, the decoder of meshoptimizer reads all the versions.
+static constexpr int MESHOPT_INDEX_VERSION = 1;
+
+/**
+ * @brief Returns by how many positions the triangle b was rotated to the left against the triangle a, or 3 if b is
+ * not a rotation of a.
+ */
+static uint32_t GetRotation(const uint32_t* a, const uint32_t* b)
+{
+    for (uint32_t rotation = 0; rotation < 3; rotation++)
+    {
+        if (b[0] == a[rotation] && b[1] == a[(rotation + 1) % 3] && b[2] == a[(rotation + 2) % 3])
+        {
+            return rotation;
+        }
+    }
+
+    return 3;
+}
+
+std::vector<uint8_t> IndexCodec::Encode(const uint32_t* indices, const size_t indexCount, const size_t vertexCount)
+{
+    ASSERT(indexCount % 3 == 0, "The index buffer has to be a triangle list!")
+
+    const size_t triangleCount = indexCount / 3;
+    const size_t rotationSize = (triangleCount + 3) / 4;
+
+    std::vector<uint8_t> encoded(sizeof(EncodedIndexHeader) +
+                                 meshopt_encodeIndexBufferBound(indexCount, vertexCount) + rotationSize);
+
+    meshopt_encodeIndexVersion(MESHOPT_INDEX_VERSION);
+
+    const size_t streamSize = meshopt_encodeIndexBuffer(encoded.data() + sizeof(EncodedIndexHeader),
+                                                        encoded.size() - sizeof(EncodedIndexHeader), indices,
+                                                        indexCount);
+
+    ASSERT(streamSize > 0, "The index buffer doesn't fit into its bound!")
+
+    // --- The codec only tells the rotations by decoding its own output.
+    std::vector<uint32_t> decoded(indexCount);
+
+    const int result = meshopt_decodeIndexBuffer(decoded.data(), indexCount, sizeof(uint32_t),
+                                                 encoded.data() + sizeof(EncodedIndexHeader), streamSize);
+
+    ASSERT(result == 0, "Couldn't decode the encoded index buffer!")
+
+    uint8_t* rotations = encoded.data() + sizeof(EncodedIndexHeader) + streamSize;
+    std::memset(rotations, 0, rotationSize);
+
+    bool rotated = false;
+
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const uint32_t rotation = GetRotation(indices + t * 3, decoded.data() + t * 3);
+
+        ASSERT(rotation < 3, "The codec changed a triangle!")
+
+        rotations[t / 4] |= rotation << ((t % 4) * 2);
+        rotated |= rotation != 0;
+    }
+
+    const EncodedIndexHeader header = {
+        .magic = MAGIC,
+        .version = VERSION,
+        .indexCount = static_cast<uint32_t>(indexCount),
+        .vertexCount = static_cast<uint32_t>(vertexCount),
+        .streamSize = static_cast<uint32_t>(streamSize),
+        .rotationSize = static_cast<uint32_t>(rotated ? rotationSize : 0),
+    };
+
+    std::memcpy(encoded.data(), &header, sizeof(EncodedIndexHeader));
+
+    encoded.resize(sizeof(EncodedIndexHeader) + header.streamSize + header.rotationSize);
+    encoded.shrink_to_fit();
+
+    return encoded;
+}
+
+bool IndexCodec::ReadHeader(const uint8_t* data, const size_t size, EncodedIndexHeader& outHeader)
+{
+    if (size < sizeof(EncodedIndexHeader))
+    {
+        return false;
+    }
+
+    std::memcpy(&outHeader, data, sizeof(EncodedIndexHeader));
+
+    const size_t triangleCount = outHeader.indexCount / 3;
+
+    return outHeader.magic == MAGIC && outHeader.version == VERSION && outHeader.indexCount % 3 == 0 &&
+           (outHeader.rotationSize == 0 || outHeader.rotationSize == (triangleCount + 3) / 4) &&
+           size >= sizeof(EncodedIndexHeader) + size_t(outHeader.streamSize) + outHeader.rotationSize;
+}
+
+bool IndexCodec::Decode(const uint8_t* data, const size_t size, uint32_t* outIndices, const bool restoreRotation)
+{
+    EncodedIndexHeader header;
+
+    if (!ReadHeader(data, size, header))
+    {
+        return false;
+    }
+
+    const uint8_t* stream = data + sizeof(EncodedIndexHeader);
+
+    if (meshopt_decodeIndexBuffer(outIndices, header.indexCount, sizeof(uint32_t), stream, header.streamSize) != 0)
+    {
+        return false;
+    }
+
+    if (!restoreRotation || header.rotationSize == 0)
+    {
+        return true;
+    }
+
+    // --- Rotates every rotated triangle back to the right by its rotation.
+    const uint8_t* rotations = stream + header.streamSize;
+    const size_t triangleCount = header.indexCount / 3;
+
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const uint32_t rotation = (rotations[t / 4] >> ((t % 4) * 2)) & 3;
+
+        if (rotation == 0)
+        {
+            continue;
+        }
+
+        if (rotation == 3)
+        {
+            return false;
+        }
+
+        uint32_t* triangle = outIndices + t * 3;
+        const uint32_t rotatedTriangle[3] = {triangle[0], triangle[1], triangle[2]};
+
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            triangle[(i + rotation) % 3] = rotatedTriangle[i];
+        }
+    }
+
+    return true;
+}
+
+bool IndexCodec::Decode(const uint8_t* data, const size_t size, std::vector<uint32_t>& outIndices)
+{
+    EncodedIndexHeader header;
+
+    if (!ReadHeader(data, size, header))
+    {
+        return false;
+    }
+
+    outIndices.resize(header.indexCount);
+
+    return Decode(data, size, outIndices.data());
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Header in front of every encoded index buffer. All the sizes are in bytes.
+ */
+struct EncodedIndexHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t indexCount;
+    uint32_t vertexCount;
+
+    // Size of the triangle stream following the header.
+    uint32_t streamSize;
+
+    // Size of the rotation stream following the triangle stream, 0 if no triangle was rotated.
+    uint32_t rotationSize;
+};
+
+/**
+ * Compresses triangle lists for the binary geometry caches. The triangles are encoded by the index codec of
+ * meshoptimizer, which models the edge FIFO and the vertex FIFO of a post-transform cache, so a buffer ordered by
+ * Tipsify (or any other vertex cache optimizer) takes about 1-2 bytes per triangle.
+ *
+ * The codec of meshoptimizer may rotate the vertices of a triangle to hit the edge FIFO. The winding stays the same, so
+ * the rotated buffer renders the same, but the exact order is kept in a separate stream of 2 bits per triangle, so the
+ * decoded buffer is identical to the encoded one.
+ */
+class IndexCodec
+{
+  public:
+    // "VCIB" - Vulkan Core Index Buffer.
+    static constexpr uint32_t MAGIC = 0x42494356;
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Encodes the triangle list.
+     * @param indices - triangle list, indexCount has to be a multiple of 3
+     * @param vertexCount - number of the vertices referenced by the indices
+     * @return header, triangle stream and rotation stream in one block
+     */
+    static std::vector<uint8_t> Encode(const uint32_t* indices, const size_t indexCount, const size_t vertexCount);
+
+    static std::vector<uint8_t> Encode(const std::vector<uint32_t>& indices, const size_t vertexCount)
+    {
+        return Encode(indices.data(), indices.size(), vertexCount);
+    }
+
+    /**
+     * @brief Reads and validates the header of an encoded buffer, so the caller can size the destination.
+     * @return false if the data isn't an index buffer of this version, or if it is truncated.
+     */
+    static bool ReadHeader(const uint8_t* data, const size_t size, EncodedIndexHeader& outHeader);
+
+    /**
+     * @brief Decodes the buffer into the destination with the room for header.indexCount indices. The destination
+     * is written front to back, so it can be a mapped staging buffer (see the fill callback of
+     * VkCore::GeometryUploader::Upload).
+     * @param restoreRotation - undoes the rotation of the triangles. The rotation has to go back for the exact
+     * copy of the encoded buffer. It doesn't matter for rendering and restoring it reads back the destination, so
+     * leave it off when decoding into write combined memory.
+     * @return false if the data is corrupted.
+     */
+    static bool Decode(const uint8_t* data, const size_t size, uint32_t* outIndices,
+                       const bool restoreRotation = true);
+
+    static bool Decode(const uint8_t* data, const size_t size, std::vector<uint32_t>& outIndices);
+
+    static bool Decode(const std::vector<uint8_t>& data, std::vector<uint32_t>& outIndices)
+    {
+        return Decode(data.data(), data.size(), outIndices);
+    }
+};
@@ -0,0 +1,90 @@
+#include "LODGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Constants.h"
+#include "../ThreadUtils.h"
+#include "src/meshoptimizer.h"
+
+// A level has to have less than this fraction of the triangles of the previous one, otherwise the chain ends.
+static constexpr float MIN_LOD_REDUCTION = 0.95f;
+
+std::vector<GeneratedLOD> LODGenerator::Generate(const std::vector<uint32_t>& indices, const float* positions,
+                                                 const size_t positionStride, const float* attributes,
+                                                 const size_t vertexCount, const LODGenerationOptions& options,
+                                                 const uint32_t threadCount)
+{
+    ASSERT(options.levelCount <= Constants::MAX_LOD_LEVELS, "There are more LODs than supported!")
+    ASSERT(options.triangleRatio > 0.f && options.triangleRatio < 1.f, "The triangle ratio has to be in (0, 1)!")
+
+    if (options.levelCount <= 1 || indices.empty())
+    {
+        return {};
+    }
+
+    const float attributeWeights[ATTRIBUTE_COUNT] = {
+        options.normalWeight,   options.normalWeight,   options.normalWeight,
+        options.texCoordWeight, options.texCoordWeight,
+    };
+
+    const uint32_t simplifyOptions = options.lockBorder ? meshopt_SimplifyLockBorder : 0;
+    const float scale = meshopt_simplifyScale(positions, vertexCount, positionStride);
+
+    std::vector<GeneratedLOD> levels(options.levelCount - 1);
+
+    ThreadUtils::ParallelFor(levels.size(), threadCount, [&](const size_t index, const uint32_t) {
+        const size_t triangleCount = indices.size() / 3;
+        const size_t targetTriangleCount = triangleCount * std::pow(options.triangleRatio, index + 1);
+
+        GeneratedLOD& level = levels[index];
+        level.indices.resize(indices.size());
+
+        float error = 0.f;
+
+        const size_t indexCount = meshopt_simplifyWithAttributes(
+            level.indices.data(), indices.data(), indices.size(), positions, vertexCount, positionStride, attributes,
+            sizeof(float) * ATTRIBUTE_COUNT, attributeWeights, ATTRIBUTE_COUNT, nullptr, targetTriangleCount * 3,
+            options.maxError, simplifyOptions, &error);
+
+        level.indices.resize(indexCount);
+        level.indices.shrink_to_fit();
+        level.error = error * scale;
+    });
+
+    // --- Cuts the chain at the first level which didn't simplify enough and makes the errors monotonic, so the
+    // selection by the error never skips a level.
+    size_t previousIndexCount = indices.size();
+    float previousError = 0.f;
+
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        const size_t indexCount = levels[i].indices.size();
+
+        if (indexCount == 0 || indexCount >= previousIndexCount * MIN_LOD_REDUCTION)
+        {
+            levels.resize(i);
+            break;
+        }
+
+        levels[i].error = std::max(levels[i].error, previousError);
+
+        previousIndexCount = indexCount;
+        previousError = levels[i].error;
+    }
+
+    return levels;
+}
+
+uint32_t LODGenerator::SelectLevel(const float* errors, const uint32_t levelCount, const float distance,
+                                   const float errorThreshold)
+{
+    uint32_t level = 0;
+
+    while (level + 1 < levelCount && errors[level + 1] <= errorThreshold * distance)
+    {
+        level++;
+    }
+
+    return level;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Log/Log.h"
+#include "MeshBuildOptions.h"
+#include "MeshUtils.h"
+
+/**
+ * One simplified level of a mesh.
+ */
+struct GeneratedLOD
+{
+    // Triangles referencing the vertices of LOD0.
+    std::vector<uint32_t> indices;
+
+    // Achieved error in the units of the mesh. Never smaller than the error of the previous level.
+    float error = 0.f;
+};
+
+/**
+ * Builds a LOD chain from LOD0 with the quadric error metric of meshoptimizer. The normals and the texture
+ * coordinates are a weighted part of the error, so the simplification keeps the shading and the UV seams. Every level
+ * is simplified from LOD0 on its own thread, so the errors don't accumulate over the chain.
+ *
+ * The generator only works with the CPU data, so it can run both while loading a model and in an offline cook.
+ */
+class LODGenerator
+{
+  public:
+    // Normal (3) and texture coordinates (2).
+    static constexpr uint32_t ATTRIBUTE_COUNT = 5;
+
+    /**
+     * @brief Generates the levels 1 to options.levelCount - 1. The chain ends early if a level can't get
+     * noticeably simpler than the previous one within options.maxError.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     */
+    template <typename TVertex>
+    static std::vector<GeneratedLOD> Generate(const std::vector<uint32_t>& indices,
+                                              const std::vector<TVertex>& vertices,
+                                              const LODGenerationOptions& options, const uint32_t threadCount = 0)
+    {
+        if (vertices.empty())
+        {
+            return {};
+        }
+
+        std::vector<float> attributes(vertices.size() * ATTRIBUTE_COUNT);
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            float* attribute = attributes.data() + i * ATTRIBUTE_COUNT;
+
+            attribute[0] = vertices[i].Normal.x;
+            attribute[1] = vertices[i].Normal.y;
+            attribute[2] = vertices[i].Normal.z;
+            attribute[3] = vertices[i].TexCoords.x;
+            attribute[4] = vertices[i].TexCoords.y;
+        }
+
+        return Generate(indices, &vertices[0].Position.x, sizeof(TVertex), attributes.data(), vertices.size(),
+                        options, threadCount);
+    }
+
+    /**
+     * @param positions - 3 floats every positionStride bytes
+     * @param attributes - ATTRIBUTE_COUNT floats per vertex
+     */
+    static std::vector<GeneratedLOD> Generate(const std::vector<uint32_t>& indices, const float* positions,
+                                              const size_t positionStride, const float* attributes,
+                                              const size_t vertexCount, const LODGenerationOptions& options,
+                                              const uint32_t threadCount = 0);
+
+    /**
+     * @brief Appends the generated levels to the LODs holding only LOD0. Every level gets its own copy of the
+     * vertices it references.
+     * @param lods - LODData of LODModel or ClassicLODData of ClassicLODModel
+     */
+    template <typename TLODData>
+    static void AppendLevels(std::vector<TLODData>& lods, const LODGenerationOptions& options,
+                             const uint32_t threadCount = 0)
+    {
+        ASSERT(lods.size() == 1, "The LODs can only be generated from LOD0 alone!")
+
+        std::vector<GeneratedLOD> levels = Generate(lods[0].indices, lods[0].vertices, options, threadCount);
+
+        for (GeneratedLOD& level : levels)
+        {
+            TLODData lod;
+            lod.indices = std::move(level.indices);
+            lod.vertices = lods[0].vertices;
+            lod.error = level.error;
+
+            // Drops the vertices the level doesn't reference anymore.
+            MeshUtils::OptimizeVertexFetch(lod.indices, lod.vertices);
+
+            lods.emplace_back(std::move(lod));
+        }
+    }
+
+    /**
+     * @brief Picks the coarsest level whose error, divided by the distance from the camera, stays within the
+     * threshold (see ClusterLOD::ProjectError for the units).
+     * @param errors - error of every level, starting with LOD0
+     */
+    static uint32_t SelectLevel(const float* errors, const uint32_t levelCount, const float distance,
+                                const float errorThreshold);
+};
@@ -3,30 +3,49 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <immintrin.h>
+#include <initializer_list>
+#include <optional>
 
 #include "../Constants.h"
 #include "../Log/Log.h"
 #include "../Vk/Buffers/Buffer.h"
+#include "../Vk/Buffers/GeometryUploader.h"
 #include "../Vk/Descriptors/DescriptorBuilder.h"
 #include "../Vk/Devices/DeviceManager.h"
 #include "Mesh/LODModel.h"
 #include "Mesh/Meshlet.h"
+#include "Mesh/MeshletEncoding.h"
 #include "Mesh/MeshletGeneration.h"
+#include "Mesh/MeshletGrouping.h"
 #include "Mesh/MeshUtils.h"
+#include "Mesh/OverdrawOptimizer.h"
+#include "Mesh/VertexCacheOptimizer.h"
+#include "Mesh/VertexQuantization.h"
 #include "Meshlet.h"
 #include "vulkan/vulkan_enums.hpp"
 
-LODMesh::LODMesh(const std::vector<LODData>& lodData)
+LODMesh::LODMesh(std::vector<LODData>&& lodData, const MeshBuildOptions& options)
+    : LODMesh(Build(std::move(lodData), options).GetView(), nullptr, options.residency)
+{
+}
+
+MeshData LODMesh::Build(std::vector<LODData>&& lodData, const MeshBuildOptions& options)
 {
     ASSERT(lodData.size() <= 8, "There are more LODs than supported");
 
-    m_LodInfo.LodCount = lodData.size();
+    LODMeshInfo lodInfo;
+    lodInfo.LodCount = lodData.size();
 
-    std::vector<NewMeshlet> allMeshlets(0);
-    std::vector<uint32_t> allMeshletVertices(0);
-    std::vector<uint32_t> allMeshletTriangles(0);
+    // The arrays of every LOD, concatenated once all of them are built.
+    std::vector<std::vector<MeshVertex>> lodVertices(lodData.size());
+    std::vector<std::vector<NewMeshlet>> lodMeshlets(lodData.size());
+    std::vector<std::vector<uint32_t>> lodMeshletVertices(lodData.size());
+    std::vector<std::vector<uint32_t>> lodMeshletTriangles(lodData.size());
 
+    // Offset of the LOD in the concatenated vertices.
+    uint32_t accVertexBase = 0;
     // Accumulating vertex offset replaced in the meshlets. Offsets into the allmeshletVertices.
     uint32_t accVerticesOffset = 0;
     // Accumulating index offset replaced in the meshlets. Offsets into the allmeshletTriangle.
@@ -34,68 +53,152 @@ LODMesh::LODMesh(const std::vector<LODData>& lodData)
 
     uint32_t accLodMeshletOffset = 0;
 
+    // Shared by all the LODs, so the working memory of Tipsify is allocated only once.
+    TipsifyScratch tipsifyScratch;
+
     for (uint8_t i = 0; i < lodData.size(); i++)
     {
+        std::vector<uint32_t> tipsifiedIndices = VertexCacheOptimizer::Optimize(
+            options, lodData[i].indices, lodData[i].vertices.size(), tipsifyScratch);
 
-        std::vector<uint32_t> meshletVertices;
-        std::vector<uint32_t> meshletTriangles;
+        if (options.optimizeOverdraw)
+        {
+            tipsifiedIndices = OverdrawOptimizer::Optimize(tipsifiedIndices, lodData[i].vertices,
+                                                           options.vertexCacheSize, options.overdrawThreshold);
+        }
+
+        // Only the optimized order is used from now on.
+        std::vector<uint32_t>().swap(lodData[i].indices);
 
-        std::vector<uint32_t> tipsifiedIndices = MeshUtils::Tipsify(lodData[i].indices, lodData[i].vertices.size(), 32);
+        // The meshlets are built in the order of the indices, so their vertex references become mostly sequential.
+        lodVertices[i] = std::move(lodData[i].vertices);
+        MeshUtils::OptimizeVertexFetch(tipsifiedIndices, lodVertices[i]);
 
-        std::vector<NewMeshlet> meshlets = MeshletGeneration::MeshletizeNv(
-            Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, tipsifiedIndices,
-            lodData[i].vertices.size(), meshletVertices, meshletTriangles, accVerticesOffset, accTriangleOffset);
+        lodMeshlets[i] = MeshletGeneration::Meshletize(
+            options, Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, tipsifiedIndices,
+            lodVertices[i], lodMeshletVertices[i], lodMeshletTriangles[i], accVerticesOffset, accTriangleOffset);
 
-        for (uint32_t v = 0; v < meshletVertices.size(); v++)
+        for (uint32_t& vertex : lodMeshletVertices[i])
         {
-			allMeshletVertices.emplace_back(meshletVertices[v] += vertices.size());
+            vertex += accVertexBase;
         }
 
-        m_LodInfo.lodMeshletCount[i] = meshlets.size();
-        m_LodInfo.lodMeshletOffsets[i] = accLodMeshletOffset;
+        lodInfo.lodMeshletCount[i] = lodMeshlets[i].size();
+        lodInfo.lodMeshletOffsets[i] = accLodMeshletOffset;
+        lodInfo.lodErrors[i] = lodData[i].error;
 
-		for (uint32_t m = 0; m < meshlets.size(); m++) {
-			allMeshlets.emplace_back(meshlets[m]);
-		}
+        accLodMeshletOffset += lodMeshlets[i].size();
+        accVerticesOffset += lodMeshletVertices[i].size();
+        accTriangleOffset += lodMeshletTriangles[i].size();
+        accVertexBase += lodVertices[i].size();
+    }
 
-		for (uint32_t t = 0; t < meshletTriangles.size(); t++) {
-			allMeshletTriangles.emplace_back(meshletTriangles[t]);
-		}
+    std::vector<MeshVertex> vertices = MeshUtils::Concatenate(lodVertices);
+    std::vector<NewMeshlet> allMeshlets = MeshUtils::Concatenate(lodMeshlets);
+    std::vector<uint32_t> allMeshletVertices = MeshUtils::Concatenate(lodMeshletVertices);
+    std::vector<uint32_t> allMeshletTriangles = MeshUtils::Concatenate(lodMeshletTriangles);
 
-        accLodMeshletOffset += meshlets.size();
-        accVerticesOffset += meshletVertices.size();
-        accTriangleOffset += meshletTriangles.size();
-
-		for (uint32_t v = 0; v < lodData[i].vertices.size(); v++) {
-			vertices.emplace_back(lodData[i].vertices[v]);
-		}
-    }
+    // The bounds have to hold for the triangles the shaders decode.
+    const VertexQuantizationInfo quantization = VertexQuantization::QuantizePositions(options.vertexFormat, vertices);
 
     std::vector<MeshletBounds> meshletBounds =
-        MeshletGeneration::ComputeMeshletBounds(vertices, allMeshletVertices, allMeshlets);
+        MeshletGeneration::ComputeMeshletBounds(vertices, allMeshletVertices, allMeshletTriangles, allMeshlets);
 
     ASSERT(meshletBounds.size() == allMeshlets.size(),
            "Number of meshlet bounds doesn't match with the meshlets count!")
 
-    m_VertexBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_VertexBuffer.InitializeOnGpu(vertices.data(), vertices.size() * sizeof(MeshVertex));
+    // Every LOD is grouped on its own, so the LOD offsets of the meshlets stay valid.
+    std::vector<MeshletGroup> meshletGroups;
+
+    for (uint8_t i = 0; i < lodData.size(); i++)
+    {
+        lodInfo.lodGroupOffsets[i] = meshletGroups.size();
+
+        MeshletGrouping::SortIntoGroups(allMeshlets, meshletBounds, lodInfo.lodMeshletOffsets[i],
+                                        lodInfo.lodMeshletCount[i], meshletGroups);
+
+        lodInfo.lodGroupCount[i] = meshletGroups.size() - lodInfo.lodGroupOffsets[i];
+    }
+
+    MeshData data;
+    data.header = {
+        .meshletCount = static_cast<uint32_t>(allMeshlets.size()),
+        .meshletGroupCount = static_cast<uint32_t>(meshletGroups.size()),
+        .meshletEncoding = options.meshletEncoding,
+    };
 
-    m_MeshletVerticesBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletVerticesBuffer.InitializeOnGpu(allMeshletVertices.data(), allMeshletVertices.size() * sizeof(uint32_t));
+    VertexQuantization::SetVertices(data, options.vertexFormat, std::move(vertices), quantization);
+    data.Set(EMeshSection::MeshletBounds, std::move(meshletBounds));
+    data.Set(EMeshSection::MeshletGroups, std::move(meshletGroups));
+    data.Set(EMeshSection::LodInfo, &lodInfo, 1);
 
-    m_MeshletBoundsBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletBoundsBuffer.InitializeOnGpu(meshletBounds.data(), meshletBounds.size() * sizeof(MeshletBounds));
+    // The LOD offsets index the meshlets, so they stay the same for both of the encodings.
+    if (options.meshletEncoding == EMeshletEncoding::Compact)
+    {
+        CompactMeshletData compact = MeshletEncoding::Encode(allMeshlets, allMeshletVertices, allMeshletTriangles);
 
-    m_MeshletTrianglesBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletTrianglesBuffer.InitializeOnGpu(allMeshletTriangles.data(), allMeshletTriangles.size() * sizeof(uint32_t));
+        data.Set(EMeshSection::Meshlets, std::move(compact.meshlets));
+        data.Set(EMeshSection::MeshletVertices, std::move(compact.vertices));
+        data.Set(EMeshSection::MeshletTriangles, std::move(compact.triangles));
+    }
+    else
+    {
+        data.Set(EMeshSection::Meshlets, std::move(allMeshlets));
+        data.Set(EMeshSection::MeshletVertices, std::move(allMeshletVertices));
+        data.Set(EMeshSection::MeshletTriangles, std::move(allMeshletTriangles));
+    }
 
-    m_MeshletBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletBuffer.InitializeOnGpu(allMeshlets.data(), allMeshlets.size() * sizeof(NewMeshlet));
+    return data;
+}
+
+LODMesh::LODMesh(const MeshDataView& data, VkCore::GeometryUploader* uploader, const EMeshResidency residency)
+    : m_MeshletEncoding(data.header.meshletEncoding), m_VertexFormat(data.header.vertexFormat),
+      m_Residency(residency)
+{
+    ASSERT(data.GetSize(EMeshSection::LodInfo) == sizeof(LODMeshInfo), "The LOD info of the mesh is missing!")
+
+    std::memcpy(&m_LodInfo, data.GetData(EMeshSection::LodInfo), sizeof(LODMeshInfo));
+
+    // Decoded, if the vertices are quantized.
+    if (residency == EMeshResidency::KeepAll)
+    {
+        vertices = VertexQuantization::ReadVertices(data);
+    }
+    else if (residency == EMeshResidency::PositionsOnly)
+    {
+        VertexQuantization::ReadPositions(data, m_Positions);
+    }
+
+    // Only created if the caller didn't pass an uploader, waits for the upload in its destructor.
+    std::optional<VkCore::GeometryUploader> ownUploader;
+    VkCore::GeometryUploader& batch = uploader != nullptr ? *uploader : ownUploader.emplace();
+
+    // Uploaded straight from the view, which can point into a mapped cache file.
+    const auto upload = [&data, &batch](VkCore::Buffer& buffer, const EMeshSection section) {
+        buffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
+        batch.Upload(buffer, data.GetData(section), data.GetSize(section));
+    };
+
+    upload(m_MeshletGroupBuffer, EMeshSection::MeshletGroups);
+    upload(m_VertexBuffer, EMeshSection::Vertices);
+    upload(m_MeshletBoundsBuffer, EMeshSection::MeshletBounds);
+    upload(m_MeshletVerticesBuffer, EMeshSection::MeshletVertices);
+    upload(m_MeshletTrianglesBuffer, EMeshSection::MeshletTriangles);
+    upload(m_MeshletBuffer, EMeshSection::Meshlets);
 
     VkCore::DescriptorBuilder descBuilder = VkCore::DescriptorBuilder(VkCore::DeviceManager::GetDevice());
 
-    m_LodBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_LodBuffer.InitializeOnGpu(&m_LodInfo, sizeof(LODMeshInfo));
+    // From the view, the mesh itself can be moved before the upload is submitted.
+    upload(m_LodBuffer, EMeshSection::LodInfo);
+
+    if (data.header.vertexFormat == EVertexFormat::Quantized)
+    {
+        upload(m_VertexQuantizationBuffer, EMeshSection::VertexQuantization);
+
+        descBuilder.BindBuffer(7, m_VertexQuantizationBuffer, vk::DescriptorType::eStorageBuffer,
+                               vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT |
+                                   vk::ShaderStageFlagBits::eVertex);
+    }
 
     bool success = descBuilder
                        .BindBuffer(0, m_VertexBuffer, vk::DescriptorType::eStorageBuffer,
@@ -112,7 +215,65 @@ LODMesh::LODMesh(const std::vector<LODData>& lodData)
                        .BindBuffer(5, m_LodBuffer, vk::DescriptorType::eStorageBuffer,
                                    vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT |
                                        vk::ShaderStageFlagBits::eVertex)
+                       .BindBuffer(6, m_MeshletGroupBuffer, vk::DescriptorType::eStorageBuffer,
+                                   vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT)
                        .Build(m_DescriptorSet, m_DescriptorSetLayout);
 
     ASSERT(success, "Failed to build a descriptor set for a mesh!")
+
+    if (ownUploader.has_value())
+    {
+        ownUploader->Submit();
+    }
+}
+
+void LODMesh::SetResidency(const EMeshResidency residency)
+{
+    ASSERT(residency >= m_Residency, "The freed geometry of a mesh can't be restored!")
+
+    if (residency <= m_Residency)
+    {
+        return;
+    }
+
+    if (residency == EMeshResidency::PositionsOnly)
+    {
+        m_Positions.Assign(vertices.data(), vertices.size());
+    }
+    else
+    {
+        m_Positions.Clear();
+    }
+
+    std::vector<MeshVertex>().swap(vertices);
+    m_Residency = residency;
+}
+
+MeshMemoryStats LODMesh::GetMemoryStats() const
+{
+    MeshMemoryStats stats;
+    stats.cpuVertexBytes = vertices.capacity() * sizeof(MeshVertex);
+    stats.cpuPositionBytes = m_Positions.GetSizeInBytes();
+
+    for (const VkCore::Buffer* buffer : {&m_VertexBuffer, &m_MeshletVerticesBuffer, &m_MeshletTrianglesBuffer,
+                                         &m_MeshletBuffer, &m_MeshletBoundsBuffer, &m_LodBuffer,
+                                         &m_MeshletGroupBuffer, &m_VertexQuantizationBuffer})
+    {
+        stats.gpuBytes += buffer->GetSize();
+    }
+
+    return stats;
+}
+
+AABB LODMesh::CreateBoundingBox(const LODMesh& mesh)
+{
+    ASSERT(mesh.m_Residency != EMeshResidency::Release,
+           "The geometry of the mesh was released, can't compute its bounding box!")
+
+    if (mesh.m_Residency == EMeshResidency::PositionsOnly)
+    {
+        return MeshUtils::CreateBoundingBox(mesh.m_Positions);
+    }
+
+    return MeshUtils::CreateBoundingBox(mesh.vertices);
 }
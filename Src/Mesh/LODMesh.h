@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Mesh/MeshBuildOptions.h"
+#include "Mesh/MeshData.h"
+#include "Mesh/MeshResidency.h"
 #include "Mesh/MeshVertex.h"
 #include "Model/Structures/AABB.h"
 #include "Vk/Buffers/Buffer.h"
@@ -15,13 +18,48 @@ struct LODMeshInfo
         0, 0, 0, 0, 0, 0, 0, 0,
     };
     alignas(16) uint32_t LodCount = 0;
+    // Meshlet groups (binding 6) of every LOD, see MeshletGrouping.
+    uint32_t lodGroupCount[8] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+    };
+    uint32_t lodGroupOffsets[8] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+    };
+    // Error of every LOD in the units of the mesh (see LODGenerator::SelectLevel), 0 for the loaded LODs.
+    float lodErrors[8] = {
+        0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+    };
 };
 
+namespace VkCore
+{
+    class GeometryUploader;
+}
+
 struct LODData;
 class LODMesh
 {
   public:
-    LODMesh(const std::vector<LODData>& lodData);
+    /**
+     * @param lodData - consumed, the vertices are moved into the mesh.
+     */
+    LODMesh(std::vector<LODData>&& lodData, const MeshBuildOptions& options = {});
+
+    /**
+     * @brief Uploads a mesh built by Build, or loaded from the MeshCache.
+     * @param uploader - records the uploads into the batch of the uploader, the data of the view has to stay valid
+     * until it is submitted. If null, the mesh is uploaded in a batch of its own and waited for.
+     * @param residency - what stays on the CPU. Only that is copied out of the view.
+     */
+    LODMesh(const MeshDataView& data, VkCore::GeometryUploader* uploader = nullptr,
+            const EMeshResidency residency = EMeshResidency::KeepAll);
+
+    /**
+     * @brief Runs the CPU side of the pipeline for every LOD and merges the LODs into one set of buffers. Doesn't
+     * touch the GPU.
+     * @param lodData - consumed, the vertices of every LOD are moved instead of copied.
+     */
+    static MeshData Build(std::vector<LODData>&& lodData, const MeshBuildOptions& options = {});
 
     vk::DescriptorSet GetDescriptorSet() const
     {
@@ -35,23 +73,62 @@ class LODMesh
     {
         return m_LodInfo;
     }
+    /**
+     * @brief Layout of the meshlet buffers (bindings 1 - 3). The shaders have to match it.
+     */
+    EMeshletEncoding GetMeshletEncoding() const
+    {
+        return m_MeshletEncoding;
+    }
+    /**
+     * @brief Layout of the vertex buffer (binding 0). With EVertexFormat::Quantized the VertexQuantizationInfo is
+     * bound to 7.
+     */
+    EVertexFormat GetVertexFormat() const
+    {
+        return m_VertexFormat;
+    }
 
     void Destroy()
     {
         m_VertexBuffer.Destroy();
         m_MeshletVerticesBuffer.Destroy();
-        m_MeshletVerticesBuffer.Destroy();
+        m_MeshletTrianglesBuffer.Destroy();
         m_MeshletBuffer.Destroy();
         m_MeshletBoundsBuffer.Destroy();
         m_LodBuffer.Destroy();
+        m_MeshletGroupBuffer.Destroy();
+        m_VertexQuantizationBuffer.Destroy();
+    }
+
+    /**
+     * @brief Frees the CPU side of the geometry which isn't needed by the residency. The freed data can't be
+     * restored, so a mesh can only go from KeepAll to PositionsOnly to Release.
+     */
+    void SetResidency(const EMeshResidency residency);
+
+    EMeshResidency GetResidency() const
+    {
+        return m_Residency;
     }
 
+    MeshMemoryStats GetMemoryStats() const;
+
+    /**
+     * @brief Bounding box of the vertices of all the LODs. Doesn't work with EMeshResidency::Release.
+     */
     static AABB CreateBoundingBox(const LODMesh& mesh);
 
+    // Kept only with EMeshResidency::KeepAll.
     std::vector<MeshVertex> vertices;
 
   private:
     LODMeshInfo m_LodInfo;
+    EMeshletEncoding m_MeshletEncoding = EMeshletEncoding::Uint32;
+    EVertexFormat m_VertexFormat = EVertexFormat::Full;
+
+    EMeshResidency m_Residency = EMeshResidency::KeepAll;
+    MeshPositions m_Positions;
 
     VkCore::Buffer m_VertexBuffer;
     VkCore::Buffer m_MeshletVerticesBuffer;
@@ -59,6 +136,8 @@ class LODMesh
     VkCore::Buffer m_MeshletBuffer;
     VkCore::Buffer m_MeshletBoundsBuffer;
     VkCore::Buffer m_LodBuffer;
+    VkCore::Buffer m_MeshletGroupBuffer;
+    VkCore::Buffer m_VertexQuantizationBuffer;
 
     vk::DescriptorSet m_DescriptorSet;
     vk::DescriptorSetLayout m_DescriptorSetLayout;
@@ -7,15 +7,23 @@
 #include <filesystem>
 
 #include "../Log/Log.h"
+#include "../MemoryStats.h"
+#include "../ThreadUtils.h"
+#include "../Vk/Buffers/GeometryUploader.h"
+#include "LODGenerator.h"
+#include "MeshCache.h"
+#include "MeshUtils.h"
 #include "Mesh/LODMesh.h"
 #include "MeshVertex.h"
+#include "VertexWelder.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
 namespace fs = std::filesystem;
 
-LODModel::LODModel(const std::string& filePath)
+LODModel::LODModel(const std::string& filePath, const MeshBuildOptions& options,
+                   VkCore::GeometryUploader* uploader)
 {
 
     fs::path modelPath(filePath);
@@ -51,24 +59,64 @@ LODModel::LODModel(const std::string& filePath)
         }
     }
 
+    // Without any *_lodN files the model itself is LOD0 of the generated chain.
+    if (lodModelPaths.empty() && options.lodGeneration.levelCount > 1)
+    {
+        lodModelPaths.emplace_back(modelPath);
+    }
+
     ASSERT(lodModelPaths.size() <= 8, "There are more LODs than supported!");
 
     std::sort(lodModelPaths.begin(), lodModelPaths.end());
 
-	m_LodData.resize(lodModelPaths.size());
+    std::vector<std::string> sourcePaths;
 
-    for (uint8_t i = 0; i < lodModelPaths.size(); i++)
+    for (const fs::path& path : lodModelPaths)
     {
+        sourcePaths.emplace_back(path.string());
+    }
+
+    // Waits for the upload in its destructor, if the caller didn't pass an uploader.
+    VkCore::GeometryUploader ownUploader;
+    VkCore::GeometryUploader& batch = uploader != nullptr ? *uploader : ownUploader;
+
+    MeshCache cache(EMeshCacheKind::LODModel, sourcePaths, options);
+
+    if (cache.Load())
+    {
+        for (size_t i = 0; i < cache.GetMeshCount(); i++)
+        {
+            m_Meshes.emplace_back(cache.GetMesh(i), &batch, options.residency);
+        }
+
+        // Submitted before the cache file is unmapped.
+        m_UploadValue = batch.Submit();
+        return;
+    }
+
+	m_LodData.resize(lodModelPaths.size());
+
+    // The welding and the normals are done by us after the import, if enabled.
+    m_ImportOptions = options.meshImport;
+
+    const unsigned int flags = aiProcess_Triangulate |
+                               (m_ImportOptions.generateNormals ? 0 : aiProcess_GenNormals) |
+                               (m_ImportOptions.weldVertices ? 0 : aiProcess_JoinIdenticalVertices);
+
+    // --- Every LOD file is imported on its own thread with its own importer, an importer isn't thread safe. The
+    // paths are sorted, so the largest LOD0 is picked up first and the load takes about as long as the largest file.
+    ThreadUtils::ParallelFor(lodModelPaths.size(), 0, [&](const size_t index, const uint32_t) {
         Assimp::Importer importer;
 
-        const aiScene* scene = importer.ReadFile(
-            lodModelPaths[i].string(), aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_JoinIdenticalVertices);
+        const aiScene* scene = importer.ReadFile(lodModelPaths[index].string(), flags);
 
         ASSERTF(scene != nullptr && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode != nullptr,
                 "Failed to import a scene! %s", importer.GetErrorString())
 
-        ProcessNode(scene->mRootNode, scene, i);
-    }
+        ProcessNode(scene->mRootNode, scene, index);
+    });
+
+    MemoryStats::EndStage("LODModel: import");
 
 
     ASSERT(m_LodData.size() > 0 && m_LodData.size() == lodModelPaths.size(), "There are not that many or no lod scenes to process!");
@@ -81,6 +129,9 @@ LODModel::LODModel(const std::string& filePath)
         ASSERT(expectedSize == m_LodData[i].size(), "The amount of LOD Data structs don't match ");
     }
 
+    std::vector<MeshData> meshes;
+    meshes.reserve(expectedSize);
+
     for (uint32_t i = 0; i < expectedSize; i++)
     {
 
@@ -91,8 +142,32 @@ LODModel::LODModel(const std::string& filePath)
             meshLods.emplace_back(std::move(m_LodData[meshIndex][i]));
         }
 
-        m_Meshes.emplace_back(meshLods);
+        if (meshLods.size() == 1 && options.lodGeneration.levelCount > 1)
+        {
+            LODGenerator::AppendLevels(meshLods, options.lodGeneration);
+        }
+
+        meshes.emplace_back(LODMesh::Build(std::move(meshLods), options));
     }
+
+    // Every LOD was moved into its mesh, only the emptied vectors are left.
+    std::vector<std::vector<LODData>>().swap(m_LodData);
+
+    MemoryStats::EndStage("LODModel: build");
+
+    cache.Store(meshes);
+
+    MemoryStats::EndStage("LODModel: cache store");
+
+    for (const MeshData& meshData : meshes)
+    {
+        m_Meshes.emplace_back(meshData.GetView(), &batch, options.residency);
+    }
+
+    // All the meshes in one submission, before their data is freed.
+    m_UploadValue = batch.Submit();
+
+    MemoryStats::EndStage("LODModel: upload");
 }
 
 void LODModel::ProcessNode(const aiNode* node, const aiScene* scene, const uint32_t lodDataIndex)
@@ -122,6 +197,18 @@ LODMesh& LODModel::GetMesh(const size_t index)
     return m_Meshes.at(index);
 }
 
+MeshMemoryStats LODModel::GetMemoryStats() const
+{
+    MeshMemoryStats stats;
+
+    for (const LODMesh& mesh : m_Meshes)
+    {
+        stats += mesh.GetMemoryStats();
+    }
+
+    return stats;
+}
+
 vk::DescriptorSetLayout LODModel::GetMeshSetLayout(const size_t index)
 {
     return m_Meshes.at(index).GetDescriptorSetLayout();
@@ -132,14 +219,10 @@ vk::DescriptorSet LODModel::GetMeshSet(const size_t index)
     return m_Meshes.at(index).GetDescriptorSet();
 }
 
-LODData LODModel::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
+LODData LODModel::ProcessMesh(const aiMesh* mesh, const aiScene* scene) const
 {
-
-    if (mesh == nullptr)
-    {
-        LOG(Assimp, Fatal, "Failed to process a mesh! aiMesh is null!")
-        throw std::runtime_error("Failed to process a mesh! aiMesh is null!");
-    }
+    // Runs on the import threads, an exception couldn't leave them.
+    ASSERT(mesh != nullptr, "Failed to process a mesh! aiMesh is null!")
 
     std::vector<MeshVertex> meshVertices{};
     meshVertices.reserve(mesh->mNumVertices);
@@ -154,9 +237,10 @@ LODData LODModel::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
             normals = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
         }
 
-        glm::vec2 textureCoord;
-        glm::vec3 tangent;
-        glm::vec3 biTangent;
+        // Zeroed, so the missing attributes don't keep the vertices from being welded.
+        glm::vec2 textureCoord(0.f);
+        glm::vec3 tangent(0.f);
+        glm::vec3 biTangent(0.f);
 
         if (mesh->mTextureCoords[0] != nullptr)
         {
@@ -176,6 +260,8 @@ LODData LODModel::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
     }
 
     std::vector<uint32_t> indices;
+    // Triangulated by the import.
+    indices.reserve(size_t(mesh->mNumFaces) * 3);
 
     for (uint32_t i = 0; i < mesh->mNumFaces; i++)
     {
@@ -188,5 +274,16 @@ LODData LODModel::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
         }
     }
 
-    return {.indices = indices, .vertices = meshVertices};
+    if (m_ImportOptions.weldVertices)
+    {
+        VertexWelder::Weld(indices, meshVertices, m_ImportOptions.weldPositionEpsilon,
+                           m_ImportOptions.weldAttributeEpsilon);
+    }
+
+    if (m_ImportOptions.generateNormals && !mesh->HasNormals())
+    {
+        MeshUtils::GenerateNormals(indices, meshVertices);
+    }
+
+    return {.indices = std::move(indices), .vertices = std::move(meshVertices)};
 }
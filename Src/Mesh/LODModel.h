@@ -12,6 +12,8 @@ struct LODData
 {
     std::vector<uint32_t> indices;
     std::vector<MeshVertex> vertices;
+    // Error of the level in the units of the mesh, if it was generated by LODGenerator. 0 for the loaded LODs.
+    float error = 0.f;
 };
 
 class LODModel
@@ -19,7 +21,14 @@ class LODModel
 
   public:
     LODModel() = default;
-    LODModel(const std::string& filePath);
+    /**
+     * @brief Imports the *_lodN files next to the model concurrently, each with its own importer.
+     * @param options - applied to every mesh of the model.
+     * @param uploader - the meshes are recorded into it and submitted in one batch at the end of the constructor,
+     * without waiting (see GetUploadValue). If null, the model uploads its meshes on its own and waits for them.
+     */
+    LODModel(const std::string& filePath, const MeshBuildOptions& options = {},
+             VkCore::GeometryUploader* uploader = nullptr);
 
     size_t GetMeshCount()
     {
@@ -27,6 +36,19 @@ class LODModel
     }
 
     LODMesh& GetMesh(const size_t index);
+
+    /**
+     * @brief Value of the submission with the meshes of the model in the uploader passed to the constructor.
+     */
+    uint64_t GetUploadValue() const
+    {
+        return m_UploadValue;
+    }
+    /**
+     * @brief Sums the memory held by all the meshes (see EMeshResidency).
+     */
+    MeshMemoryStats GetMemoryStats() const;
+
     vk::DescriptorSetLayout GetMeshSetLayout(const size_t index);
     vk::DescriptorSet GetMeshSet(const size_t index);
 
@@ -35,7 +57,14 @@ class LODModel
   private:
     std::vector<std::vector<LODData>> m_LodData = {};
     std::vector<LODMesh> m_Meshes = {};
+    uint64_t m_UploadValue = 0;
+
+    MeshImportOptions m_ImportOptions = {};
 
+    /**
+     * @brief Processes the meshes of the node and of its children into m_LodData[lodDataIndex]. Every LOD file has
+     * its own slot, so the files can be processed in parallel.
+     */
     void ProcessNode(const aiNode* node, const aiScene* scene, const uint32_t lodDataIndex);
-    LODData ProcessMesh(const aiMesh* mesh, const aiScene* scene);
+    LODData ProcessMesh(const aiMesh* mesh, const aiScene* scene) const;
 };
@@ -4,60 +4,220 @@
 #include <cmath>
 #include <cstdint>
 #include <immintrin.h>
+#include <initializer_list>
 #include <limits>
+#include <optional>
 
 #include "../Constants.h"
 #include "../Log/Log.h"
 #include "../Vk/Buffers/Buffer.h"
+#include "../Vk/Buffers/GeometryUploader.h"
 #include "../Vk/Descriptors/DescriptorBuilder.h"
 #include "../Vk/Devices/DeviceManager.h"
 #include "Mesh/Meshlet.h"
+#include "Mesh/ClusterLOD.h"
+#include "Mesh/IndexCodec.h"
+#include "Mesh/MeshletEncoding.h"
 #include "Mesh/MeshletGeneration.h"
+#include "Mesh/MeshletGrouping.h"
 #include "Mesh/MeshUtils.h"
+#include "Mesh/OverdrawOptimizer.h"
+#include "Mesh/VertexCacheOptimizer.h"
+#include "Mesh/VertexQuantization.h"
 #include "Meshlet.h"
 #include "vulkan/vulkan_enums.hpp"
 
-Mesh::Mesh(const std::vector<uint32_t>& indexBuffer, const std::vector<MeshVertex>& vertices)
-    : indices(indexBuffer), vertices(vertices)
+Mesh::Mesh(const std::vector<uint32_t>& indexBuffer, const std::vector<MeshVertex>& meshVertices,
+           const MeshBuildOptions& options)
+    : Mesh(Build(indexBuffer, meshVertices, options).GetView(), nullptr, options.residency)
 {
+}
 
-    m_VertexBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_VertexBuffer.InitializeOnGpu(vertices.data(), vertices.size() * sizeof(MeshVertex));
+MeshData Mesh::Build(const std::vector<uint32_t>& indexBuffer, const std::vector<MeshVertex>& meshVertices,
+                     const MeshBuildOptions& options)
+{
+    return Build(std::vector<uint32_t>(indexBuffer), std::vector<MeshVertex>(meshVertices), options);
+}
 
+MeshData Mesh::Build(std::vector<uint32_t>&& indexBuffer, std::vector<MeshVertex>&& meshVertices,
+                     const MeshBuildOptions& options)
+{
+    std::vector<MeshVertex> vertices = std::move(meshVertices);
     std::vector<uint32_t> meshletVertices;
     std::vector<uint32_t> meshletTriangles;
 
-    indices = MeshUtils::Tipsify(indices, vertices.size(), 32);
+    std::vector<uint32_t> indices = VertexCacheOptimizer::Optimize(options, indexBuffer, vertices.size());
+    std::vector<uint32_t>().swap(indexBuffer);
+
+    if (options.optimizeOverdraw)
+    {
+        indices = OverdrawOptimizer::Optimize(indices, vertices, options.vertexCacheSize, options.overdrawThreshold);
+    }
+
+    // The meshlets are built in the order of the indices, so their vertex references become mostly sequential.
+    MeshUtils::OptimizeVertexFetch(indices, vertices);
+
+    std::vector<NewMeshlet> meshlets;
+    std::vector<LODCluster> clusters;
+    std::vector<uint32_t> levelMeshletCounts;
 
-    std::vector<NewMeshlet> meshlets =
-        MeshletGeneration::MeshletizeNv(Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES, indices,
-                                        vertices.size(), meshletVertices, meshletTriangles);
+    if (options.buildClusterLod)
+    {
+        ClusterLODData clusterLod = ClusterLOD::Build(indices, vertices, options);
+
+        meshlets = std::move(clusterLod.meshlets);
+        meshletVertices = std::move(clusterLod.meshletVertices);
+        meshletTriangles = std::move(clusterLod.meshletTriangles);
+        clusters = std::move(clusterLod.clusters);
+        levelMeshletCounts = std::move(clusterLod.levelMeshletCounts);
+    }
+    else
+    {
+        meshlets =
+            MeshletGeneration::Meshletize(options, Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_INDICES,
+                                          indices, vertices, meshletVertices, meshletTriangles);
+    }
 
 	LOGF(Rendering, Verbose, "Number of meshlets: %d", meshlets.size())
 
-    meshletVertices.shrink_to_fit();
-    meshletTriangles.shrink_to_fit();
+    // The bounds have to hold for the triangles the shaders decode.
+    const VertexQuantizationInfo quantization = VertexQuantization::QuantizePositions(options.vertexFormat, vertices);
+
+    std::vector<MeshletBounds> meshletBounds =
+        MeshletGeneration::ComputeMeshletBounds(vertices, meshletVertices, meshletTriangles, meshlets);
+
+    std::vector<MeshletGroup> meshletGroups;
+
+    if (clusters.empty())
+    {
+        MeshletGrouping::SortIntoGroups(meshlets, meshletBounds, 0, meshlets.size(), meshletGroups);
+    }
+    else
+    {
+        // The groups don't cross the levels of the hierarchy and the clusters have to follow their meshlets.
+        size_t levelOffset = 0;
+
+        for (const uint32_t levelCount : levelMeshletCounts)
+        {
+            const std::vector<uint32_t> order =
+                MeshletGrouping::SortIntoGroups(meshlets, meshletBounds, levelOffset, levelCount, meshletGroups);
+
+            const std::vector<LODCluster> levelClusters(clusters.begin() + levelOffset,
+                                                        clusters.begin() + levelOffset + levelCount);
+
+            for (uint32_t i = 0; i < levelCount; i++)
+            {
+                clusters[levelOffset + i] = levelClusters[order[i]];
+            }
 
-    m_MeshletCount = meshlets.size();
+            levelOffset += levelCount;
+        }
+    }
+
+    MeshData data;
+    data.header = {
+        .meshletCount = static_cast<uint32_t>(meshlets.size()),
+        .meshletGroupCount = static_cast<uint32_t>(meshletGroups.size()),
+        .meshletEncoding = options.meshletEncoding,
+        .hasClusterLod = options.buildClusterLod,
+    };
+
+    // Every array is freed as soon as it is copied into the MeshData.
+    data.Set(EMeshSection::Indices, std::move(indices));
+    VertexQuantization::SetVertices(data, options.vertexFormat, std::move(vertices), quantization);
+    data.Set(EMeshSection::MeshletBounds, std::move(meshletBounds));
+    data.Set(EMeshSection::MeshletGroups, std::move(meshletGroups));
+    data.Set(EMeshSection::Clusters, std::move(clusters));
+
+    if (options.meshletEncoding == EMeshletEncoding::Compact)
+    {
+        CompactMeshletData compact = MeshletEncoding::Encode(meshlets, meshletVertices, meshletTriangles);
 
-    m_MeshletVerticesBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletVerticesBuffer.InitializeOnGpu(meshletVertices.data(), meshletVertices.size() * sizeof(uint32_t));
+        LOGF(Rendering, Verbose, "Compact meshlet encoding: %zu bytes instead of %zu", compact.GetSizeInBytes(),
+             meshlets.size() * sizeof(NewMeshlet) +
+                 (meshletVertices.size() + meshletTriangles.size()) * sizeof(uint32_t))
 
-	std::vector<MeshletBounds> meshletBounds = MeshletGeneration::ComputeMeshletBounds(vertices, meshletVertices, meshlets);
+        data.Set(EMeshSection::Meshlets, std::move(compact.meshlets));
+        data.Set(EMeshSection::MeshletVertices, std::move(compact.vertices));
+        data.Set(EMeshSection::MeshletTriangles, std::move(compact.triangles));
+    }
+    else
+    {
+        data.Set(EMeshSection::Meshlets, std::move(meshlets));
+        data.Set(EMeshSection::MeshletVertices, std::move(meshletVertices));
+        data.Set(EMeshSection::MeshletTriangles, std::move(meshletTriangles));
+    }
 
-    m_MeshletBoundsBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletBoundsBuffer.InitializeOnGpu(meshletBounds.data(), meshletBounds.size() * sizeof(MeshletBounds));
+    return data;
+}
 
+Mesh::Mesh(const MeshDataView& data, VkCore::GeometryUploader* uploader, const EMeshResidency residency)
+    : m_MeshletCount(data.header.meshletCount), m_MeshletGroupCount(data.header.meshletGroupCount),
+      m_MeshletEncoding(data.header.meshletEncoding), m_HasClusterLod(data.header.hasClusterLod),
+      m_VertexFormat(data.header.vertexFormat), m_Residency(residency)
+{
+    if (residency == EMeshResidency::Release)
+    {
+        // Nothing to keep.
+    }
+    else if (data.header.indicesEncoded)
+    {
+        const bool decoded = IndexCodec::Decode(data.Get<uint8_t>(EMeshSection::Indices),
+                                                data.GetSize(EMeshSection::Indices), indices);
+
+        ASSERT(decoded, "Failed to decode the indices of a mesh!")
+    }
+    else
+    {
+        indices = data.Copy<uint32_t>(EMeshSection::Indices);
+    }
+
+    // Decoded, if the vertices are quantized.
+    if (residency == EMeshResidency::KeepAll)
+    {
+        vertices = VertexQuantization::ReadVertices(data);
+    }
+    else if (residency == EMeshResidency::PositionsOnly)
+    {
+        VertexQuantization::ReadPositions(data, m_Positions);
+    }
 
+    // Only created if the caller didn't pass an uploader, waits for the upload in its destructor.
+    std::optional<VkCore::GeometryUploader> ownUploader;
+    VkCore::GeometryUploader& batch = uploader != nullptr ? *uploader : ownUploader.emplace();
 
-    m_MeshletTrianglesBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletTrianglesBuffer.InitializeOnGpu(meshletTriangles.data(), meshletTriangles.size() * sizeof(uint32_t));
+    // Uploaded straight from the view, which can point into a mapped cache file.
+    const auto upload = [&data, &batch](VkCore::Buffer& buffer, const EMeshSection section) {
+        buffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
+        batch.Upload(buffer, data.GetData(section), data.GetSize(section));
+    };
 
-    m_MeshletBuffer = VkCore::Buffer(vk::BufferUsageFlagBits::eStorageBuffer);
-    m_MeshletBuffer.InitializeOnGpu(meshlets.data(), meshlets.size() * sizeof(NewMeshlet));
+    upload(m_VertexBuffer, EMeshSection::Vertices);
+    upload(m_MeshletGroupBuffer, EMeshSection::MeshletGroups);
+    upload(m_MeshletBoundsBuffer, EMeshSection::MeshletBounds);
+    upload(m_MeshletVerticesBuffer, EMeshSection::MeshletVertices);
+    upload(m_MeshletTrianglesBuffer, EMeshSection::MeshletTriangles);
+    upload(m_MeshletBuffer, EMeshSection::Meshlets);
 
     VkCore::DescriptorBuilder descBuilder = VkCore::DescriptorBuilder(VkCore::DeviceManager::GetDevice());
 
+    if (data.GetSize(EMeshSection::Clusters) > 0)
+    {
+        upload(m_ClusterBuffer, EMeshSection::Clusters);
+
+        descBuilder.BindBuffer(5, m_ClusterBuffer, vk::DescriptorType::eStorageBuffer,
+                               vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT);
+    }
+
+    if (data.header.vertexFormat == EVertexFormat::Quantized)
+    {
+        upload(m_VertexQuantizationBuffer, EMeshSection::VertexQuantization);
+
+        descBuilder.BindBuffer(7, m_VertexQuantizationBuffer, vk::DescriptorType::eStorageBuffer,
+                               vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT |
+                                   vk::ShaderStageFlagBits::eVertex);
+    }
+
     bool success = descBuilder
                        .BindBuffer(0, m_VertexBuffer, vk::DescriptorType::eStorageBuffer,
                                    vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT)
@@ -69,14 +229,68 @@ Mesh::Mesh(const std::vector<uint32_t>& indexBuffer, const std::vector<MeshVerte
                                    vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT)
                        .BindBuffer(4, m_MeshletBoundsBuffer, vk::DescriptorType::eStorageBuffer,
                                    vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eVertex)
+                       .BindBuffer(6, m_MeshletGroupBuffer, vk::DescriptorType::eStorageBuffer,
+                                   vk::ShaderStageFlagBits::eMeshNV | vk::ShaderStageFlagBits::eTaskEXT)
                        .Build(m_DescriptorSet, m_DescriptorSetLayout);
 
     ASSERT(success, "Failed to build a descriptor set for a mesh!")
+
+    if (ownUploader.has_value())
+    {
+        ownUploader->Submit();
+    }
+}
+
+
+void Mesh::SetResidency(const EMeshResidency residency)
+{
+    ASSERT(residency >= m_Residency, "The freed geometry of a mesh can't be restored!")
+
+    if (residency <= m_Residency)
+    {
+        return;
+    }
+
+    if (residency == EMeshResidency::PositionsOnly)
+    {
+        m_Positions.Assign(vertices.data(), vertices.size());
+    }
+    else
+    {
+        m_Positions.Clear();
+        std::vector<uint32_t>().swap(indices);
+    }
+
+    std::vector<MeshVertex>().swap(vertices);
+    m_Residency = residency;
+}
+
+glm::vec3 Mesh::GetPosition(const uint32_t index) const
+{
+    return m_Residency == EMeshResidency::KeepAll ? vertices[index].Position : m_Positions.Get(index);
 }
 
+MeshMemoryStats Mesh::GetMemoryStats() const
+{
+    MeshMemoryStats stats;
+    stats.cpuIndexBytes = indices.capacity() * sizeof(uint32_t);
+    stats.cpuVertexBytes = vertices.capacity() * sizeof(MeshVertex);
+    stats.cpuPositionBytes = m_Positions.GetSizeInBytes();
+
+    for (const VkCore::Buffer* buffer : {&m_VertexBuffer, &m_MeshletVerticesBuffer, &m_MeshletTrianglesBuffer,
+                                         &m_MeshletBuffer, &m_MeshletBoundsBuffer, &m_ClusterBuffer,
+                                         &m_MeshletGroupBuffer, &m_VertexQuantizationBuffer})
+    {
+        stats.gpuBytes += buffer->GetSize();
+    }
+
+    return stats;
+}
 
 OcTreeTriangles Mesh::OcTreeMesh(const Mesh& mesh, const uint32_t capacity)
 {
+    ASSERT(mesh.m_Residency != EMeshResidency::Release,
+           "The geometry of the mesh was released, can't build an octree!")
 
     std::vector<IndexedTriangle> triangles;
     triangles.reserve(mesh.indices.size() / 3);
@@ -91,8 +305,8 @@ OcTreeTriangles Mesh::OcTreeMesh(const Mesh& mesh, const uint32_t capacity)
 
     for (size_t i = 0; i < mesh.indices.size() - 3; i += 3)
     {
-        triangles.emplace_back(mesh.vertices[mesh.indices[i]].Position, mesh.vertices[mesh.indices[i + 1]].Position,
-                               mesh.vertices[mesh.indices[i + 2]].Position, mesh.indices[i], mesh.indices[i + 1],
+        triangles.emplace_back(mesh.GetPosition(mesh.indices[i]), mesh.GetPosition(mesh.indices[i + 1]),
+                               mesh.GetPosition(mesh.indices[i + 2]), mesh.indices[i], mesh.indices[i + 1],
                                mesh.indices[i + 2]);
     }
 
@@ -108,62 +322,13 @@ OcTreeTriangles Mesh::OcTreeMesh(const Mesh& mesh, const uint32_t capacity)
 
 AABB Mesh::CreateBoundingBox(const Mesh& mesh)
 {
+    ASSERT(mesh.m_Residency != EMeshResidency::Release,
+           "The geometry of the mesh was released, can't compute its bounding box!")
 
-    __m256 maxPoint = _mm256_set_ps(0.f, 0.f, std::numeric_limits<float>::min(), std::numeric_limits<float>::min(),
-                                    std::numeric_limits<float>::min(), std::numeric_limits<float>::min(),
-                                    std::numeric_limits<float>::min(), std::numeric_limits<float>::min());
-
-    __m256 minPoint = _mm256_set_ps(0.f, 0.f, std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
-                                    std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
-                                    std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-
-    size_t i = 0;
-
-    while (i < (mesh.vertices.size()) - 2)
+    if (mesh.m_Residency == EMeshResidency::PositionsOnly)
     {
-        // clang-format off
-        __m256 temp = _mm256_set_ps(0.f,
-									0.f,
-									mesh.vertices[i + 1].Position.z,
-									mesh.vertices[i + 1].Position.y,
-                                    mesh.vertices[i + 1].Position.x,
-									mesh.vertices[i].Position.z,
-                                    mesh.vertices[i].Position.y,
-									mesh.vertices[i].Position.x);
-        // clang-format on
-
-        maxPoint = _mm256_max_ps(maxPoint, temp);
-        minPoint = _mm256_min_ps(minPoint, temp);
-
-        i += 2;
+        return MeshUtils::CreateBoundingBox(mesh.m_Positions);
     }
 
-    if ((mesh.vertices.size() - i) == 1)
-    {
-        // clang-format off
-        __m256 temp = _mm256_set_ps(0.f, 
-									0.f,
-									mesh.vertices[i].Position.z,
-									mesh.vertices[i].Position.y,
-                                    mesh.vertices[i].Position.x,
-									mesh.vertices[i].Position.z,
-                                    mesh.vertices[i].Position.y,
-									mesh.vertices[i].Position.x);
-        // clang-format on
-
-        maxPoint = _mm256_max_ps(maxPoint, temp);
-        minPoint = _mm256_min_ps(minPoint, temp);
-
-        LOG(Rendering, Verbose, "Found 1 remaining triangles to meshletize")
-    }
-
-    __m128 finalMaxPoint = _mm_max_ps(_mm_set_ps(0.f, maxPoint[2], maxPoint[1], maxPoint[0]),
-                                      _mm_set_ps(0.f, maxPoint[5], maxPoint[4], maxPoint[3]));
-    __m128 finalMinPoint = _mm_max_ps(_mm_set_ps(0.f, minPoint[2], minPoint[1], minPoint[0]),
-                                      _mm_set_ps(0.f, minPoint[5], minPoint[4], minPoint[3]));
-
-    return {
-        .minPoint = {finalMinPoint[0], finalMinPoint[1], finalMinPoint[2]},
-        .maxPoint = {finalMaxPoint[0], finalMaxPoint[1], finalMaxPoint[2]},
-    };
+    return MeshUtils::CreateBoundingBox(mesh.vertices);
 }
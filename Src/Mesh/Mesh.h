@@ -4,14 +4,46 @@
 #include <vector>
 
 #include "../Vk/Buffers/Buffer.h"
+#include "Mesh/MeshBuildOptions.h"
+#include "Mesh/MeshData.h"
+#include "Mesh/MeshResidency.h"
 #include "Mesh/Meshlet.h"
 #include "MeshVertex.h"
 #include "Model/Structures/OcTree.h"
 
+namespace VkCore
+{
+    class GeometryUploader;
+}
+
 class Mesh
 {
   public:
-    Mesh(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices);
+    Mesh(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+         const MeshBuildOptions& options = {});
+
+    /**
+     * @brief Uploads a mesh built by Build, or loaded from the MeshCache.
+     * @param uploader - records the uploads into the batch of the uploader, the data of the view has to stay valid
+     * until it is submitted. If null, the mesh is uploaded in a batch of its own and waited for.
+     * @param residency - what stays on the CPU. Only that is copied out of the view.
+     */
+    Mesh(const MeshDataView& data, VkCore::GeometryUploader* uploader = nullptr,
+         const EMeshResidency residency = EMeshResidency::KeepAll);
+
+    /**
+     * @brief Runs the CPU side of the pipeline - the vertex cache and fetch optimizations, the meshletization (or
+     * the cluster LOD), the bounds and the grouping. Doesn't touch the GPU.
+     */
+    static MeshData Build(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+                          const MeshBuildOptions& options = {});
+
+    /**
+     * @brief Same as the other Build, but it works in the given buffers instead of in copies of them and frees every
+     * intermediate array as soon as it is not needed, so a large mesh doesn't exist several times in memory.
+     */
+    static MeshData Build(std::vector<uint32_t>&& indices, std::vector<MeshVertex>&& vertices,
+                          const MeshBuildOptions& options = {});
 
     vk::DescriptorSet GetDescriptorSet() const
     {
@@ -25,30 +57,96 @@ class Mesh
     {
         return m_MeshletCount;
     }
+    /**
+     * @brief Number of the meshlet groups bound to 6, one task shader workgroup per group (see MeshletGrouping).
+     */
+    uint32_t GetMeshletGroupCount() const
+    {
+        return m_MeshletGroupCount;
+    }
+    /**
+     * @brief Layout of the meshlet buffers (bindings 1 - 3). The shaders have to match it.
+     */
+    EMeshletEncoding GetMeshletEncoding() const
+    {
+        return m_MeshletEncoding;
+    }
+    /**
+     * @brief True if the meshlets form a cluster LOD hierarchy. The LODCluster of every meshlet is bound to 5.
+     */
+    bool HasClusterLod() const
+    {
+        return m_HasClusterLod;
+    }
+    /**
+     * @brief Layout of the vertex buffer (binding 0). With EVertexFormat::Quantized the VertexQuantizationInfo is
+     * bound to 7.
+     */
+    EVertexFormat GetVertexFormat() const
+    {
+        return m_VertexFormat;
+    }
 
     void Destroy()
     {
         m_VertexBuffer.Destroy();
         m_MeshletVerticesBuffer.Destroy();
-        m_MeshletVerticesBuffer.Destroy();
+        m_MeshletTrianglesBuffer.Destroy();
         m_MeshletBuffer.Destroy();
         m_MeshletBoundsBuffer.Destroy();
+        m_ClusterBuffer.Destroy();
+        m_MeshletGroupBuffer.Destroy();
+        m_VertexQuantizationBuffer.Destroy();
+    }
+
+    /**
+     * @brief Frees the CPU side of the geometry which isn't needed by the residency. The freed data can't be
+     * restored, so a mesh can only go from KeepAll to PositionsOnly to Release.
+     */
+    void SetResidency(const EMeshResidency residency);
+
+    EMeshResidency GetResidency() const
+    {
+        return m_Residency;
     }
 
+    /**
+     * @brief Returns the position of the vertex from the vertices or from the kept positions. Not available with
+     * EMeshResidency::Release.
+     */
+    glm::vec3 GetPosition(const uint32_t index) const;
+
+    MeshMemoryStats GetMemoryStats() const;
+
+    /**
+     * @brief Both need the positions, so they don't work with EMeshResidency::Release.
+     */
     static OcTreeTriangles OcTreeMesh(const Mesh& mesh, const uint32_t capacity);
     static AABB CreateBoundingBox(const Mesh& mesh);
 
+    // Reordered by the first use in the optimized indices (see MeshUtils::OptimizeVertexFetch). The vertices are
+    // kept only with EMeshResidency::KeepAll, the indices with PositionsOnly too.
     std::vector<uint32_t> indices;
-    const std::vector<MeshVertex> vertices;
+    std::vector<MeshVertex> vertices;
 
   private:
     uint32_t m_MeshletCount = 0;
+    uint32_t m_MeshletGroupCount = 0;
+    EMeshletEncoding m_MeshletEncoding = EMeshletEncoding::Uint32;
+    bool m_HasClusterLod = false;
+    EVertexFormat m_VertexFormat = EVertexFormat::Full;
+
+    EMeshResidency m_Residency = EMeshResidency::KeepAll;
+    MeshPositions m_Positions;
 
     VkCore::Buffer m_VertexBuffer;
     VkCore::Buffer m_MeshletVerticesBuffer;
     VkCore::Buffer m_MeshletTrianglesBuffer;
     VkCore::Buffer m_MeshletBuffer;
     VkCore::Buffer m_MeshletBoundsBuffer;
+    VkCore::Buffer m_ClusterBuffer;
+    VkCore::Buffer m_MeshletGroupBuffer;
+    VkCore::Buffer m_VertexQuantizationBuffer;
 
     vk::DescriptorSet m_DescriptorSet;
     vk::DescriptorSetLayout m_DescriptorSetLayout;
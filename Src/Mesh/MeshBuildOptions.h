@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Algorithm used for splitting a mesh into meshlets.
+ */
+enum class EMeshletStrategy : uint8_t
+{
+    // Fills the meshlets greedily in the order of the (vertex cache optimized) index buffer. Fast and parallel.
+    Greedy = 0,
+    // Grows the meshlets over the triangle adjacency and keeps them spatially compact with similar normals, which
+    // results in tighter bounds and more culled meshlets.
+    Spatial = 1,
+};
+
+/**
+ * Layout of the meshlet vertex references and triangles uploaded to the GPU.
+ */
+enum class EMeshletEncoding : uint8_t
+{
+    // 32-bit global vertex indices and one uint per triangle (see MeshUtils::PackTriangleIntoUInt).
+    Uint32 = 0,
+    // 16-bit vertex references relative to a per-meshlet base and 3 bytes per triangle (see MeshletEncoding).
+    // The shaders have to decode the meshlets with meshlet_encoding.glsl.
+    Compact = 1,
+};
+
+/**
+ * Layout of the vertices uploaded to the GPU (binding 0 of Mesh and LODMesh).
+ */
+enum class EVertexFormat : uint8_t
+{
+    // MeshVertex, 80 bytes.
+    Full = 0,
+    // QuantizedVertex, 20 bytes (see VertexQuantization). The shaders have to decode the vertices with
+    // vertex_quantization.glsl and read the VertexQuantizationInfo bound to 7.
+    Quantized = 1,
+};
+
+/**
+ * Reordering of the triangles for the post-transform vertex cache (see VertexCacheOptimizer).
+ */
+enum class EVertexCacheOptimizer : uint8_t
+{
+    // Keeps the order of the imported index buffer. The greedy meshletizer then cuts its parallel chunks from that
+    // order, which are only as spatially coherent as the import is (see MeshletGeneration::MeshletizeNvParallel).
+    None = 0,
+    // Fans around the vertices (MeshUtils::Tipsify). Fast and also good for the overdraw.
+    Tipsify = 1,
+    // Picks the triangle with the best score of its vertices in a simulated LRU cache (Forsyth). Targets the LRU
+    // caches, slower than Tipsify.
+    Forsyth = 2,
+};
+
+/**
+ * What a mesh keeps on the CPU after its upload (see MeshPositions and MeshMemoryStats).
+ */
+enum class EMeshResidency : uint8_t
+{
+    // The indices and the whole vertices stay next to the GPU buffers.
+    KeepAll = 0,
+    // Only the indices and the positions stay, as a compact SoA. Enough for the octree and the bounding box of the
+    // mesh, at 12 instead of 80 (MeshVertex) or 56 (Vertex) bytes per vertex.
+    PositionsOnly = 1,
+    // Nothing stays, the geometry lives only on the GPU.
+    Release = 2,
+};
+
+/**
+ * Automatic generation of a LOD chain from LOD0 (see LODGenerator).
+ */
+struct LODGenerationOptions
+{
+    // Number of levels including LOD0, up to Constants::MAX_LOD_LEVELS. 0 or 1 disables the generation and
+    // LODModel and ClassicLODModel only load the authored *_lodN files.
+    uint32_t levelCount = 0;
+
+    // Targeted triangle count of every level relative to the previous one.
+    float triangleRatio = 0.5f;
+
+    // Maximum error of a level relative to the extent of the mesh. The chain ends with the first level which can't
+    // get noticeably simpler than the previous one within this error.
+    float maxError = 0.05f;
+
+    // Weights of the attributes in the quadric error, relative to the positions.
+    float normalWeight = 0.5f;
+    float texCoordWeight = 0.25f;
+
+    // Keeps the open borders of the mesh in place, so the meshes which are parts of one surface stay connected.
+    bool lockBorder = false;
+};
+
+/**
+ * Post-processing of the imported meshes done by us instead of assimp.
+ */
+struct MeshImportOptions
+{
+    // Welds the vertices with VertexWelder instead of aiProcess_JoinIdenticalVertices.
+    bool weldVertices = true;
+
+    // Quantization step of the welded positions in the units of the mesh, 0 merges only the equal ones like assimp.
+    float weldPositionEpsilon = 0.f;
+
+    // Same for the normals, tangents and texture coordinates.
+    float weldAttributeEpsilon = 0.f;
+
+    // Generates smooth normals (MeshUtils::GenerateNormals) for the meshes without them, instead of
+    // aiProcess_GenNormals.
+    bool generateNormals = true;
+};
+
+/**
+ * Binary cache of the processed meshes (see MeshCache).
+ */
+struct MeshCacheOptions
+{
+    // Model, LODModel and ClassicLODModel load the meshes from the cache if it holds them for the same source files
+    // and options, and write them to it otherwise.
+    bool enabled = true;
+
+    // Directory of the cache files, created on the first write. The files are named after the hash of the sources
+    // and of the options, so the stale ones are never read, only left behind.
+    std::string directory = "Cache/Meshes";
+};
+
+/**
+ * Options controlling how the CPU side of the geometry pipeline processes a mesh.
+ */
+struct MeshBuildOptions
+{
+    EVertexCacheOptimizer vertexCacheOptimizer = EVertexCacheOptimizer::Tipsify;
+
+    // Number of vertices in the targeted post-transform cache.
+    uint32_t vertexCacheSize = 32;
+
+    // Sorts the clusters of the cache optimized triangles to reduce the overdraw (see OverdrawOptimizer). Mostly
+    // useful for drawing the index buffer directly (ClassicLODMesh), the meshlets are grouped spatially afterwards.
+    bool optimizeOverdraw = false;
+
+    // How much the ACMR can get worse by the overdraw optimization, 1.05 allows 5 %.
+    float overdrawThreshold = 1.05f;
+
+    EMeshletStrategy meshletStrategy = EMeshletStrategy::Greedy;
+
+    // Only used by the spatial strategy. 0 ignores the normals, 1 groups the triangles only by their normals.
+    float meshletConeWeight = 0.25f;
+
+    EMeshletEncoding meshletEncoding = EMeshletEncoding::Uint32;
+
+    // Only used by Mesh and LODMesh, ClassicLODMesh feeds the vertex input of the pipeline with Vertex.
+    EVertexFormat vertexFormat = EVertexFormat::Full;
+
+    // Builds the cluster LOD hierarchy (see ClusterLOD) and uploads the meshlets of all of its levels. The shaders
+    // then have to select the meshlets of the cut with cluster_lod.glsl. Only used by Mesh, LODMesh and
+    // ClassicLODMesh have their own LODs and ignore it (it isn't a part of their cache keys either).
+    bool buildClusterLod = false;
+
+    MeshImportOptions meshImport;
+
+    // Used by LODModel and ClassicLODModel when only LOD0 of a model is found.
+    LODGenerationOptions lodGeneration;
+
+    // Doesn't change the processed meshes, so it is not a part of the cache key.
+    MeshCacheOptions cache;
+
+    // Applied by Model, LODModel and ClassicLODModel to every mesh they upload. Not a part of the cache key either.
+    EMeshResidency residency = EMeshResidency::KeepAll;
+};
@@ -0,0 +1,398 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "../Constants.h"
+#include "../Log/Log.h"
+#include "IndexCodec.h"
+#include "MeshVertex.h"
+#include "Meshlet.h"
+#include "VertexQuantization.h"
+
+namespace fs = std::filesystem;
+
+static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+static uint64_t RotateLeft(const uint64_t value, const uint32_t bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t Round(uint64_t accumulator, const uint64_t input)
+{
+    accumulator += input * PRIME_2;
+    return RotateLeft(accumulator, 31) * PRIME_1;
+}
+
+static uint64_t Merge(uint64_t accumulator, const uint64_t value)
+{
+    accumulator ^= Round(0, value);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+
+static uint64_t Read64(const uint8_t* data)
+{
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(uint64_t));
+    return value;
+}
+
+static uint64_t AlignUp(const uint64_t value)
+{
+    return (value + MeshCache::SECTION_ALIGNMENT - 1) & ~(MeshCache::SECTION_ALIGNMENT - 1);
+}
+
+uint64_t MeshCache::HashBytes(const void* data, const size_t size, const uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + size;
+
+    uint64_t hash;
+
+    // --- Four independent lanes of 8 bytes, so the loop isn't bound by the latency of the multiplications.
+    if (size >= 32)
+    {
+        uint64_t lanes[4] = {seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1};
+
+        for (; bytes + 32 <= end; bytes += 32)
+        {
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                lanes[lane] = Round(lanes[lane], Read64(bytes + lane * 8));
+            }
+        }
+
+        hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) +
+               RotateLeft(lanes[3], 18);
+
+        for (uint32_t lane = 0; lane < 4; lane++)
+        {
+            hash = Merge(hash, lanes[lane]);
+        }
+    }
+    else
+    {
+        hash = seed + PRIME_5;
+    }
+
+    hash += size;
+
+    // --- The tail.
+    for (; bytes + 8 <= end; bytes += 8)
+    {
+        hash ^= Round(0, Read64(bytes));
+        hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+    }
+
+    for (; bytes < end; bytes++)
+    {
+        hash ^= *bytes * PRIME_5;
+        hash = RotateLeft(hash, 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+bool MeshCache::HashFiles(const std::vector<std::string>& filePaths, uint64_t& outHash)
+{
+    outHash = filePaths.size();
+
+    for (const std::string& filePath : filePaths)
+    {
+        MappedFile file;
+
+        if (!file.Open(filePath))
+        {
+            return false;
+        }
+
+        outHash = HashBytes(file.GetData(), file.GetSize(), outHash);
+    }
+
+    return true;
+}
+
+uint64_t MeshCache::HashOptions(const EMeshCacheKind kind, const MeshBuildOptions& options)
+{
+    // The fields are hashed one by one, the padding of the structs isn't initialized.
+    std::vector<uint8_t> bytes;
+
+    const auto append = [&bytes](const auto value) {
+        const uint8_t* valueBytes = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), valueBytes, valueBytes + sizeof(value));
+    };
+
+    append(options.vertexCacheOptimizer);
+    append(options.vertexCacheSize);
+    append(options.optimizeOverdraw);
+    append(options.overdrawThreshold);
+    append(options.meshletStrategy);
+    append(options.meshletConeWeight);
+    append(options.meshletEncoding);
+    append(options.vertexFormat);
+    // Only Mesh builds the hierarchy, the LOD models would get a new file for a flag without any effect.
+    append(kind == EMeshCacheKind::Model && options.buildClusterLod);
+
+    append(options.meshImport.weldVertices);
+    append(options.meshImport.weldPositionEpsilon);
+    append(options.meshImport.weldAttributeEpsilon);
+    append(options.meshImport.generateNormals);
+
+    append(options.lodGeneration.levelCount);
+    append(options.lodGeneration.triangleRatio);
+    append(options.lodGeneration.maxError);
+    append(options.lodGeneration.normalWeight);
+    append(options.lodGeneration.texCoordWeight);
+    append(options.lodGeneration.lockBorder);
+
+    // Catches the changes of the cooked layouts which weren't followed by a new VERSION.
+    append(Constants::MAX_MESHLET_VERTICES);
+    append(Constants::MAX_MESHLET_INDICES);
+    append(sizeof(MeshVertex));
+    append(sizeof(Vertex));
+    append(sizeof(NewMeshlet));
+    append(sizeof(CompactMeshlet));
+    append(sizeof(MeshletBounds));
+    append(sizeof(MeshletGroup));
+    append(sizeof(LODCluster));
+    append(sizeof(QuantizedVertex));
+    append(sizeof(VertexQuantizationInfo));
+
+    return HashBytes(bytes.data(), bytes.size(), VERSION);
+}
+
+MeshCache::MeshCache(const EMeshCacheKind kind, const std::vector<std::string>& sourcePaths,
+                     const MeshBuildOptions& options)
+    : m_Kind(kind), m_Enabled(options.cache.enabled && !sourcePaths.empty())
+{
+    if (!m_Enabled)
+    {
+        return;
+    }
+
+    // The importer reports the missing sources on its own.
+    if (!HashFiles(sourcePaths, m_SourceHash))
+    {
+        m_Enabled = false;
+        return;
+    }
+
+    m_OptionsHash = HashOptions(kind, options);
+
+    const uint64_t key[3] = {m_SourceHash, m_OptionsHash, static_cast<uint64_t>(kind)};
+
+    char keyHex[17];
+    std::snprintf(keyHex, sizeof(keyHex), "%016llx",
+                  static_cast<unsigned long long>(HashBytes(key, sizeof(key))));
+
+    const std::string fileName = fs::path(sourcePaths[0]).stem().string() + "_" + keyHex + ".vcmesh";
+
+    m_Path = (fs::path(options.cache.directory) / fileName).string();
+}
+
+bool MeshCache::Load()
+{
+    m_Meshes.clear();
+
+    if (!m_Enabled || !m_File.Open(m_Path))
+    {
+        return false;
+    }
+
+    const uint8_t* data = m_File.GetData();
+    const size_t size = m_File.GetSize();
+
+    MeshCacheFileHeader header;
+
+    bool valid = size >= sizeof(MeshCacheFileHeader);
+
+    if (valid)
+    {
+        std::memcpy(&header, data, sizeof(MeshCacheFileHeader));
+
+        valid = header.magic == MAGIC && header.version == VERSION && header.kind == m_Kind &&
+                header.sourceHash == m_SourceHash && header.optionsHash == m_OptionsHash &&
+                sizeof(MeshCacheFileHeader) + uint64_t(header.meshCount) * sizeof(MeshCacheEntry) <= size;
+    }
+
+    for (uint32_t m = 0; valid && m < header.meshCount; m++)
+    {
+        MeshCacheEntry entry;
+        std::memcpy(&entry, data + sizeof(MeshCacheFileHeader) + m * sizeof(MeshCacheEntry), sizeof(MeshCacheEntry));
+
+        MeshDataView view;
+        view.header = entry.header;
+
+        for (size_t s = 0; s < MESH_SECTION_COUNT; s++)
+        {
+            valid &= entry.sectionOffsets[s] % SECTION_ALIGNMENT == 0 && entry.sectionOffsets[s] <= size &&
+                     entry.sectionSizes[s] <= size - entry.sectionOffsets[s];
+
+            view.sections[s] = data + entry.sectionOffsets[s];
+            view.sectionSizes[s] = entry.sectionSizes[s];
+        }
+
+        m_Meshes.emplace_back(view);
+    }
+
+    if (!valid)
+    {
+        LOGF(Assimp, Warning, "The mesh cache file %s is corrupted, the model will be imported again.",
+             m_Path.c_str())
+
+        m_Meshes.clear();
+        m_File.Close();
+
+        return false;
+    }
+
+    LOGF(Assimp, Info, "Loaded %zu meshes from the mesh cache %s", m_Meshes.size(), m_Path.c_str())
+
+    return true;
+}
+
+bool MeshCache::Store(const std::vector<MeshData>& meshes) const
+{
+    std::vector<uint32_t> references(meshes.size());
+
+    for (uint32_t m = 0; m < references.size(); m++)
+    {
+        references[m] = m;
+    }
+
+    return Store(meshes, references);
+}
+
+bool MeshCache::Store(const std::vector<MeshData>& meshes, const std::vector<uint32_t>& references) const
+{
+    if (!m_Enabled)
+    {
+        return false;
+    }
+
+    // --- The index buffers are compressed and the sections are laid out after the entries of the references.
+    std::vector<MeshCacheEntry> entries(meshes.size());
+    std::vector<std::vector<uint8_t>> encodedIndices(meshes.size());
+
+    uint64_t offset = AlignUp(sizeof(MeshCacheFileHeader) + references.size() * sizeof(MeshCacheEntry));
+
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+        const MeshData& mesh = meshes[m];
+        const std::vector<uint8_t>& indices = mesh.sections[static_cast<size_t>(EMeshSection::Indices)];
+
+        MeshCacheEntry& entry = entries[m];
+        entry = {};
+        entry.header = mesh.header;
+
+        if (!mesh.header.indicesEncoded && !indices.empty() && indices.size() % (3 * sizeof(uint32_t)) == 0)
+        {
+            const uint32_t* indexData = reinterpret_cast<const uint32_t*>(indices.data());
+            const size_t indexCount = indices.size() / sizeof(uint32_t);
+            const uint32_t vertexCount = *std::max_element(indexData, indexData + indexCount) + 1;
+
+            encodedIndices[m] = IndexCodec::Encode(indexData, indexCount, vertexCount);
+            entry.header.indicesEncoded = true;
+        }
+
+        for (size_t s = 0; s < MESH_SECTION_COUNT; s++)
+        {
+            const bool encoded = s == static_cast<size_t>(EMeshSection::Indices) && !encodedIndices[m].empty();
+
+            entry.sectionOffsets[s] = offset;
+            entry.sectionSizes[s] = encoded ? encodedIndices[m].size() : mesh.sections[s].size();
+
+            offset = AlignUp(offset + entry.sectionSizes[s]);
+        }
+    }
+
+    const MeshCacheFileHeader header = {
+        .magic = MAGIC,
+        .version = VERSION,
+        .kind = m_Kind,
+        .meshCount = static_cast<uint32_t>(references.size()),
+        .sourceHash = m_SourceHash,
+        .optionsHash = m_OptionsHash,
+    };
+
+    // --- Written front to back, the gaps of the alignment are zeroed.
+    std::error_code error;
+    fs::create_directories(fs::path(m_Path).parent_path(), error);
+
+    const std::string temporaryPath = m_Path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        LOGF(Assimp, Warning, "Couldn't write the mesh cache file %s", temporaryPath.c_str())
+        return false;
+    }
+
+    const char zeros[SECTION_ALIGNMENT] = {};
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheFileHeader));
+
+    for (const uint32_t reference : references)
+    {
+        file.write(reinterpret_cast<const char*>(&entries.at(reference)), sizeof(MeshCacheEntry));
+    }
+
+    uint64_t written = sizeof(MeshCacheFileHeader) + references.size() * sizeof(MeshCacheEntry);
+
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+        for (size_t s = 0; s < MESH_SECTION_COUNT; s++)
+        {
+            const uint64_t sectionOffset = entries[m].sectionOffsets[s];
+            const uint64_t sectionSize = entries[m].sectionSizes[s];
+
+            const bool encoded = s == static_cast<size_t>(EMeshSection::Indices) && !encodedIndices[m].empty();
+            const uint8_t* sectionData = encoded ? encodedIndices[m].data() : meshes[m].sections[s].data();
+
+            file.write(zeros, sectionOffset - written);
+            file.write(reinterpret_cast<const char*>(sectionData), sectionSize);
+
+            written = sectionOffset + sectionSize;
+        }
+    }
+
+    file.write(zeros, AlignUp(written) - written);
+    file.close();
+
+    if (!file)
+    {
+        LOGF(Assimp, Warning, "Couldn't write the mesh cache file %s", temporaryPath.c_str())
+
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    fs::rename(temporaryPath, m_Path, error);
+
+    if (error)
+    {
+        LOGF(Assimp, Warning, "Couldn't write the mesh cache file %s", m_Path.c_str())
+
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    LOGF(Assimp, Info, "Stored %zu meshes (%zu unique) in the mesh cache %s", references.size(), meshes.size(),
+         m_Path.c_str())
+
+    return true;
+}
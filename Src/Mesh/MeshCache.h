@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../MappedFile.h"
+#include "MeshBuildOptions.h"
+#include "MeshData.h"
+
+/**
+ * Class of the model the cache file belongs to. The meshes of every class have their own layout of the MeshData.
+ */
+enum class EMeshCacheKind : uint32_t
+{
+    Model = 0,
+    LODModel = 1,
+    ClassicLODModel = 2,
+};
+
+/**
+ * Header of a cache file. It is followed by a MeshCacheEntry of every mesh and then by the sections of the meshes.
+ * Several entries can point to the same sections.
+ */
+struct MeshCacheFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    EMeshCacheKind kind;
+    uint32_t meshCount;
+    uint64_t sourceHash;
+    uint64_t optionsHash;
+};
+
+struct MeshCacheEntry
+{
+    MeshDataHeader header;
+    uint32_t padding;
+    // From the start of the file, aligned to MeshCache::SECTION_ALIGNMENT.
+    uint64_t sectionOffsets[MESH_SECTION_COUNT];
+    // In bytes.
+    uint64_t sectionSizes[MESH_SECTION_COUNT];
+};
+
+/**
+ * Binary cache of the processed meshes of a model, so the assimp import, the welding, the vertex cache optimization
+ * and the meshletization run only the first time the model is loaded.
+ *
+ * The cache file is keyed by the hash of the content of the source files and of the build options, so any change of
+ * the model or of the options gives a new file. On a hit the file is memory mapped and the meshes are uploaded
+ * straight from the mapped pages. The index buffers are stored compressed by IndexCodec.
+ */
+class MeshCache
+{
+  public:
+    // "VCMC" - Vulkan Core Mesh Cache.
+    static constexpr uint32_t MAGIC = 0x434D4356;
+    // Has to be raised with every change of the file layout or of the layout of the cooked data.
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+    /**
+     * @brief Hashes the sources and the options and picks the cache file. Nothing is read or written yet.
+     * @param sourcePaths - all the files the meshes are built from, in a stable order
+     */
+    MeshCache(const EMeshCacheKind kind, const std::vector<std::string>& sourcePaths,
+              const MeshBuildOptions& options);
+
+    /**
+     * @brief Maps the cache file.
+     * @return true on a hit. False if the cache is disabled, the file doesn't exist or it isn't valid.
+     */
+    bool Load();
+
+    /**
+     * @brief Writes the meshes to the cache file. The file is written under a temporary name and renamed
+     * afterwards, so a partially written file is never loaded.
+     * @return false if the cache is disabled or the file couldn't be written.
+     */
+    bool Store(const std::vector<MeshData>& meshes) const;
+
+    /**
+     * @brief Writes an entry for every reference, each one pointing to the sections of meshes[reference]. A mesh
+     * referenced several times (e.g. by several nodes of a scene) is written only once, the hit returns a view of
+     * the same data for each of its references.
+     */
+    bool Store(const std::vector<MeshData>& meshes, const std::vector<uint32_t>& references) const;
+
+    size_t GetMeshCount() const
+    {
+        return m_Meshes.size();
+    }
+
+    /**
+     * @brief Returns the mesh of the loaded file. The view is valid as long as the MeshCache exists.
+     */
+    const MeshDataView& GetMesh(const size_t index) const
+    {
+        return m_Meshes.at(index);
+    }
+
+    const std::string& GetPath() const
+    {
+        return m_Path;
+    }
+
+    /**
+     * @brief Fast non-cryptographic 64-bit hash (in the style of xxHash64).
+     */
+    static uint64_t HashBytes(const void* data, const size_t size, const uint64_t seed = 0);
+
+    /**
+     * @brief Hashes the content of the files.
+     * @return false if any of the files couldn't be read.
+     */
+    static bool HashFiles(const std::vector<std::string>& filePaths, uint64_t& outHash);
+
+    /**
+     * @brief Hashes every option changing the processed meshes of the kind, together with the layouts of the cooked
+     * data.
+     */
+    static uint64_t HashOptions(const EMeshCacheKind kind, const MeshBuildOptions& options);
+
+  private:
+    EMeshCacheKind m_Kind;
+    bool m_Enabled = false;
+    uint64_t m_SourceHash = 0;
+    uint64_t m_OptionsHash = 0;
+    std::string m_Path;
+
+    MappedFile m_File;
+    std::vector<MeshDataView> m_Meshes;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "MeshBuildOptions.h"
+
+/**
+ * Arrays of a cooked mesh. Every mesh class uses only some of them, the others stay empty.
+ */
+enum class EMeshSection : uint8_t
+{
+    // uint32_t triangle list, or an IndexCodec block if MeshDataHeader::indicesEncoded is set.
+    Indices = 0,
+    // MeshVertex or QuantizedVertex (Mesh, LODMesh, depending on MeshDataHeader::vertexFormat) or Vertex
+    // (ClassicLODMesh).
+    Vertices = 1,
+    // NewMeshlet or CompactMeshlet, depending on MeshDataHeader::meshletEncoding.
+    Meshlets = 2,
+    // uint32_t or uint16_t, depending on MeshDataHeader::meshletEncoding.
+    MeshletVertices = 3,
+    // Packed uint32_t per triangle or 3 bytes per triangle, depending on MeshDataHeader::meshletEncoding.
+    MeshletTriangles = 4,
+    MeshletBounds = 5,
+    MeshletGroups = 6,
+    // LODCluster of every meshlet (Mesh with the cluster LOD).
+    Clusters = 7,
+    // LODMeshInfo or ClassicLODMeshInfo.
+    LodInfo = 8,
+    // VertexQuantizationInfo of the quantized vertices.
+    VertexQuantization = 9,
+
+    Count = 10,
+};
+
+constexpr size_t MESH_SECTION_COUNT = static_cast<size_t>(EMeshSection::Count);
+
+/**
+ * Values of a cooked mesh which are not arrays. Stored as it is in the mesh cache, so it has no implicit padding.
+ */
+struct MeshDataHeader
+{
+    uint32_t meshletCount = 0;
+    uint32_t meshletGroupCount = 0;
+    EMeshletEncoding meshletEncoding = EMeshletEncoding::Uint32;
+    bool hasClusterLod = false;
+    // The Indices section holds an IndexCodec block instead of the raw indices.
+    bool indicesEncoded = false;
+    EVertexFormat vertexFormat = EVertexFormat::Full;
+};
+
+/**
+ * Non-owning view of the arrays of a cooked mesh, pointing either into MeshData or into a mapped MeshCache file. The
+ * mesh classes are created from it, so both of them are uploaded the same way.
+ */
+struct MeshDataView
+{
+    MeshDataHeader header;
+    const uint8_t* sections[MESH_SECTION_COUNT] = {};
+    // In bytes.
+    size_t sectionSizes[MESH_SECTION_COUNT] = {};
+
+    const void* GetData(const EMeshSection section) const
+    {
+        return sections[static_cast<size_t>(section)];
+    }
+
+    size_t GetSize(const EMeshSection section) const
+    {
+        return sectionSizes[static_cast<size_t>(section)];
+    }
+
+    template <typename T>
+    const T* Get(const EMeshSection section) const
+    {
+        return reinterpret_cast<const T*>(GetData(section));
+    }
+
+    template <typename T>
+    size_t GetCount(const EMeshSection section) const
+    {
+        return GetSize(section) / sizeof(T);
+    }
+
+    /**
+     * @brief Copies the section into a vector.
+     */
+    template <typename T>
+    std::vector<T> Copy(const EMeshSection section) const
+    {
+        return std::vector<T>(Get<T>(section), Get<T>(section) + GetCount<T>(section));
+    }
+};
+
+/**
+ * Output of the CPU side of the geometry pipeline (Mesh::Build, LODMesh::Build, ClassicLODMesh::Build). It holds
+ * exactly the data uploaded to the GPU, so it can be written to the MeshCache and uploaded later without any
+ * processing.
+ */
+struct MeshData
+{
+    MeshDataHeader header;
+    std::vector<uint8_t> sections[MESH_SECTION_COUNT];
+
+    template <typename T>
+    void Set(const EMeshSection section, const T* data, const size_t count)
+    {
+        std::vector<uint8_t>& bytes = sections[static_cast<size_t>(section)];
+
+        bytes.resize(count * sizeof(T));
+
+        if (count > 0)
+        {
+            std::memcpy(bytes.data(), data, count * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void Set(const EMeshSection section, const std::vector<T>& data)
+    {
+        Set(section, data.data(), data.size());
+    }
+
+    /**
+     * @brief Sets the section and frees the vector right away, so the array exists twice only for one section at a
+     * time.
+     */
+    template <typename T>
+    void Set(const EMeshSection section, std::vector<T>&& data)
+    {
+        Set(section, data.data(), data.size());
+        std::vector<T>().swap(data);
+    }
+
+    MeshDataView GetView() const
+    {
+        MeshDataView view;
+        view.header = header;
+
+        for (size_t i = 0; i < MESH_SECTION_COUNT; i++)
+        {
+            view.sections[i] = sections[i].data();
+            view.sectionSizes[i] = sections[i].size();
+        }
+
+        return view;
+    }
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glm/ext/vector_float3.hpp"
+
+/**
+ * Positions of a mesh kept on the CPU by EMeshResidency::PositionsOnly, one array per axis.
+ */
+struct MeshPositions
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    /**
+     * @brief Keeps only the positions of the vertices (MeshVertex or Vertex).
+     */
+    template <typename V>
+    void Assign(const V* vertices, const size_t count)
+    {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            x[i] = vertices[i].Position.x;
+            y[i] = vertices[i].Position.y;
+            z[i] = vertices[i].Position.z;
+        }
+    }
+
+    glm::vec3 Get(const size_t index) const
+    {
+        return {x[index], y[index], z[index]};
+    }
+
+    size_t GetCount() const
+    {
+        return x.size();
+    }
+
+    size_t GetSizeInBytes() const
+    {
+        return (x.capacity() + y.capacity() + z.capacity()) * sizeof(float);
+    }
+
+    void Clear()
+    {
+        std::vector<float>().swap(x);
+        std::vector<float>().swap(y);
+        std::vector<float>().swap(z);
+    }
+};
+
+/**
+ * Memory held by a mesh (or a whole model) in bytes. The CPU side counts the allocated capacity of the arrays.
+ */
+struct MeshMemoryStats
+{
+    size_t cpuIndexBytes = 0;
+    size_t cpuVertexBytes = 0;
+    size_t cpuPositionBytes = 0;
+    size_t gpuBytes = 0;
+
+    size_t GetCpuBytes() const
+    {
+        return cpuIndexBytes + cpuVertexBytes + cpuPositionBytes;
+    }
+
+    MeshMemoryStats& operator+=(const MeshMemoryStats& other)
+    {
+        cpuIndexBytes += other.cpuIndexBytes;
+        cpuVertexBytes += other.cpuVertexBytes;
+        cpuPositionBytes += other.cpuPositionBytes;
+        gpuBytes += other.gpuBytes;
+
+        return *this;
+    }
+};
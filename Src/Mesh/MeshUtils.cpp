@@ -1,181 +1,820 @@
 #include "MeshUtils.h"
+#include <algorithm>
 #include <cstring>
-#include <queue>
-#include <unordered_map>
+#include <immintrin.h>
+#include <limits>
+
+#include "../Log/Log.h"
+#include "../ThreadUtils.h"
 
 VertexTriangleAdjacency MeshUtils::BuildVertexTriangleAdjacency(const std::vector<uint32_t>& indices,
                                                                 size_t numOfVertices)
 {
-    std::vector<uint32_t> vertexCount;
+    VertexTriangleAdjacency adjacency;
+    BuildVertexTriangleAdjacency(indices.data(), indices.size(), numOfVertices, adjacency);
 
-    vertexCount.resize(numOfVertices);
+    return adjacency;
+}
+
+void MeshUtils::BuildVertexTriangleAdjacency(const uint32_t* indices, const size_t indexCount,
+                                             const size_t numOfVertices, VertexTriangleAdjacency& outAdjacency)
+{
+    std::vector<uint32_t>& vertexCount = outAdjacency.vertexCount;
+    std::vector<uint32_t>& offsets = outAdjacency.offsets;
+    std::vector<uint32_t>& adjList = outAdjacency.adjacencyList;
 
-    for (size_t i = 0; i < indices.size(); i++)
+    outAdjacency.indices = indices;
+    outAdjacency.indexCount = indexCount;
+
+    vertexCount.assign(numOfVertices, 0);
+    offsets.resize(numOfVertices);
+
+    const size_t usedIndexCount = indexCount - indexCount % 3;
+
+    for (size_t i = 0; i < usedIndexCount; i++)
     {
         vertexCount[indices[i]]++;
     }
 
-    std::vector<uint32_t> offsets;
-    offsets.resize(numOfVertices);
-
     uint32_t offset = 0;
 
-    for (size_t i = 0; i < vertexCount.size(); i++)
+    for (size_t i = 0; i < numOfVertices; i++)
     {
         offsets[i] = offset;
         offset += vertexCount[i];
     }
 
-    std::vector<uint32_t> copyOffsets(offsets);
-
-    std::vector<uint32_t> adjList;
     adjList.resize(offset);
 
-    for (std::size_t i = 0; i < indices.size(); i += 3)
+    // The offsets are advanced while filling the list and moved back afterwards, so no copy of them is needed.
+    for (size_t i = 0; i < usedIndexCount; i += 3)
     {
-
         const uint32_t triangleIndex = i / 3;
+
         for (size_t j = 0; j < 3; j++)
         {
-            const uint32_t vertexIndex = indices[i + j];
-            const uint32_t position = copyOffsets[vertexIndex];
+            adjList[offsets[indices[i + j]]++] = triangleIndex;
+        }
+    }
+
+    for (size_t i = 0; i < numOfVertices; i++)
+    {
+        offsets[i] -= vertexCount[i];
+    }
+}
+
+// Below this many indices the parallel adjacency builder falls back to the serial one.
+static constexpr size_t MIN_PARALLEL_ADJACENCY_INDICES = 1 << 18;
+
+// Vertices handled by one work item of the parallel prefix sum.
+static constexpr size_t ADJACENCY_VERTEX_BLOCK = 1 << 16;
+
+void MeshUtils::BuildVertexTriangleAdjacencyParallel(const uint32_t* indices, const size_t indexCount,
+                                                     const size_t numOfVertices,
+                                                     VertexTriangleAdjacency& outAdjacency, uint32_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = ThreadUtils::GetThreadCount();
+    }
+
+    const size_t triangleCount = indexCount / 3;
+
+    // Every chunk has a histogram over all the vertices, so their count is also limited to keep the histograms
+    // within twice the size of the index buffer.
+    const size_t chunkCount = std::min<size_t>(threadCount, 2 * indexCount / std::max<size_t>(numOfVertices, 1));
+
+    if (indexCount < MIN_PARALLEL_ADJACENCY_INDICES || chunkCount <= 1)
+    {
+        BuildVertexTriangleAdjacency(indices, indexCount, numOfVertices, outAdjacency);
+        return;
+    }
+
+    std::vector<uint32_t>& vertexCount = outAdjacency.vertexCount;
+    std::vector<uint32_t>& offsets = outAdjacency.offsets;
+    std::vector<uint32_t>& adjList = outAdjacency.adjacencyList;
+
+    outAdjacency.indices = indices;
+    outAdjacency.indexCount = indexCount;
+
+    vertexCount.resize(numOfVertices);
+    offsets.resize(numOfVertices);
+    adjList.resize(triangleCount * 3);
+
+    const size_t trianglesPerChunk = (triangleCount + chunkCount - 1) / chunkCount;
+
+    // --- Per-chunk histograms of the vertex references.
+    std::vector<uint32_t> histograms(chunkCount * numOfVertices);
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        uint32_t* histogram = histograms.data() + chunk * numOfVertices;
+        std::fill_n(histogram, numOfVertices, 0);
+
+        const size_t end = std::min(triangleCount, (chunk + 1) * trianglesPerChunk) * 3;
+
+        for (size_t i = chunk * trianglesPerChunk * 3; i < end; i++)
+        {
+            histogram[indices[i]]++;
+        }
+    });
+
+    // --- Parallel prefix sum. The totals of the vertex blocks are summed first, then every block computes its
+    // offsets starting from the sum of the blocks before it.
+    const size_t blockCount = (numOfVertices + ADJACENCY_VERTEX_BLOCK - 1) / ADJACENCY_VERTEX_BLOCK;
+    std::vector<uint32_t> blockOffsets(blockCount);
+
+    ThreadUtils::ParallelFor(blockCount, threadCount, [&](const size_t block, const uint32_t) {
+        const size_t end = std::min(numOfVertices, (block + 1) * ADJACENCY_VERTEX_BLOCK);
+        uint32_t blockTotal = 0;
+
+        for (size_t v = block * ADJACENCY_VERTEX_BLOCK; v < end; v++)
+        {
+            uint32_t total = 0;
+
+            for (size_t chunk = 0; chunk < chunkCount; chunk++)
+            {
+                total += histograms[chunk * numOfVertices + v];
+            }
 
-            adjList[position] = triangleIndex;
-            copyOffsets[vertexIndex]++;
+            vertexCount[v] = total;
+            blockTotal += total;
         }
+
+        blockOffsets[block] = blockTotal;
+    });
+
+    uint32_t offset = 0;
+
+    for (uint32_t& blockOffset : blockOffsets)
+    {
+        const uint32_t blockTotal = blockOffset;
+        blockOffset = offset;
+        offset += blockTotal;
     }
 
-    return {
-        .indices = indices,
-        .vertexCount = vertexCount,
-        .offsets = offsets,
-        .adjacencyList = adjList,
+    // The histograms become the write cursors of their chunks. The chunks follow each other in the list of every
+    // vertex, which keeps the triangles sorted.
+    ThreadUtils::ParallelFor(blockCount, threadCount, [&](const size_t block, const uint32_t) {
+        const size_t end = std::min(numOfVertices, (block + 1) * ADJACENCY_VERTEX_BLOCK);
+        uint32_t vertexOffset = blockOffsets[block];
+
+        for (size_t v = block * ADJACENCY_VERTEX_BLOCK; v < end; v++)
+        {
+            offsets[v] = vertexOffset;
+
+            for (size_t chunk = 0; chunk < chunkCount; chunk++)
+            {
+                uint32_t& cursor = histograms[chunk * numOfVertices + v];
+                const uint32_t count = cursor;
+
+                cursor = vertexOffset;
+                vertexOffset += count;
+            }
+        }
+    });
+
+    // --- Fill in the triangles.
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        uint32_t* cursors = histograms.data() + chunk * numOfVertices;
+        const size_t end = std::min(triangleCount, (chunk + 1) * trianglesPerChunk);
+
+        for (size_t t = chunk * trianglesPerChunk; t < end; t++)
+        {
+            adjList[cursors[indices[t * 3]]++] = t;
+            adjList[cursors[indices[t * 3 + 1]]++] = t;
+            adjList[cursors[indices[t * 3 + 2]]++] = t;
+        }
+    });
+}
+
+// Vertices handled by one work item of BuildEdgeAdjacency.
+static constexpr size_t EDGE_ADJACENCY_VERTEX_BLOCK = 1 << 12;
+
+// Vertices with more triangles than this pair their half-edges by searching the triangles of the other vertex
+// instead of comparing all their triangles with each other.
+static constexpr uint32_t MAX_EDGE_FAN = 64;
+
+// Position of the vertex in the triangle, or 3 if the triangle doesn't reference it or is degenerate.
+static uint32_t FindCorner(const uint32_t* corners, const uint32_t vertex)
+{
+    if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0])
+    {
+        return 3;
+    }
+
+    return corners[0] == vertex ? 0 : corners[1] == vertex ? 1 : corners[2] == vertex ? 2 : 3;
+}
+
+void MeshUtils::BuildEdgeAdjacency(const uint32_t* indices, const size_t indexCount,
+                                   const VertexTriangleAdjacency& vertexAdjacency, EdgeAdjacency& outEdges,
+                                   const uint32_t threadCount)
+{
+    const size_t triangleCount = indexCount / 3;
+    const size_t vertexCount = vertexAdjacency.vertexCount.size();
+
+    // The degenerate triangles are never visited below, their half-edges stay unpaired.
+    outEdges.opposite.assign(triangleCount * 3, EdgeAdjacency::NO_EDGE);
+
+    // Pairs the half-edge from -> to if both it and the opposite one are unique among the triangles of the vertex.
+    const auto pairOverVertex = [&](const uint32_t halfEdge, const uint32_t from, const uint32_t to,
+                                    const uint32_t vertex) {
+        uint32_t opposite = EdgeAdjacency::NO_EDGE;
+        uint32_t oppositeCount = 0;
+        uint32_t sameCount = 0;
+
+        for (const uint32_t triangle : vertexAdjacency.GetTriangleSpan(vertex))
+        {
+            const uint32_t* corners = indices + triangle * 3;
+            const uint32_t j = FindCorner(corners, from);
+
+            if (j == 3)
+            {
+                continue;
+            }
+
+            sameCount += corners[j == 2 ? 0 : j + 1] == to;
+
+            if (corners[j == 0 ? 2 : j - 1] == to)
+            {
+                opposite = triangle * 3 + (j == 0 ? 2 : j - 1);
+                oppositeCount++;
+            }
+        }
+
+        outEdges.opposite[halfEdge] = oppositeCount == 1 && sameCount == 1 ? opposite : EdgeAdjacency::NO_EDGE;
     };
 
-	
+    const size_t blockCount = (vertexCount + EDGE_ADJACENCY_VERTEX_BLOCK - 1) / EDGE_ADJACENCY_VERTEX_BLOCK;
+
+    // Every half-edge is resolved by the vertex it starts from. The triangles around the vertex are read once,
+    // their neighbouring vertices are compared with each other from the stack.
+    ThreadUtils::ParallelFor(blockCount, threadCount, [&](const size_t block, const uint32_t) {
+        const size_t end = std::min(vertexCount, (block + 1) * EDGE_ADJACENCY_VERTEX_BLOCK);
+
+        uint32_t halfEdges[MAX_EDGE_FAN];
+        uint32_t nextVertices[MAX_EDGE_FAN];
+        uint32_t previousVertices[MAX_EDGE_FAN];
+
+        for (size_t v = block * EDGE_ADJACENCY_VERTEX_BLOCK; v < end; v++)
+        {
+            const VertexTriangleAdjacency::TriangleSpan span = vertexAdjacency.GetTriangleSpan(v);
+
+            if (span.size() > MAX_EDGE_FAN)
+            {
+                for (const uint32_t triangle : span)
+                {
+                    const uint32_t* corners = indices + triangle * 3;
+                    const uint32_t j = FindCorner(corners, v);
+
+                    if (j != 3)
+                    {
+                        const uint32_t next = corners[j == 2 ? 0 : j + 1];
+                        pairOverVertex(triangle * 3 + j, v, next, next);
+                    }
+                }
+
+                continue;
+            }
+
+            uint32_t fanSize = 0;
+
+            for (const uint32_t triangle : span)
+            {
+                const uint32_t* corners = indices + triangle * 3;
+                const uint32_t j = FindCorner(corners, v);
+
+                if (j != 3)
+                {
+                    halfEdges[fanSize] = triangle * 3 + j;
+                    nextVertices[fanSize] = corners[j == 2 ? 0 : j + 1];
+                    previousVertices[fanSize] = corners[j == 0 ? 2 : j - 1];
+                    fanSize++;
+                }
+            }
+
+            for (uint32_t i = 0; i < fanSize; i++)
+            {
+                uint32_t opposite = EdgeAdjacency::NO_EDGE;
+                uint32_t oppositeCount = 0;
+                uint32_t sameCount = 0;
+
+                for (uint32_t k = 0; k < fanSize; k++)
+                {
+                    sameCount += nextVertices[k] == nextVertices[i];
+
+                    if (previousVertices[k] == nextVertices[i])
+                    {
+                        opposite = EdgeAdjacency::GetPrevious(halfEdges[k]);
+                        oppositeCount++;
+                    }
+                }
+
+                outEdges.opposite[halfEdges[i]] =
+                    oppositeCount == 1 && sameCount == 1 ? opposite : EdgeAdjacency::NO_EDGE;
+            }
+        }
+    });
+}
+
+// Fanning candidates kept per step. The vertices of the fan which don't fit are still reachable through
+// the dead-end stack.
+static constexpr uint32_t MAX_TIPSIFY_CANDIDATES = 96;
+
+static int SkipDeadEnd(const std::vector<uint32_t>& liveTriangles, std::vector<uint32_t>& deadEndStack,
+                       const uint32_t vertexCount, uint32_t& cursor)
+{
+    while (!deadEndStack.empty())
+    {
+        const uint32_t d = deadEndStack.back();
+        deadEndStack.pop_back();
+
+        if (liveTriangles[d] > 0)
+        {
+            return d;
+        }
+    }
+
+    // The cursor only moves forward, all the vertices behind it are already done.
+    for (; cursor < vertexCount; cursor++)
+    {
+        if (liveTriangles[cursor] > 0)
+        {
+            return cursor;
+        }
+    }
+
+    return -1;
+}
+
+static int GetNextVertex(const uint32_t* candidates, const uint32_t candidateCount, const uint32_t cacheSize,
+                         const uint32_t timeStamp, TipsifyScratch& scratch, const uint32_t vertexCount,
+                         uint32_t& cursor)
+{
+    int bestCandidate = -1;
+    int bestPriority = -1;
+
+    for (uint32_t i = 0; i < candidateCount; i++)
+    {
+        const uint32_t candidate = candidates[i];
+        const uint32_t live = scratch.liveTriangles[candidate];
+
+        if (live == 0)
+        {
+            continue;
+        }
+
+        // Prefer the oldest vertex which stays in the cache while its remaining triangles are emitted.
+        const uint32_t age = timeStamp - scratch.cacheTimeStamps[candidate];
+        const int priority = age + 2 * live <= cacheSize ? static_cast<int>(age) : 0;
+
+        if (priority > bestPriority)
+        {
+            bestPriority = priority;
+            bestCandidate = candidate;
+        }
+    }
+
+    if (bestCandidate == -1)
+    {
+        bestCandidate = SkipDeadEnd(scratch.liveTriangles, scratch.deadEndStack, vertexCount, cursor);
+    }
+
+    return bestCandidate;
 }
 
 std::vector<uint32_t> MeshUtils::Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
                                          const uint32_t cacheSize)
 {
-    VertexTriangleAdjacency adj = MeshUtils::BuildVertexTriangleAdjacency(indices, vertexCount);
+    TipsifyScratch scratch;
+    return Tipsify(indices, vertexCount, cacheSize, scratch);
+}
+
+std::vector<uint32_t> MeshUtils::Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                         const uint32_t cacheSize, TipsifyScratch& scratch)
+{
+    std::vector<uint32_t> outputIndices(indices.size() - indices.size() % 3);
+    Tipsify(indices.data(), indices.size(), vertexCount, cacheSize, scratch, outputIndices.data());
+
+    return outputIndices;
+}
+
+void MeshUtils::Tipsify(const uint32_t* indices, const size_t indexCount, const uint32_t vertexCount,
+                        const uint32_t cacheSize, TipsifyScratch& scratch, uint32_t* outIndices)
+{
+    ASSERT(outIndices != indices, "Tipsify can not reorder the indices in place!")
 
-    std::vector<uint32_t> liveTriangles(adj.vertexCount);
-    std::vector<uint32_t> cachingTimeStamps(vertexCount);
-    std::queue<uint32_t> deadEndStack;
+    MeshUtils::BuildVertexTriangleAdjacency(indices, indexCount, vertexCount, scratch.adjacency);
 
-    std::vector<bool> emmitedTriangles(indices.size() / 3);
+    scratch.liveTriangles.assign(scratch.adjacency.vertexCount.begin(), scratch.adjacency.vertexCount.end());
+    scratch.cacheTimeStamps.assign(vertexCount, 0);
+    scratch.emittedTriangles.assign(indexCount / 3, 0);
+    scratch.deadEndStack.clear();
+    scratch.deadEndStack.reserve(indexCount);
 
-    int f = 0;
+    uint32_t candidates[MAX_TIPSIFY_CANDIDATES];
 
     uint32_t timeStamp = cacheSize + 1;
-    uint32_t cursor = 1;
+    uint32_t cursor = 0;
+    size_t outputCount = 0;
 
-    std::vector<uint32_t> outputIndices;
+    int f = vertexCount > 0 ? 0 : -1;
 
     while (f >= 0)
     {
-        std::unordered_map<uint32_t, bool> ringCandidates;
+        uint32_t candidateCount = 0;
 
-        std::vector<VertexTriangleAdjacency::Triangle> triangles =
-            adj.GetTriangles(f); // Obtains the triangles with the given indices.
-        std::vector<uint32_t> triangleIndices =
-            adj.GetTriangleIndices(f); // Indexes into the index buffer. Points at the different triangles.
-
-        for (size_t i = 0; i < triangles.size(); i++)
+        for (const uint32_t triangle : scratch.adjacency.GetTriangleSpan(f))
         {
-            if (!emmitedTriangles[triangleIndices[i]])
+            if (scratch.emittedTriangles[triangle])
+            {
+                continue;
+            }
+
+            scratch.emittedTriangles[triangle] = 1;
+
+            for (size_t t = 0; t < 3; t++)
             {
-                for (size_t t = 0; t < 3; t++)
+                const uint32_t v = indices[triangle * 3 + t];
+
+                outIndices[outputCount++] = v;
+                scratch.deadEndStack.emplace_back(v);
+
+                if (candidateCount < MAX_TIPSIFY_CANDIDATES)
                 {
-                    const uint32_t v = triangles[i].vertices[t];
-                    outputIndices.emplace_back(v);
-                    deadEndStack.push(v);
-                    ringCandidates.emplace(v, true);
+                    candidates[candidateCount++] = v;
+                }
 
-                    liveTriangles[v]--;
+                scratch.liveTriangles[v]--;
 
-                    if (timeStamp - cachingTimeStamps[v] > cacheSize)
-                    {
-                        cachingTimeStamps[v] = timeStamp++;
-                    }
+                if (timeStamp - scratch.cacheTimeStamps[v] > cacheSize)
+                {
+                    scratch.cacheTimeStamps[v] = timeStamp++;
                 }
-                emmitedTriangles[triangleIndices[i]] = true;
             }
         }
 
         // Get next fanning vertex ----
-        f = MeshUtils::GetNextVertex(vertexCount, cursor, cacheSize, ringCandidates, cachingTimeStamps, timeStamp,
-                                     liveTriangles, deadEndStack);
+        f = GetNextVertex(candidates, candidateCount, cacheSize, timeStamp, scratch, vertexCount, cursor);
     }
 
-    return outputIndices;
+    ASSERT(outputCount == indexCount - indexCount % 3, "Tipsify didn't emit all of the triangles!")
 }
 
-int MeshUtils::GetNextVertex(const uint32_t vertexCount, uint32_t i, const uint32_t cacheSize,
-                             const std::unordered_map<uint32_t, bool>& candidates,
-                             const std::vector<uint32_t>& timeStamps, uint32_t& timeStamp,
-                             const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack)
+// LRU cache kept as a list of the vertices ordered from the most recently used one. It is small enough for
+// the linear search to be faster than any map.
+static size_t CountLruTransforms(const std::vector<uint32_t>& indices, const uint32_t cacheSize)
 {
-    int bestCandidate = -1;
-    int priority = -1;
-    int prevPriority = 0;
+    std::vector<uint32_t> cache;
+    cache.reserve(cacheSize + 1);
+
+    size_t transforms = 0;
+
+    for (const uint32_t index : indices)
+    {
+        const auto hit = std::find(cache.begin(), cache.end(), index);
+
+        if (hit != cache.end())
+        {
+            std::rotate(cache.begin(), hit, hit + 1);
+            continue;
+        }
+
+        transforms++;
+        cache.insert(cache.begin(), index);
+
+        if (cache.size() > cacheSize)
+        {
+            cache.pop_back();
+        }
+    }
+
+    return transforms;
+}
 
-    for (const auto& pair : candidates)
+VertexCacheStatistics MeshUtils::AnalyzeVertexCache(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                                    const uint32_t cacheSize, const EVertexCacheModel model)
+{
+    ASSERT(cacheSize > 0, "The simulated vertex cache has to have at least one entry!")
+
+    if (model == EVertexCacheModel::Lru)
+    {
+        std::vector<bool> referenced(vertexCount, false);
+        size_t uniqueVertices = 0;
+
+        for (const uint32_t index : indices)
+        {
+            uniqueVertices += !referenced[index];
+            referenced[index] = true;
+        }
+
+        const size_t transforms = CountLruTransforms(indices, cacheSize);
+
+        return {
+            .acmr = indices.empty() ? 0.f : static_cast<float>(transforms) / (indices.size() / 3),
+            .atvr = uniqueVertices == 0 ? 0.f : static_cast<float>(transforms) / uniqueVertices,
+            .transformedVertices = transforms,
+        };
+    }
+
+    // A vertex is in the cache if it was transformed less than cacheSize transforms ago.
+    std::vector<size_t> transformTimes(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+
+    size_t transforms = 0;
+    size_t uniqueVertices = 0;
+
+    for (const uint32_t index : indices)
     {
-        const uint32_t candidate = pair.first;
-        if (liveTriangles[candidate] > 0)
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+        else if (transforms - transformTimes[index] < cacheSize)
+        {
+            continue;
+        }
+
+        transformTimes[index] = transforms++;
+    }
+
+    return {
+        .acmr = indices.empty() ? 0.f : static_cast<float>(transforms) / (indices.size() / 3),
+        .atvr = uniqueVertices == 0 ? 0.f : static_cast<float>(transforms) / uniqueVertices,
+        .transformedVertices = transforms,
+    };
+}
+
+size_t MeshUtils::BuildVertexFetchRemap(const std::vector<uint32_t>& indices, const size_t vertexCount,
+                                        std::vector<uint32_t>& outRemap)
+{
+    outRemap.assign(vertexCount, UNUSED_VERTEX);
+
+    uint32_t nextVertex = 0;
+
+    for (const uint32_t index : indices)
+    {
+        if (outRemap[index] == UNUSED_VERTEX)
+        {
+            outRemap[index] = nextVertex++;
+        }
+    }
+
+    return nextVertex;
+}
+
+VertexFetchStatistics MeshUtils::AnalyzeVertexFetch(const std::vector<uint32_t>& indices, const size_t vertexCount,
+                                                    const size_t vertexSize, const size_t cacheLineSize,
+                                                    const size_t cacheLineCount)
+{
+    ASSERT(cacheLineSize > 0 && cacheLineCount > 0, "The simulated cache has to have at least one line!")
+
+    // Line stored in every slot of the cache, +1 so 0 means empty.
+    std::vector<size_t> cachedLines(cacheLineCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+
+    size_t bytesFetched = 0;
+    size_t uniqueVertices = 0;
+
+    for (const uint32_t index : indices)
+    {
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+
+        // The vertex can span several lines.
+        const size_t firstLine = index * vertexSize / cacheLineSize;
+        const size_t lastLine = ((index + 1) * vertexSize - 1) / cacheLineSize;
+
+        for (size_t line = firstLine; line <= lastLine; line++)
         {
+            size_t& slot = cachedLines[line % cacheLineCount];
+
+            if (slot != line + 1)
+            {
+                slot = line + 1;
+                bytesFetched += cacheLineSize;
+            }
+        }
+    }
+
+    return {
+        .bytesFetched = bytesFetched,
+        .overfetch = uniqueVertices == 0 ? 0.f : static_cast<float>(bytesFetched) / (uniqueVertices * vertexSize),
+    };
+}
+
+// Triangles or vertices handled by one work item of GenerateNormals, a multiple of the AVX width.
+static constexpr size_t NORMAL_CHUNK = 1 << 14;
+
+void MeshUtils::GenerateNormals(const uint32_t* indices, const size_t indexCount, const float* positions,
+                                const size_t vertexCount, float* outNormals, const uint32_t threadCount)
+{
+    const size_t triangleCount = indexCount / 3;
 
-            priority = 0;
+    // --- Face normals, not normalized - their length is twice the area of the triangle. Stored as SoA.
+    std::vector<float> faceNormals(triangleCount * 3);
+    float* faceX = faceNormals.data();
+    float* faceY = faceX + triangleCount;
+    float* faceZ = faceY + triangleCount;
+
+    const size_t triangleChunkCount = (triangleCount + NORMAL_CHUNK - 1) / NORMAL_CHUNK;
+
+    ThreadUtils::ParallelFor(triangleChunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        const size_t end = std::min(triangleCount, (chunk + 1) * NORMAL_CHUNK);
+
+        alignas(32) float edges[3][3][8];
+
+        for (size_t first = chunk * NORMAL_CHUNK; first < end; first += 8)
+        {
+            const size_t count = std::min<size_t>(8, end - first);
 
-            if (timeStamp - timeStamps[candidate] + 2 * liveTriangles[candidate] <= cacheSize)
+            // The positions are scattered, so the edges are gathered into SoA first.
+            for (size_t t = 0; t < 8; t++)
             {
-                priority = timeStamp - timeStamps[candidate];
+                const uint32_t* triangle = indices + (first + std::min(t, count - 1)) * 3;
+                const float* a = positions + triangle[0] * 3;
+                const float* b = positions + triangle[1] * 3;
+                const float* c = positions + triangle[2] * 3;
+
+                for (size_t k = 0; k < 3; k++)
+                {
+                    edges[0][k][t] = b[k] - a[k];
+                    edges[1][k][t] = c[k] - a[k];
+                }
+            }
+
+            const __m256 e1x = _mm256_load_ps(edges[0][0]), e1y = _mm256_load_ps(edges[0][1]),
+                         e1z = _mm256_load_ps(edges[0][2]);
+            const __m256 e2x = _mm256_load_ps(edges[1][0]), e2y = _mm256_load_ps(edges[1][1]),
+                         e2z = _mm256_load_ps(edges[1][2]);
+
+            _mm256_store_ps(edges[2][0], _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y)));
+            _mm256_store_ps(edges[2][1], _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z)));
+            _mm256_store_ps(edges[2][2], _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x)));
+
+            std::memcpy(faceX + first, edges[2][0], count * sizeof(float));
+            std::memcpy(faceY + first, edges[2][1], count * sizeof(float));
+            std::memcpy(faceZ + first, edges[2][2], count * sizeof(float));
+        }
+    });
+
+    // --- Every vertex sums the normals of its triangles, so there are no write conflicts between the threads.
+    VertexTriangleAdjacency adjacency;
+    BuildVertexTriangleAdjacencyParallel(indices, indexCount, vertexCount, adjacency, threadCount);
+
+    const size_t vertexChunkCount = (vertexCount + NORMAL_CHUNK - 1) / NORMAL_CHUNK;
+
+    ThreadUtils::ParallelFor(vertexChunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        const size_t end = std::min(vertexCount, (chunk + 1) * NORMAL_CHUNK);
+
+        alignas(32) float sums[3][8];
+
+        for (size_t first = chunk * NORMAL_CHUNK; first < end; first += 8)
+        {
+            const size_t count = std::min<size_t>(8, end - first);
+
+            for (size_t v = 0; v < 8; v++)
+            {
+                float x = 0.f, y = 0.f, z = 0.f;
+
+                if (v < count)
+                {
+                    for (const uint32_t triangle : adjacency.GetTriangleSpan(first + v))
+                    {
+                        x += faceX[triangle];
+                        y += faceY[triangle];
+                        z += faceZ[triangle];
+                    }
+                }
+
+                sums[0][v] = x;
+                sums[1][v] = y;
+                sums[2][v] = z;
             }
 
-            if (priority > prevPriority)
+            const __m256 x = _mm256_load_ps(sums[0]);
+            const __m256 y = _mm256_load_ps(sums[1]);
+            const __m256 z = _mm256_load_ps(sums[2]);
+
+            const __m256 lengthSquared =
+                _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_add_ps(_mm256_mul_ps(y, y), _mm256_mul_ps(z, z)));
+            const __m256 length = _mm256_sqrt_ps(lengthSquared);
+
+            // Zero length stays zero instead of turning into NaN.
+            const __m256 valid = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 scale = _mm256_and_ps(valid, _mm256_div_ps(_mm256_set1_ps(1.f), length));
+
+            _mm256_store_ps(sums[0], _mm256_mul_ps(x, scale));
+            _mm256_store_ps(sums[1], _mm256_mul_ps(y, scale));
+            _mm256_store_ps(sums[2], _mm256_mul_ps(z, scale));
+
+            for (size_t v = 0; v < count; v++)
             {
-                prevPriority = priority;
-                bestCandidate = candidate;
+                outNormals[(first + v) * 3] = sums[0][v];
+                outNormals[(first + v) * 3 + 1] = sums[1][v];
+                outNormals[(first + v) * 3 + 2] = sums[2][v];
             }
         }
+    });
+}
+
+AABB MeshUtils::CreateBoundingBox(const std::vector<MeshVertex>& vertices)
+{
+    if (vertices.empty())
+    {
+        return {.minPoint = Vec3f(0.f), .maxPoint = Vec3f(0.f)};
     }
 
-    if (bestCandidate == -1)
+    // The position is followed by the padding of the aligned normal, so 4 floats can be always loaded.
+    // Two accumulators are used to hide the latency of min/max.
+    __m128 minPoint[2], maxPoint[2];
+    minPoint[0] = minPoint[1] = maxPoint[0] = maxPoint[1] = _mm_loadu_ps(&vertices[0].Position.x);
+
+    const size_t count = vertices.size();
+    size_t i = 0;
+
+    for (; i + 1 < count; i += 2)
+    {
+        const __m128 a = _mm_loadu_ps(&vertices[i].Position.x);
+        const __m128 b = _mm_loadu_ps(&vertices[i + 1].Position.x);
+
+        minPoint[0] = _mm_min_ps(minPoint[0], a);
+        maxPoint[0] = _mm_max_ps(maxPoint[0], a);
+        minPoint[1] = _mm_min_ps(minPoint[1], b);
+        maxPoint[1] = _mm_max_ps(maxPoint[1], b);
+    }
+
+    if (i < count)
     {
-        bestCandidate = MeshUtils::SkipDeadEnd(liveTriangles, stack, vertexCount, i);
+        const __m128 a = _mm_loadu_ps(&vertices[i].Position.x);
+
+        minPoint[0] = _mm_min_ps(minPoint[0], a);
+        maxPoint[0] = _mm_max_ps(maxPoint[0], a);
     }
 
-    return bestCandidate;
+    alignas(16) float finalMin[4], finalMax[4];
+    _mm_store_ps(finalMin, _mm_min_ps(minPoint[0], minPoint[1]));
+    _mm_store_ps(finalMax, _mm_max_ps(maxPoint[0], maxPoint[1]));
+
+    return {
+        .minPoint = Vec3f(finalMin[0], finalMin[1], finalMin[2]),
+        .maxPoint = Vec3f(finalMax[0], finalMax[1], finalMax[2]),
+    };
 }
 
-int MeshUtils::SkipDeadEnd(const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack,
-                           const uint32_t vertexCount, uint32_t i)
+AABB MeshUtils::CreateBoundingBox(const MeshPositions& positions)
 {
-    while (!stack.empty())
+    const size_t count = positions.GetCount();
+
+    if (count == 0)
+    {
+        return {.minPoint = Vec3f(0.f), .maxPoint = Vec3f(0.f)};
+    }
+
+    const float* axes[3] = {positions.x.data(), positions.y.data(), positions.z.data()};
+    float finalMin[3], finalMax[3];
+
+    for (uint32_t axis = 0; axis < 3; axis++)
     {
+        const float* values = axes[axis];
 
-        const uint32_t d = stack.back();
-        stack.pop();
+        __m128 minValue = _mm_set1_ps(values[0]);
+        __m128 maxValue = minValue;
 
-        if (liveTriangles[d] > 0)
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
         {
-            return d;
+            const __m128 v = _mm_loadu_ps(values + i);
+
+            minValue = _mm_min_ps(minValue, v);
+            maxValue = _mm_max_ps(maxValue, v);
         }
-    }
 
-    while (i < liveTriangles.size())
-    {
-        if (liveTriangles[i] > 0)
+        // The tail is broadcast to all the lanes, which doesn't change the result.
+        for (; i < count; i++)
         {
-            return i;
+            const __m128 v = _mm_set1_ps(values[i]);
+
+            minValue = _mm_min_ps(minValue, v);
+            maxValue = _mm_max_ps(maxValue, v);
         }
 
-        i++;
+        alignas(16) float lanes[2][4];
+        _mm_store_ps(lanes[0], minValue);
+        _mm_store_ps(lanes[1], maxValue);
+
+        finalMin[axis] = std::min(std::min(lanes[0][0], lanes[0][1]), std::min(lanes[0][2], lanes[0][3]));
+        finalMax[axis] = std::max(std::max(lanes[1][0], lanes[1][1]), std::max(lanes[1][2], lanes[1][3]));
     }
 
-    return -1;
+    return {
+        .minPoint = Vec3f(finalMin[0], finalMin[1], finalMin[2]),
+        .maxPoint = Vec3f(finalMax[0], finalMax[1], finalMax[2]),
+    };
 }
 
 uint32_t MeshUtils::PackTriangleIntoUInt(const uint32_t a, const uint32_t b, const uint32_t c)
@@ -1,28 +1,254 @@
+#pragma once
 
 #include <cstddef>
 #include <cstdint>
-#include <queue>
-#include <unordered_map>
+#include <iterator>
 #include <vector>
+#include "EdgeAdjacency.h"
+#include "MeshResidency.h"
+#include "MeshVertex.h"
+#include "Model/Structures/AABB.h"
 #include "VertexTriangleAdjacency.h"
 
+struct VertexCacheStatistics
+{
+    // Average cache miss ratio - transformed vertices per triangle. Between 0.5 (best) and 3 (worst).
+    float acmr = 0.f;
+    // Average transform to vertex ratio - transformed vertices per unique vertex. 1 is the best.
+    float atvr = 0.f;
+    size_t transformedVertices = 0;
+};
+
+struct VertexFetchStatistics
+{
+    // Bytes read from the memory in whole cache lines.
+    size_t bytesFetched = 0;
+    // Bytes fetched per byte of the referenced vertices. 1 is the best.
+    float overfetch = 0.f;
+};
+
+/**
+ * Replacement policy of the simulated post-transform vertex cache.
+ */
+enum class EVertexCacheModel : uint8_t
+{
+    // A hit doesn't move the vertex, the oldest transformed vertex gets replaced (most of the hardware).
+    Fifo = 0,
+    // A hit moves the vertex to the front, the least recently used one gets replaced.
+    Lru = 1,
+};
+
+/**
+ * Working memory of MeshUtils::Tipsify. Reusing it across calls (e.g. for all the LODs of a mesh) avoids allocating
+ * it again for every index buffer, the buffers only grow.
+ */
+struct TipsifyScratch
+{
+    VertexTriangleAdjacency adjacency;
+    std::vector<uint32_t> liveTriangles;
+    std::vector<uint32_t> cacheTimeStamps;
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint8_t> emittedTriangles;
+};
+
 class MeshUtils
 {
 
   public:
+    /**
+     * @brief Builds the triangles adjacent to every vertex. The adjacency keeps a view of the indices, they have to
+     * outlive it.
+     */
     static VertexTriangleAdjacency BuildVertexTriangleAdjacency(const std::vector<uint32_t>& indices,
                                                                 const size_t numOfVertices);
 
+    /**
+     * @brief Builds the adjacency into the existing storage of outAdjacency, reusing its memory. The indices are
+     * not copied, outAdjacency only keeps a view of them.
+     */
+    static void BuildVertexTriangleAdjacency(const uint32_t* indices, const size_t indexCount,
+                                             const size_t numOfVertices, VertexTriangleAdjacency& outAdjacency);
+
+    /**
+     * @brief Parallel version of the above with the same result - the triangles of every vertex are sorted
+     * by their index. Every thread counts the vertex references of its part of the triangles into its own
+     * histogram, the histograms are turned into write cursors by a parallel prefix sum and every thread then fills
+     * in its triangles. Small meshes are built serially.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     */
+    static void BuildVertexTriangleAdjacencyParallel(const uint32_t* indices, const size_t indexCount,
+                                                     const size_t numOfVertices,
+                                                     VertexTriangleAdjacency& outAdjacency,
+                                                     const uint32_t threadCount = 0);
+
+    /**
+     * @brief Pairs up the half-edges of the triangles (see EdgeAdjacency) using the vertex-triangle adjacency of
+     * the same indices. The half-edge a->b gets paired with b->a only if both of them are unique, so the boundary
+     * and the non-manifold edges end up without an opposite half-edge, as do all the edges of degenerate triangles.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     */
+    static void BuildEdgeAdjacency(const uint32_t* indices, const size_t indexCount,
+                                   const VertexTriangleAdjacency& vertexAdjacency, EdgeAdjacency& outEdges,
+                                   const uint32_t threadCount = 0);
+
+    /**
+     * @brief Reorders the triangles for the post-transform vertex cache with the Tipsify algorithm
+     * (Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw).
+     * @param cacheSize - number of entries of the targeted vertex cache
+     */
     static std::vector<uint32_t> Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
                                          const uint32_t cacheSize);
 
-    static int GetNextVertex(const uint32_t vertexCount, uint32_t i, const uint32_t cacheSize,
-                             const std::unordered_map<uint32_t, bool>& candidates,
-                             const std::vector<uint32_t>& timeStamps, uint32_t& timeStamp,
-                             const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack);
+    /**
+     * @brief Same as above, but with the working memory of a previous call.
+     */
+    static std::vector<uint32_t> Tipsify(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                         const uint32_t cacheSize, TipsifyScratch& scratch);
+
+    /**
+     * @brief Allocation-free Tipsify, once the scratch is large enough.
+     * @param outIndices - has to hold indexCount indices, must not overlap with the indices.
+     */
+    static void Tipsify(const uint32_t* indices, const size_t indexCount, const uint32_t vertexCount,
+                        const uint32_t cacheSize, TipsifyScratch& scratch, uint32_t* outIndices);
+
+    /**
+     * @brief Simulates a post-transform vertex cache over the index buffer.
+     * @param vertexCount - number of vertices the indices reference
+     * @param cacheSize - number of entries of the simulated cache
+     */
+    static VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                                    const uint32_t cacheSize,
+                                                    const EVertexCacheModel model = EVertexCacheModel::Fifo);
+
+    /**
+     * @brief Reorders the vertices by their first reference in the indices and rewrites the indices, so the vertex
+     * reads (and the meshlet vertex references built from the indices afterwards) become mostly sequential. Run
+     * it after the vertex cache optimization. The vertices not referenced by any index are removed.
+     */
+    template <typename TVertex>
+    static void OptimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<TVertex>& vertices)
+    {
+        std::vector<uint32_t> remap;
+        const size_t uniqueVertexCount = BuildVertexFetchRemap(indices, vertices.size(), remap);
+
+        std::vector<TVertex> remappedVertices(uniqueVertexCount);
+
+        for (size_t v = 0; v < vertices.size(); v++)
+        {
+            if (remap[v] != UNUSED_VERTEX)
+            {
+                remappedVertices[remap[v]] = vertices[v];
+            }
+        }
+
+        for (uint32_t& index : indices)
+        {
+            index = remap[index];
+        }
+
+        vertices = std::move(remappedVertices);
+    }
+
+    /**
+     * @brief Creates the remap table used by OptimizeVertexFetch, new index of every vertex in the order of the
+     * first reference, or UNUSED_VERTEX.
+     * @return number of the referenced vertices.
+     */
+    static size_t BuildVertexFetchRemap(const std::vector<uint32_t>& indices, const size_t vertexCount,
+                                        std::vector<uint32_t>& outRemap);
+
+    /**
+     * @brief Simulates the vertex reads in the order of the indices through a direct-mapped cache of whole cache
+     * lines. Use the meshlet vertex references as the indices to get the fetches of the mesh shaders.
+     * @param vertexSize - stride of the vertices in bytes
+     * @param cacheLineCount - number of lines of the simulated cache (16 KiB with the defaults)
+     */
+    static VertexFetchStatistics AnalyzeVertexFetch(const std::vector<uint32_t>& indices, const size_t vertexCount,
+                                                    const size_t vertexSize, const size_t cacheLineSize = 64,
+                                                    const size_t cacheLineCount = 256);
+
+    static constexpr uint32_t UNUSED_VERTEX = 0xFFFFFFFF;
+
+    /**
+     * @brief Computes smooth vertex normals as the area weighted average of the normals of the adjacent triangles,
+     * replaces aiProcess_GenNormals. Run it after welding, the normals are only smooth across shared vertices.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     */
+    template <typename TVertex>
+    static void GenerateNormals(const std::vector<uint32_t>& indices, std::vector<TVertex>& vertices,
+                                const uint32_t threadCount = 0)
+    {
+        std::vector<float> positions(vertices.size() * 3);
+        std::vector<float> normals(vertices.size() * 3);
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            positions[i * 3] = vertices[i].Position.x;
+            positions[i * 3 + 1] = vertices[i].Position.y;
+            positions[i * 3 + 2] = vertices[i].Position.z;
+        }
+
+        GenerateNormals(indices.data(), indices.size(), positions.data(), vertices.size(), normals.data(),
+                        threadCount);
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            vertices[i].Normal.x = normals[i * 3];
+            vertices[i].Normal.y = normals[i * 3 + 1];
+            vertices[i].Normal.z = normals[i * 3 + 2];
+        }
+    }
+
+    /**
+     * @brief The cross products and the normalization are done 8 at a time with AVX. The vertices without any
+     * triangle (or only with degenerate ones) get a zero normal.
+     * @param positions, outNormals - 3 floats per vertex
+     */
+    static void GenerateNormals(const uint32_t* indices, const size_t indexCount, const float* positions,
+                                const size_t vertexCount, float* outNormals, const uint32_t threadCount = 0);
+
+    /**
+     * @brief Computes the axis aligned bounding box of the vertex positions.
+     */
+    static AABB CreateBoundingBox(const std::vector<MeshVertex>& vertices);
+
+    /**
+     * @brief Same for the positions kept by EMeshResidency::PositionsOnly, every axis 4 floats at a time.
+     */
+    static AABB CreateBoundingBox(const MeshPositions& positions);
+
+    /**
+     * @brief Moves the parts (e.g. the arrays of the LODs) into one array reserved once for the sum of their sizes.
+     * Every part is freed as soon as it is appended, a single part is moved without a copy.
+     */
+    template <typename T>
+    static std::vector<T> Concatenate(std::vector<std::vector<T>>& parts)
+    {
+        if (parts.size() == 1)
+        {
+            return std::move(parts[0]);
+        }
+
+        size_t totalSize = 0;
+
+        for (const std::vector<T>& part : parts)
+        {
+            totalSize += part.size();
+        }
+
+        std::vector<T> concatenated;
+        concatenated.reserve(totalSize);
+
+        for (std::vector<T>& part : parts)
+        {
+            concatenated.insert(concatenated.end(), std::make_move_iterator(part.begin()),
+                                std::make_move_iterator(part.end()));
+            std::vector<T>().swap(part);
+        }
 
-    static int SkipDeadEnd(const std::vector<uint32_t>& liveTriangles, std::queue<uint32_t>& stack,
-                           const uint32_t vertexCount, uint32_t i);
+        return concatenated;
+    }
 
     static uint32_t PackTriangleIntoUInt(const uint32_t a, const uint32_t b, const uint32_t c);
     static uint32_t UnpackTriangleFromUInt(const uint32_t triangle);
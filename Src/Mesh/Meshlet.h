@@ -20,14 +20,82 @@ struct NewMeshlet
 	uint32_t triangleCount = 0;
 };
 
+/**
+ * Meshlet of the compact encoding (see MeshletEncoding). Vertex references are stored as 16-bit deltas from the
+ * vertexBase and triangles as 3 bytes, both streams are read by 32-bit words on the GPU.
+ */
+struct CompactMeshlet
+{
+	// Added to every vertex reference of the meshlet.
+	uint32_t vertexBase = 0;
+	// Offset into the vertex reference stream in 16-bit units.
+	uint32_t vertexOffset = 0;
+	// Offset into the triangle stream in bytes.
+	uint32_t triangleOffset = 0;
+	// Vertex count (bits 0-7), triangle count (bits 8-15) and flags (bits 16-23).
+	uint32_t packedCounts = 0;
+
+	// The vertex references didn't fit into 16 bits. Every reference takes two slots (low and high half)
+	// and the vertexBase is 0.
+	static constexpr uint32_t WIDE_VERTICES_FLAG = 1 << 16;
+
+	uint32_t GetVertexCount() const
+	{
+		return packedCounts & 0xFF;
+	}
+
+	uint32_t GetTriangleCount() const
+	{
+		return (packedCounts >> 8) & 0xFF;
+	}
+
+	bool HasWideVertices() const
+	{
+		return (packedCounts & WIDE_VERTICES_FLAG) != 0;
+	}
+};
+
 struct MeshletBounds
 {
+	// Axis of the normal cone (normalized average of the triangle normals).
 	alignas(16) glm::vec3 normal;
-	float coneAngle;
+	// The meshlet is entirely backfacing when dot(normalize(coneApex - cameraPos), normal) >= coneCutoff.
+	// Values above 1 mean that the cone is too wide and the meshlet can not be culled this way.
+	float coneCutoff;
 	alignas(16) glm::vec3 spherePos;
 	float sphereRadius;
+	alignas(16) glm::vec3 coneApex;
 
 	// We have to be carefull around the std430 layout since it is 4-base. (16 bytes)
 	// and in the array it would throw off the offsets
-	//alignas(16) glm::vec3 normalPos;
+};
+
+/**
+ * Bounds of a run of up to Constants::MESHLET_GROUP_SIZE meshlets (see MeshletGrouping). The sphere contains the
+ * spheres of all the meshlets and the cone is culled only when every meshlet of the group would be, so a task shader
+ * workgroup can reject the whole group with one test before testing the meshlets one by one.
+ */
+struct MeshletGroup
+{
+	MeshletBounds bounds;
+	uint32_t meshletOffset = 0;
+	uint32_t meshletCount = 0;
+};
+
+/**
+ * Node of the cluster LOD hierarchy (see ClusterLOD), one per meshlet. The clusters simplified together share the
+ * same parent values, so the decision whether to draw a cluster is the same for the whole group and the cut of
+ * the hierarchy has no cracks.
+ */
+struct LODCluster
+{
+	// Sphere of the group this cluster was created in and the error of that simplification (in world units).
+	alignas(16) glm::vec3 lodSpherePos;
+	float lodSphereRadius = 0.f;
+	float lodError = 0.f;
+	// Same values of the group this cluster was simplified into. The error is FLT_MAX for the roots.
+	alignas(16) glm::vec3 parentSpherePos;
+	float parentSphereRadius = 0.f;
+	float parentError = 0.f;
+	uint32_t level = 0;
 };
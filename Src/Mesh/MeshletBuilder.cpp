@@ -0,0 +1,101 @@
+#include "MeshletBuilder.h"
+
+#include "../Log/Log.h"
+#include "MeshUtils.h"
+
+MeshletBuilder::MeshletBuilder(const uint32_t maxVerts, const uint32_t maxIndices,
+                               std::vector<NewMeshlet>& outMeshlets, std::vector<uint32_t>& outVertices,
+                               std::vector<uint32_t>& outTriangles, const uint32_t vertexOffset,
+                               const uint32_t triangleOffset)
+    : m_MaxVerts(maxVerts), m_MaxTriangles(maxIndices / 3), m_VertexOffset(vertexOffset),
+      m_TriangleOffset(triangleOffset), m_Meshlets(outMeshlets), m_Vertices(outVertices), m_Triangles(outTriangles)
+{
+    ASSERT(maxVerts >= 3 && maxVerts <= 0xFF, "Meshlet vertex limit has to be in the range [3, 255]!")
+    ASSERT(m_MaxTriangles > 0, "Meshlet index limit has to allow at least one triangle!")
+
+    const uint32_t tableSize = GetTableSize(maxVerts);
+
+    m_TableMask = tableSize - 1;
+    m_TableShift = GetTableShift(tableSize);
+
+    m_SlotVertices.resize(tableSize, EMPTY_SLOT);
+    m_SlotLocalIndices.resize(tableSize, 0);
+    m_UsedSlots.reserve(maxVerts);
+}
+
+void MeshletBuilder::PushTriangle(const uint32_t a, const uint32_t b, const uint32_t c)
+{
+    // Degenerate triangles would otherwise count the same new vertex multiple times.
+    const uint32_t newVertices = (m_SlotVertices[FindSlot(a)] == EMPTY_SLOT) +
+                                 (m_SlotVertices[FindSlot(b)] == EMPTY_SLOT && b != a) +
+                                 (m_SlotVertices[FindSlot(c)] == EMPTY_SLOT && c != a && c != b);
+
+    if (m_Meshlet.vertexCount + newVertices > m_MaxVerts || m_Meshlet.triangleCount + 1 > m_MaxTriangles)
+    {
+        FlushMeshlet();
+    }
+
+    const uint8_t av = InsertVertex(a);
+    const uint8_t bv = InsertVertex(b);
+    const uint8_t cv = InsertVertex(c);
+
+    // --- Since GLSL doesn't support 8-bit integers we are packing triangles into a uint.
+    m_Triangles.emplace_back(MeshUtils::PackTriangleIntoUInt(av, bv, cv));
+    m_Meshlet.triangleCount++;
+}
+
+void MeshletBuilder::PushIndices(const uint32_t* indices, const size_t indexCount)
+{
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        PushTriangle(indices[i], indices[i + 1], indices[i + 2]);
+    }
+}
+
+void MeshletBuilder::Finish()
+{
+    if (m_Meshlet.triangleCount != 0)
+    {
+        FlushMeshlet();
+    }
+}
+
+uint32_t MeshletBuilder::FindSlot(const uint32_t vertex) const
+{
+    return ProbeSlot(m_SlotVertices.data(), vertex, m_TableShift, m_TableMask);
+}
+
+uint8_t MeshletBuilder::InsertVertex(const uint32_t vertex)
+{
+    const uint32_t slot = FindSlot(vertex);
+
+    if (m_SlotVertices[slot] == vertex)
+    {
+        return m_SlotLocalIndices[slot];
+    }
+
+    m_SlotVertices[slot] = vertex;
+    m_SlotLocalIndices[slot] = m_Meshlet.vertexCount;
+    m_UsedSlots.emplace_back(slot);
+
+    m_Vertices.emplace_back(vertex);
+
+    return m_Meshlet.vertexCount++;
+}
+
+void MeshletBuilder::FlushMeshlet()
+{
+    m_Meshlet.triangleOffset = (m_Triangles.size() - m_Meshlet.triangleCount) + m_TriangleOffset;
+    m_Meshlet.vertexOffset = (m_Vertices.size() - m_Meshlet.vertexCount) + m_VertexOffset;
+
+    m_Meshlets.push_back(m_Meshlet);
+    m_Meshlet = {};
+
+    // Only the slots used by the flushed meshlet have to be cleared.
+    for (const uint32_t slot : m_UsedSlots)
+    {
+        m_SlotVertices[slot] = EMPTY_SLOT;
+    }
+
+    m_UsedSlots.clear();
+}
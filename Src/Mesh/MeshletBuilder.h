@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Meshlet.h"
+
+/**
+ * Incremental version of the MeshletizeNv algorithm. Triangles are pushed into the builder one by one or in blocks, so
+ * the whole index buffer doesn't have to be in memory at once (it can be streamed from a file for example).
+ *
+ * The vertices of the meshlet being built are tracked in a small hash table local to the meshlet instead of a map
+ * over all of the mesh vertices. The memory used by the builder therefore doesn't depend on the size of the mesh and
+ * starting a new meshlet only clears the slots which were used by the previous one.
+ */
+class MeshletBuilder
+{
+  public:
+    /**
+     * @param maxVerts - maximum number of vertices in a meshlet. Can not be larger than 255, since the local indices
+     * are packed into bytes.
+     * @param maxIndices - maximum number of indices (3 per triangle) in a meshlet.
+     * @param outMeshlets - meshlets are appended here.
+     * @param outVertices - meshlet vertices (indices into the vertex buffer) are appended here.
+     * @param outTriangles - packed meshlet triangles (see MeshUtils::PackTriangleIntoUInt) are appended here.
+     * @param vertexOffset - added to the vertex offset of every meshlet.
+     * @param triangleOffset - added to the triangle offset of every meshlet.
+     */
+    MeshletBuilder(const uint32_t maxVerts, const uint32_t maxIndices, std::vector<NewMeshlet>& outMeshlets,
+                   std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outTriangles,
+                   const uint32_t vertexOffset = 0, const uint32_t triangleOffset = 0);
+
+    MeshletBuilder(const MeshletBuilder& other) = delete;
+    MeshletBuilder& operator=(const MeshletBuilder& other) = delete;
+
+    void PushTriangle(const uint32_t a, const uint32_t b, const uint32_t c);
+
+    /**
+     * @brief Pushes a block of indices. The count should be a multiple of 3, trailing indices are ignored.
+     */
+    void PushIndices(const uint32_t* indices, const size_t indexCount);
+
+    /**
+     * @brief Flushes the meshlet which is being built. Has to be called after the last triangle was pushed.
+     */
+    void Finish();
+
+    // --- The vertex hash table, shared with the fixed-size MeshletGeneration::Meshletize.
+
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+    /**
+     * @brief Smallest power of two table keeping the load factor under 0.5.
+     */
+    static constexpr uint32_t GetTableSize(const uint32_t maxVerts)
+    {
+        uint32_t tableSize = 16;
+
+        while (tableSize < maxVerts * 2)
+        {
+            tableSize *= 2;
+        }
+
+        return tableSize;
+    }
+
+    /**
+     * @brief Shift of the Fibonacci hash leaving log2(tableSize) bits.
+     */
+    static constexpr uint32_t GetTableShift(const uint32_t tableSize)
+    {
+        uint32_t shift = 32;
+
+        for (uint32_t size = tableSize; size > 1; size /= 2)
+        {
+            shift--;
+        }
+
+        return shift;
+    }
+
+    /**
+     * @brief Returns the slot in which the vertex is stored or the empty slot where it should be inserted.
+     * @param slotVertices - table of GetTableSize slots, the empty ones are EMPTY_SLOT.
+     */
+    static constexpr uint32_t ProbeSlot(const uint32_t* slotVertices, const uint32_t vertex, const uint32_t tableShift,
+                                        const uint32_t tableMask)
+    {
+        // Fibonacci hashing, the upper bits are the best mixed ones.
+        uint32_t slot = (vertex * 0x9E3779B1u) >> tableShift;
+
+        while (slotVertices[slot] != EMPTY_SLOT && slotVertices[slot] != vertex)
+        {
+            slot = (slot + 1) & tableMask;
+        }
+
+        return slot;
+    }
+
+  private:
+
+    uint32_t m_MaxVerts;
+    uint32_t m_MaxTriangles;
+    uint32_t m_VertexOffset;
+    uint32_t m_TriangleOffset;
+
+    std::vector<NewMeshlet>& m_Meshlets;
+    std::vector<uint32_t>& m_Vertices;
+    std::vector<uint32_t>& m_Triangles;
+
+    NewMeshlet m_Meshlet = {};
+
+    // Open addressing hash table (linear probing) mapping a mesh vertex to its local index in the meshlet.
+    uint32_t m_TableMask;
+    uint32_t m_TableShift;
+    std::vector<uint32_t> m_SlotVertices;
+    std::vector<uint8_t> m_SlotLocalIndices;
+    std::vector<uint32_t> m_UsedSlots;
+
+    uint32_t FindSlot(const uint32_t vertex) const;
+
+    /**
+     * @brief Adds the vertex into the current meshlet, if it isn't there yet.
+     * @return local index of the vertex in the meshlet.
+     */
+    uint8_t InsertVertex(const uint32_t vertex);
+    void FlushMeshlet();
+};
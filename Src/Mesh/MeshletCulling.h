@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Meshlet.h"
+#include "glm/ext/vector_float3.hpp"
+#include "glm/geometric.hpp"
+
+/**
+ * CPU reference of the per-meshlet culling tests. The shaders are expected to use the same math, so these can be used
+ * for validating the bounds or for culling on the CPU.
+ */
+class MeshletCulling
+{
+  public:
+    /**
+     * Tests the normal cone of the meshlet against the camera.
+     * @param bounds - bounds computed by MeshletGeneration::ComputeMeshletBounds
+     * @param cameraPosition - position of the camera in the same space as the bounds
+     * @return true if every triangle of the meshlet is backfacing and the meshlet can be culled.
+     */
+    static bool IsBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition)
+    {
+        const glm::vec3 toApex = bounds.coneApex - cameraPosition;
+        const float distance = glm::length(toApex);
+
+        // The camera sitting right in the apex would make the direction undefined.
+        if (distance <= 0.f)
+        {
+            return false;
+        }
+
+        return glm::dot(toApex, bounds.normal) >= bounds.coneCutoff * distance;
+    }
+};
@@ -0,0 +1,104 @@
+#include "MeshletEncoding.h"
+
+#include <algorithm>
+
+#include "Log/Log.h"
+
+CompactMeshletData MeshletEncoding::Encode(const std::vector<NewMeshlet>& meshlets,
+                                           const std::vector<uint32_t>& meshletVertices,
+                                           const std::vector<uint32_t>& meshletTriangles)
+{
+    CompactMeshletData data;
+    data.meshlets.reserve(meshlets.size());
+
+    size_t vertexCount = 0, triangleCount = 0;
+
+    for (const NewMeshlet& meshlet : meshlets)
+    {
+        vertexCount += meshlet.vertexCount;
+        triangleCount += meshlet.triangleCount;
+    }
+
+    data.vertices.reserve(vertexCount + 1);
+    data.triangles.reserve(triangleCount * 3 + 3);
+
+    for (const NewMeshlet& meshlet : meshlets)
+    {
+        ASSERT(meshlet.vertexCount <= 0xFF && meshlet.triangleCount <= 0xFF,
+               "Meshlet is too large for the compact encoding!")
+        ASSERT(meshlet.vertexOffset + meshlet.vertexCount <= meshletVertices.size() &&
+                   meshlet.triangleOffset + meshlet.triangleCount <= meshletTriangles.size(),
+               "Meshlet is out of bounds of the meshlet buffers!")
+
+        const uint32_t* vertices = &meshletVertices[meshlet.vertexOffset];
+
+        const auto [minVertex, maxVertex] = std::minmax_element(vertices, vertices + meshlet.vertexCount);
+        const bool wide = meshlet.vertexCount > 0 && *maxVertex - *minVertex > 0xFFFF;
+
+        CompactMeshlet compact = {
+            .vertexBase = wide || meshlet.vertexCount == 0 ? 0 : *minVertex,
+            .vertexOffset = static_cast<uint32_t>(data.vertices.size()),
+            .triangleOffset = static_cast<uint32_t>(data.triangles.size()),
+            .packedCounts = meshlet.vertexCount | (meshlet.triangleCount << 8) |
+                            (wide ? CompactMeshlet::WIDE_VERTICES_FLAG : 0),
+        };
+
+        for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+        {
+            if (wide)
+            {
+                data.vertices.emplace_back(vertices[v] & 0xFFFF);
+                data.vertices.emplace_back(vertices[v] >> 16);
+            }
+            else
+            {
+                data.vertices.emplace_back(vertices[v] - compact.vertexBase);
+            }
+        }
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const uint32_t triangle = meshletTriangles[meshlet.triangleOffset + t];
+
+            data.triangles.emplace_back(triangle & 0xFF);
+            data.triangles.emplace_back((triangle >> 8) & 0xFF);
+            data.triangles.emplace_back((triangle >> 16) & 0xFF);
+        }
+
+        data.meshlets.emplace_back(compact);
+    }
+
+    // --- The GPU reads both of the streams by 32-bit words.
+    data.vertices.resize((data.vertices.size() + 1) & ~size_t(1));
+    data.triangles.resize((data.triangles.size() + 3) & ~size_t(3));
+
+    return data;
+}
+
+void MeshletEncoding::Decode(const CompactMeshletData& data, std::vector<NewMeshlet>& outMeshlets,
+                             std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outTriangles)
+{
+    outMeshlets.reserve(outMeshlets.size() + data.meshlets.size());
+
+    for (const CompactMeshlet& compact : data.meshlets)
+    {
+        NewMeshlet meshlet = {
+            .vertexOffset = static_cast<uint32_t>(outVertices.size()),
+            .triangleOffset = static_cast<uint32_t>(outTriangles.size()),
+            .vertexCount = compact.GetVertexCount(),
+            .triangleCount = compact.GetTriangleCount(),
+        };
+
+        for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+        {
+            outVertices.emplace_back(DecodeVertex(data, compact, v));
+        }
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            outTriangles.emplace_back(DecodeTriangle(data, compact, t));
+        }
+
+        outMeshlets.emplace_back(meshlet);
+    }
+}
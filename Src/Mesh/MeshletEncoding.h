@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Meshlet.h"
+
+/**
+ * Meshlets in the compact encoding. The streams are padded to whole 32-bit words, so they can be uploaded
+ * into storage buffers as they are.
+ */
+struct CompactMeshletData
+{
+    std::vector<CompactMeshlet> meshlets;
+    // 16-bit vertex references, relative to the vertexBase of the meshlet.
+    std::vector<uint16_t> vertices;
+    // 3 bytes (local vertex indices) per triangle.
+    std::vector<uint8_t> triangles;
+
+    size_t GetSizeInBytes() const
+    {
+        return meshlets.size() * sizeof(CompactMeshlet) + vertices.size() * sizeof(uint16_t) +
+               triangles.size() * sizeof(uint8_t);
+    }
+};
+
+/**
+ * Converts the meshlets between the 32-bit layout produced by MeshletGeneration and the compact one.
+ * The decoding functions mirror the ones in Res/Shaders/include/meshlet_encoding.glsl.
+ */
+class MeshletEncoding
+{
+  public:
+    /**
+     * @brief Encodes the meshlets. The offsets of the meshlets don't have to be contiguous, the data is repacked
+     * in the order of the meshlets.
+     * @param meshletTriangles - triangles packed into a uint (see MeshUtils::PackTriangleIntoUInt)
+     */
+    static CompactMeshletData Encode(const std::vector<NewMeshlet>& meshlets,
+                                     const std::vector<uint32_t>& meshletVertices,
+                                     const std::vector<uint32_t>& meshletTriangles);
+
+    /**
+     * @brief Decodes the meshlets back into the 32-bit layout. The output is appended to the vectors.
+     */
+    static void Decode(const CompactMeshletData& data, std::vector<NewMeshlet>& outMeshlets,
+                       std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outTriangles);
+
+    /**
+     * @brief Returns the index into the vertex buffer of the given meshlet vertex.
+     */
+    static uint32_t DecodeVertex(const CompactMeshletData& data, const CompactMeshlet& meshlet,
+                                 const uint32_t localIndex)
+    {
+        if (meshlet.HasWideVertices())
+        {
+            const uint32_t slot = meshlet.vertexOffset + localIndex * 2;
+            return data.vertices[slot] | (static_cast<uint32_t>(data.vertices[slot + 1]) << 16);
+        }
+
+        return meshlet.vertexBase + data.vertices[meshlet.vertexOffset + localIndex];
+    }
+
+    /**
+     * @brief Returns the triangle packed the same way as MeshUtils::PackTriangleIntoUInt does it.
+     */
+    static uint32_t DecodeTriangle(const CompactMeshletData& data, const CompactMeshlet& meshlet,
+                                   const uint32_t triangleIndex)
+    {
+        const uint8_t* triangle = &data.triangles[meshlet.triangleOffset + triangleIndex * 3];
+        return triangle[0] | (triangle[1] << 8) | (triangle[2] << 16);
+    }
+};
@@ -1,6 +1,7 @@
 
 #include "MeshletGeneration.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -12,6 +13,9 @@
 #include "Mesh/MeshVertex.h"
 #include "Mesh/Meshlet.h"
 #include "MeshUtils.h"
+#include "MeshletBuilder.h"
+#include "ThreadUtils.h"
+#include "glm/geometric.hpp"
 
 std::vector<NewMeshlet> MeshletGeneration::MeshletizeNv(uint32_t maxVerts, uint32_t maxIndices,
                                                         const std::vector<uint32_t>& indices,
@@ -19,75 +23,451 @@ std::vector<NewMeshlet> MeshletGeneration::MeshletizeNv(uint32_t maxVerts, uint3
                                                         std::vector<uint32_t>& outIndices, const uint32_t vertexOffset,
                                                         const uint32_t triangleOffset)
 {
-    outVertices.reserve(verticesSize);
-    outIndices.reserve(indices.size());
+    return MeshletizeNv(maxVerts, maxIndices, indices.data(), indices.size(), verticesSize, outVertices, outIndices,
+                        vertexOffset, triangleOffset);
+}
+
+std::vector<NewMeshlet> MeshletGeneration::MeshletizeNv(uint32_t maxVerts, uint32_t maxIndices,
+                                                        const uint32_t* indices, const size_t indexCount,
+                                                        const uint32_t verticesSize, std::vector<uint32_t>& outVertices,
+                                                        std::vector<uint32_t>& outIndices, const uint32_t vertexOffset,
+                                                        const uint32_t triangleOffset)
+{
+    outVertices.reserve(outVertices.size() + std::min<size_t>(verticesSize, indexCount));
+    outIndices.reserve(outIndices.size() + indexCount / 3);
+
+    // The default limits have a specialized version.
+    if (maxVerts == Constants::MAX_MESHLET_VERTICES && maxIndices == Constants::MAX_MESHLET_INDICES)
+    {
+        return Meshletize<Constants::MAX_MESHLET_VERTICES, Constants::MAX_MESHLET_TRIANGLES>(
+            indices, indexCount, outVertices, outIndices, vertexOffset, triangleOffset);
+    }
 
     std::vector<NewMeshlet> meshlets;
-    std::vector<uint8_t> vertices(verticesSize, 0xFF);
 
-    NewMeshlet meshlet;
+    MeshletBuilder builder(maxVerts, maxIndices, meshlets, outVertices, outIndices, vertexOffset, triangleOffset);
 
-    for (uint32_t i = 0; i < indices.size(); i += 3)
-    {
+    builder.PushIndices(indices, indexCount);
+    builder.Finish();
 
-        uint32_t a = indices[i + 0];
-        uint32_t b = indices[i + 1];
-        uint32_t c = indices[i + 2];
+    return meshlets;
+}
 
-        uint8_t& av = vertices[a];
-        uint8_t& bv = vertices[b];
-        uint8_t& cv = vertices[c];
+template <uint32_t MaxVerts, uint32_t MaxTris>
+std::vector<NewMeshlet> MeshletGeneration::Meshletize(const uint32_t* indices, const size_t indexCount,
+                                                      std::vector<uint32_t>& outVertices,
+                                                      std::vector<uint32_t>& outTriangles,
+                                                      const uint32_t vertexOffset, const uint32_t triangleOffset)
+{
+    static_assert(MaxVerts >= 3 && MaxVerts <= 0xFF, "Meshlet vertex limit has to be in the range [3, 255]!");
+    static_assert(MaxTris > 0, "Meshlet has to allow at least one triangle!");
 
-        if ((meshlet.vertexCount + (av == 0xFF) + (bv == 0xFF) + (cv == 0xFF) > maxVerts) ||
-            (meshlet.triangleCount + 1 > maxIndices / 3))
-        {
-            meshlet.triangleOffset = (outIndices.size() - meshlet.triangleCount) + triangleOffset;
-            meshlet.vertexOffset = (outVertices.size() - meshlet.vertexCount) + vertexOffset;
+    constexpr uint32_t TableSize = MeshletBuilder::GetTableSize(MaxVerts);
+    constexpr uint32_t TableShift = MeshletBuilder::GetTableShift(TableSize);
+    constexpr uint32_t TableMask = TableSize - 1;
+    constexpr uint32_t EmptySlot = MeshletBuilder::EMPTY_SLOT;
 
-            meshlets.push_back(meshlet);
-            memset(vertices.data(), 0xFF, verticesSize);
+    // --- The whole state of the meshlet being built lives on the stack. It is copied into the output once full.
+    uint32_t slotVertices[TableSize];
+    uint8_t slotLocalIndices[TableSize];
+    uint32_t usedSlots[MaxVerts];
+    uint32_t vertices[MaxVerts];
+    uint32_t triangles[MaxTris];
 
-            meshlet = {};
-        }
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
 
-        if (av == 0xFF)
+    std::fill(slotVertices, slotVertices + TableSize, EmptySlot);
+
+    std::vector<NewMeshlet> meshlets;
+    meshlets.reserve(indexCount / 3 / MaxTris + 1);
+
+    outVertices.reserve(outVertices.size() + std::min<size_t>(indexCount, indexCount / 3 / MaxTris * MaxVerts + MaxVerts));
+    outTriangles.reserve(outTriangles.size() + indexCount / 3);
+
+    const auto findSlot = [&](const uint32_t vertex) {
+        return MeshletBuilder::ProbeSlot(slotVertices, vertex, TableShift, TableMask);
+    };
+
+    const auto flush = [&]() {
+        meshlets.emplace_back(NewMeshlet{
+            .vertexOffset = static_cast<uint32_t>(outVertices.size()) + vertexOffset,
+            .triangleOffset = static_cast<uint32_t>(outTriangles.size()) + triangleOffset,
+            .vertexCount = vertexCount,
+            .triangleCount = triangleCount,
+        });
+
+        outVertices.insert(outVertices.end(), vertices, vertices + vertexCount);
+        outTriangles.insert(outTriangles.end(), triangles, triangles + triangleCount);
+
+        for (uint32_t i = 0; i < vertexCount; i++)
         {
-            av = meshlet.vertexCount;
-            outVertices.emplace_back(a);
-            meshlet.vertexCount++;
+            slotVertices[usedSlots[i]] = EmptySlot;
         }
 
-        if (bv == 0xFF)
+        vertexCount = 0;
+        triangleCount = 0;
+    };
+
+    const auto insert = [&](const uint32_t vertex, const uint32_t slot) -> uint32_t {
+        if (slotVertices[slot] == EmptySlot)
         {
-            bv = meshlet.vertexCount;
-            outVertices.emplace_back(b);
-            meshlet.vertexCount++;
+            slotVertices[slot] = vertex;
+            slotLocalIndices[slot] = vertexCount;
+            usedSlots[vertexCount] = slot;
+            vertices[vertexCount++] = vertex;
         }
 
-        if (cv == 0xFF)
+        return slotLocalIndices[slot];
+    };
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+
+        // Degenerate triangles would otherwise count the same new vertex multiple times.
+        const uint32_t newVertices = (slotVertices[findSlot(a)] == EmptySlot) +
+                                     (slotVertices[findSlot(b)] == EmptySlot && b != a) +
+                                     (slotVertices[findSlot(c)] == EmptySlot && c != a && c != b);
+
+        if (vertexCount + newVertices > MaxVerts || triangleCount == MaxTris)
         {
-            cv = meshlet.vertexCount;
-            outVertices.emplace_back(c);
-            meshlet.vertexCount++;
+            flush();
         }
 
+        // Inserting a vertex can occupy the slot the next one would have probed, so the slots are looked up again.
+        const uint32_t av = insert(a, findSlot(a));
+        const uint32_t bv = insert(b, findSlot(b));
+        const uint32_t cv = insert(c, findSlot(c));
+
         // --- Since GLSL doesn't support 8-bit integers we are packing triangles into a uint.
-        outIndices.emplace_back(MeshUtils::PackTriangleIntoUInt(av, bv, cv));
+        triangles[triangleCount++] = av | (bv << 8) | (cv << 16);
+    }
 
-        meshlet.triangleCount++;
+    if (triangleCount != 0)
+    {
+        flush();
+    }
+
+    return meshlets;
+}
+
+// Explicit instantiations of the common limits. 64/128 are the engine defaults (see Constants.h).
+template std::vector<NewMeshlet> MeshletGeneration::Meshletize<64, 84>(const uint32_t*, const size_t,
+                                                                       std::vector<uint32_t>&,
+                                                                       std::vector<uint32_t>&, const uint32_t,
+                                                                       const uint32_t);
+template std::vector<NewMeshlet> MeshletGeneration::Meshletize<64, 126>(const uint32_t*, const size_t,
+                                                                        std::vector<uint32_t>&,
+                                                                        std::vector<uint32_t>&, const uint32_t,
+                                                                        const uint32_t);
+template std::vector<NewMeshlet> MeshletGeneration::Meshletize<64, 128>(const uint32_t*, const size_t,
+                                                                        std::vector<uint32_t>&,
+                                                                        std::vector<uint32_t>&, const uint32_t,
+                                                                        const uint32_t);
+template std::vector<NewMeshlet> MeshletGeneration::Meshletize<128, 256>(const uint32_t*, const size_t,
+                                                                         std::vector<uint32_t>&,
+                                                                         std::vector<uint32_t>&, const uint32_t,
+                                                                         const uint32_t);
+
+std::vector<NewMeshlet> MeshletGeneration::MeshletizeNvParallel(uint32_t maxVerts, uint32_t maxIndices,
+                                                                const std::vector<uint32_t>& indices,
+                                                                const uint32_t verticesSize,
+                                                                std::vector<uint32_t>& outVertices,
+                                                                std::vector<uint32_t>& outIndices,
+                                                                const uint32_t threadCount, const uint32_t vertexOffset,
+                                                                const uint32_t triangleOffset)
+{
+    const size_t chunkIndices = Constants::MESHLETIZE_CHUNK_TRIANGLES * 3;
+    const size_t chunkCount = (indices.size() + chunkIndices - 1) / chunkIndices;
+
+    if (chunkCount <= 1)
+    {
+        return MeshletizeNv(maxVerts, maxIndices, indices, verticesSize, outVertices, outIndices, vertexOffset,
+                            triangleOffset);
+    }
+
+    struct ChunkResult
+    {
+        std::vector<NewMeshlet> meshlets;
+        std::vector<uint32_t> vertices;
+        std::vector<uint32_t> triangles;
+    };
+
+    std::vector<ChunkResult> chunks(chunkCount);
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunkIndex, const uint32_t) {
+        const size_t first = chunkIndex * chunkIndices;
+        const size_t count = std::min(chunkIndices, indices.size() - first);
+
+        ChunkResult& chunk = chunks[chunkIndex];
+        chunk.meshlets = MeshletizeNv(maxVerts, maxIndices, indices.data() + first, count, verticesSize,
+                                      chunk.vertices, chunk.triangles);
+    });
+
+    // Merge the chunks in their original order, so the output doesn't depend on the scheduling.
+    size_t meshletCount = 0, vertexCount = 0, triangleCount = 0;
+
+    for (const ChunkResult& chunk : chunks)
+    {
+        meshletCount += chunk.meshlets.size();
+        vertexCount += chunk.vertices.size();
+        triangleCount += chunk.triangles.size();
+    }
+
+    std::vector<NewMeshlet> meshlets;
+    meshlets.reserve(meshletCount);
+    outVertices.reserve(outVertices.size() + vertexCount);
+    outIndices.reserve(outIndices.size() + triangleCount);
+
+    for (ChunkResult& chunk : chunks)
+    {
+        const uint32_t chunkVertexOffset = outVertices.size() + vertexOffset;
+        const uint32_t chunkTriangleOffset = outIndices.size() + triangleOffset;
+
+        for (NewMeshlet& meshlet : chunk.meshlets)
+        {
+            meshlet.vertexOffset += chunkVertexOffset;
+            meshlet.triangleOffset += chunkTriangleOffset;
+            meshlets.emplace_back(meshlet);
+        }
+
+        outVertices.insert(outVertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        outIndices.insert(outIndices.end(), chunk.triangles.begin(), chunk.triangles.end());
+
+        chunk = {};
+    }
+
+    return meshlets;
+}
+
+std::vector<NewMeshlet> MeshletGeneration::MeshletizeSpatial(uint32_t maxVerts, uint32_t maxIndices,
+                                                             const std::vector<uint32_t>& indices,
+                                                             const std::vector<MeshVertex>& vertices,
+                                                             std::vector<uint32_t>& outVertices,
+                                                             std::vector<uint32_t>& outIndices, const float coneWeight,
+                                                             const uint32_t vertexOffset, const uint32_t triangleOffset)
+{
+    const uint32_t maxTriangles = maxIndices / 3;
+    const size_t triangleCount = indices.size() / 3;
+
+    std::vector<NewMeshlet> meshlets;
+
+    if (triangleCount == 0)
+    {
+        return meshlets;
     }
 
-    if (meshlet.triangleCount != 0)
+    VertexTriangleAdjacency adjacency;
+    MeshUtils::BuildVertexTriangleAdjacencyParallel(indices.data(), indices.size(), vertices.size(), adjacency);
+
+    // --- Per triangle centroids and unit normals.
+    std::vector<glm::vec3> centroids(triangleCount);
+    std::vector<glm::vec3> normals(triangleCount);
+
+    float meshArea = 0.f;
+
+    for (size_t t = 0; t < triangleCount; t++)
     {
+        const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+        const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+        const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+        const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float doubleArea = glm::length(normal);
+
+        centroids[t] = (p0 + p1 + p2) / 3.f;
+        normals[t] = doubleArea > 0.f ? normal / doubleArea : glm::vec3(0.f);
+
+        meshArea += doubleArea * 0.5f;
+    }
+
+    // Radius of a meshlet if it was a disc made of average sized triangles. Used to normalize the distances.
+    const float expectedRadius = std::max(std::sqrt(meshArea / triangleCount * maxTriangles) * 0.5f, 1e-6f);
+
+    std::vector<uint32_t> liveTriangles(adjacency.vertexCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint8_t> localIndices(vertices.size(), 0xFF);
+
+    outVertices.reserve(outVertices.size() + vertices.size());
+    outIndices.reserve(outIndices.size() + triangleCount);
+
+    NewMeshlet meshlet;
+    glm::vec3 centroidSum(0.f), normalSum(0.f);
+
+    constexpr uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+    uint32_t lastTriangle = NO_TRIANGLE;
+    size_t seedCursor = 0;
+
+    auto flushMeshlet = [&]() {
         meshlet.triangleOffset = (outIndices.size() - meshlet.triangleCount) + triangleOffset;
         meshlet.vertexOffset = (outVertices.size() - meshlet.vertexCount) + vertexOffset;
 
         meshlets.push_back(meshlet);
+
+        for (size_t v = outVertices.size() - meshlet.vertexCount; v < outVertices.size(); v++)
+        {
+            localIndices[outVertices[v]] = 0xFF;
+        }
+
+        meshlet = {};
+        centroidSum = glm::vec3(0.f);
+        normalSum = glm::vec3(0.f);
+    };
+
+    // Finds the best not yet emitted triangle adjacent to the given vertices.
+    auto findCandidate = [&](const uint32_t* candidateVertices, const size_t candidateCount) {
+        const glm::vec3 center = centroidSum / static_cast<float>(std::max(meshlet.triangleCount, 1u));
+        const float normalLength = glm::length(normalSum);
+        const glm::vec3 axis = normalLength > 0.f ? normalSum / normalLength : glm::vec3(0.f);
+
+        uint32_t bestTriangle = NO_TRIANGLE;
+        uint32_t bestExtra = 0xFF;
+        float bestScore = std::numeric_limits<float>::max();
+
+        for (size_t i = 0; i < candidateCount; i++)
+        {
+            const uint32_t vertex = candidateVertices[i];
+            const uint32_t offset = adjacency.offsets[vertex];
+
+            for (uint32_t j = offset; j < offset + adjacency.vertexCount[vertex]; j++)
+            {
+                const uint32_t t = adjacency.adjacencyList[j];
+
+                if (emitted[t])
+                {
+                    continue;
+                }
+
+                const uint32_t a = indices[t * 3 + 0];
+                const uint32_t b = indices[t * 3 + 1];
+                const uint32_t c = indices[t * 3 + 2];
+
+                const uint32_t newVertices = (localIndices[a] == 0xFF) + (localIndices[b] == 0xFF && b != a) +
+                                             (localIndices[c] == 0xFF && c != a && c != b);
+
+                // Triangles which are the last ones around one of their vertices close up holes in the meshlet. They
+                // go right after the ones adding no vertices, but before the ones adding any.
+                const bool closesVertex = liveTriangles[a] == 1 || liveTriangles[b] == 1 || liveTriangles[c] == 1;
+                const uint32_t extra = newVertices == 0 ? 0 : (closesVertex ? 1 : newVertices + 1);
+
+                const float distance = glm::length(centroids[t] - center);
+                const float spread = glm::dot(normals[t], axis);
+                const float cone = std::max(1.f - spread * coneWeight, 1e-3f);
+
+                const float score = (1.f + distance / expectedRadius * (1.f - coneWeight)) * cone;
+
+                if (extra < bestExtra || (extra == bestExtra && score < bestScore))
+                {
+                    bestTriangle = t;
+                    bestExtra = extra;
+                    bestScore = score;
+                }
+            }
+        }
+
+        return bestTriangle;
+    };
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        uint32_t triangle = NO_TRIANGLE;
+
+        if (lastTriangle != NO_TRIANGLE)
+        {
+            // Neighbours of the last triangle are usually good enough and cheap to evaluate.
+            triangle = findCandidate(&indices[lastTriangle * 3], 3);
+
+            if (triangle == NO_TRIANGLE && meshlet.vertexCount > 0)
+            {
+                triangle = findCandidate(&outVertices[outVertices.size() - meshlet.vertexCount], meshlet.vertexCount);
+            }
+        }
+
+        if (triangle == NO_TRIANGLE)
+        {
+            // The meshlet can't grow any further, continue with the next unprocessed triangle.
+            if (meshlet.triangleCount > 0)
+            {
+                flushMeshlet();
+            }
+
+            while (emitted[seedCursor])
+            {
+                seedCursor++;
+            }
+
+            triangle = seedCursor;
+        }
+
+        const uint32_t a = indices[triangle * 3 + 0];
+        const uint32_t b = indices[triangle * 3 + 1];
+        const uint32_t c = indices[triangle * 3 + 2];
+
+        const uint32_t newVertices = (localIndices[a] == 0xFF) + (localIndices[b] == 0xFF && b != a) +
+                                     (localIndices[c] == 0xFF && c != a && c != b);
+
+        if (meshlet.vertexCount + newVertices > maxVerts || meshlet.triangleCount + 1 > maxTriangles)
+        {
+            // The triangle lies on the border of the full meshlet, so it is a good seed for the next one.
+            flushMeshlet();
+        }
+
+        uint8_t local[3];
+        const uint32_t triangleVertices[3] = {a, b, c};
+
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            uint8_t& localIndex = localIndices[triangleVertices[v]];
+
+            if (localIndex == 0xFF)
+            {
+                localIndex = meshlet.vertexCount++;
+                outVertices.emplace_back(triangleVertices[v]);
+            }
+
+            local[v] = localIndex;
+            liveTriangles[triangleVertices[v]]--;
+        }
+
+        outIndices.emplace_back(MeshUtils::PackTriangleIntoUInt(local[0], local[1], local[2]));
+
+        meshlet.triangleCount++;
+        centroidSum += centroids[triangle];
+        normalSum += normals[triangle];
+
+        emitted[triangle] = 1;
+        lastTriangle = triangle;
+    }
+
+    if (meshlet.triangleCount > 0)
+    {
+        flushMeshlet();
     }
 
     return meshlets;
 }
 
+std::vector<NewMeshlet> MeshletGeneration::Meshletize(const MeshBuildOptions& options, uint32_t maxVerts,
+                                                      uint32_t maxIndices, const std::vector<uint32_t>& indices,
+                                                      const std::vector<MeshVertex>& vertices,
+                                                      std::vector<uint32_t>& outVertices,
+                                                      std::vector<uint32_t>& outIndices, const uint32_t vertexOffset,
+                                                      const uint32_t triangleOffset)
+{
+    switch (options.meshletStrategy)
+    {
+    case EMeshletStrategy::Spatial:
+        return MeshletizeSpatial(maxVerts, maxIndices, indices, vertices, outVertices, outIndices,
+                                 options.meshletConeWeight, vertexOffset, triangleOffset);
+    case EMeshletStrategy::Greedy:
+    default:
+        return MeshletizeNvParallel(maxVerts, maxIndices, indices, vertices.size(), outVertices, outIndices, 0,
+                                    vertexOffset, triangleOffset);
+    }
+}
+
 std::vector<Meshlet> MeshletGeneration::MeshletizeUnoptimized(uint32_t maxVerts, uint32_t maxIndices,
                                                               const std::vector<uint32_t>& indices,
                                                               const uint32_t verticesSize)
@@ -114,8 +494,14 @@ std::vector<Meshlet> MeshletGeneration::MeshletizeUnoptimized(uint32_t maxVerts,
             (meshlet.indicesCount + 3 > maxIndices))
         {
             meshlets.push_back(meshlet);
+
+            // Only the vertices of the flushed meshlet were written into the map.
+            for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+            {
+                vertices[meshlet.vertices[v]] = 0xFF;
+            }
+
             meshlet = {};
-            memset(vertices.data(), 0xFF, verticesSize);
         }
 
         if (av == 0xFF)
@@ -148,94 +534,283 @@ std::vector<Meshlet> MeshletGeneration::MeshletizeUnoptimized(uint32_t maxVerts,
 
     return meshlets;
 }
+// --- Horizontal reductions of the 8 lanes of an AVX register.
+
+static inline float HorizontalMin(const __m256 value)
+{
+    __m128 result = _mm_min_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    result = _mm_min_ps(result, _mm_movehl_ps(result, result));
+    result = _mm_min_ss(result, _mm_shuffle_ps(result, result, 1));
+    return _mm_cvtss_f32(result);
+}
+
+static inline float HorizontalMax(const __m256 value)
+{
+    __m128 result = _mm_max_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    result = _mm_max_ps(result, _mm_movehl_ps(result, result));
+    result = _mm_max_ss(result, _mm_shuffle_ps(result, result, 1));
+    return _mm_cvtss_f32(result);
+}
+
+static inline float HorizontalSum(const __m256 value)
+{
+    __m128 result = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    result = _mm_add_ps(result, _mm_movehl_ps(result, result));
+    result = _mm_add_ss(result, _mm_shuffle_ps(result, result, 1));
+    return _mm_cvtss_f32(result);
+}
+
+// Meshlets whose triangle normals diverge more than this from the cone axis are never cone culled. Such a cone would
+// be almost a hemisphere and the apex would have to be pushed very far behind the meshlet.
+static constexpr float MIN_CONE_AXIS_DOT = 0.1f;
+
 std::vector<MeshletBounds> MeshletGeneration::ComputeMeshletBounds(const std::vector<MeshVertex>& meshVertices,
                                                                    const std::vector<uint32_t>& meshletVertices,
+                                                                   const std::vector<uint32_t>& meshletTriangles,
                                                                    const std::vector<NewMeshlet>& meshlets)
 {
-    std::vector<MeshletBounds> meshletBounds;
-    meshletBounds.reserve(meshlets.size());
+    std::vector<MeshletBounds> meshletBounds(meshlets.size());
+
+    uint32_t maxVertexCount = 0;
+    uint32_t maxTriangleCount = 0;
 
+    for (const NewMeshlet& meshlet : meshlets)
     {
-        uint accOffset = 0;
+        maxVertexCount = std::max(maxVertexCount, meshlet.vertexCount);
+        maxTriangleCount = std::max(maxTriangleCount, meshlet.triangleCount);
+    }
 
-        for (auto& meshlet : meshlets)
-        {
+    // Vertex positions and triangle corners of a meshlet are gathered into SoA arrays, so they can be processed
+    // 8 lanes at a time. The arrays are padded to a multiple of 8 and allocated only once per thread.
+    const uint32_t vertexScratchSize = (maxVertexCount + 7) & ~7u;
+    const uint32_t triangleScratchSize = (maxTriangleCount + 7) & ~7u;
+
+    struct BoundsScratch
+    {
+        std::vector<float> data;
+        float *px, *py, *pz;
+        // Corners of the triangles and their unit normals. Degenerate triangles get a zero normal.
+        float *ax, *ay, *az, *bx, *by, *bz, *cx, *cy, *cz, *nx, *ny, *nz;
+    };
+
+    const uint32_t threadCount = ThreadUtils::GetThreadCount();
+    std::vector<BoundsScratch> scratches(threadCount);
 
-            // Compute avg normal and cone
-            std::vector<Vec3f> normals, vertices;
-            normals.reserve(meshlet.vertexCount);
-            vertices.reserve(meshlet.vertexCount);
+    const size_t blockSize = 256;
+    const size_t blockCount = (meshlets.size() + blockSize - 1) / blockSize;
 
-            Vec3f maxPoint = Vec3f(std::numeric_limits<float>::min());
-            Vec3f minPoint = Vec3f(std::numeric_limits<float>::max());
+    ThreadUtils::ParallelFor(blockCount, threadCount, [&](const size_t blockIndex, const uint32_t threadIndex) {
+        BoundsScratch& scratch = scratches[threadIndex];
 
-            uint32_t maxOffset = meshlet.vertexOffset + meshlet.vertexCount;
+        if (scratch.data.empty())
+        {
+            scratch.data.resize(vertexScratchSize * 3 + triangleScratchSize * 12);
+
+            float* triangleData = scratch.data.data() + vertexScratchSize * 3;
+            float** triangleArrays[] = {&scratch.ax, &scratch.ay, &scratch.az, &scratch.bx, &scratch.by, &scratch.bz,
+                                        &scratch.cx, &scratch.cy, &scratch.cz, &scratch.nx, &scratch.ny, &scratch.nz};
 
-            for (uint32_t i = meshlet.vertexOffset; i < maxOffset; i++)
+            scratch.px = scratch.data.data();
+            scratch.py = scratch.px + vertexScratchSize;
+            scratch.pz = scratch.py + vertexScratchSize;
+
+            for (float** array : triangleArrays)
             {
-				if (i >= meshletVertices.size()) {
-					LOG(Rendering, Error, "Fuck!")
-				}
+                *array = triangleData;
+                triangleData += triangleScratchSize;
+            }
+        }
+
+        const size_t lastMeshlet = std::min(meshlets.size(), (blockIndex + 1) * blockSize);
 
-                const glm::vec3& glmNormal = meshVertices[meshletVertices[i]].Normal;
-                const glm::vec3& glmPosition = meshVertices[meshletVertices[i]].Position;
+        for (size_t m = blockIndex * blockSize; m < lastMeshlet; m++)
+        {
+            const NewMeshlet& meshlet = meshlets[m];
 
-                normals.emplace_back(Vec3f(glmNormal.x, glmNormal.y, glmNormal.z));
-                vertices.emplace_back(Vec3f(glmPosition.x, glmPosition.y, glmPosition.z));
+            ASSERT(meshlet.vertexCount > 0 && meshlet.vertexOffset + meshlet.vertexCount <= meshletVertices.size(),
+                   "Meshlet vertices are out of bounds of the meshlet vertex buffer!")
+            ASSERT(meshlet.triangleOffset + meshlet.triangleCount <= meshletTriangles.size(),
+                   "Meshlet triangles are out of bounds of the meshlet triangle buffer!")
 
-                maxPoint = Vec3f::Max(maxPoint, Vec3f(glmPosition.x, glmPosition.y, glmPosition.z));
-                minPoint = Vec3f::Min(minPoint, Vec3f(glmPosition.x, glmPosition.y, glmPosition.z));
+            // --- Gather the vertices. The padding lanes repeat the first vertex, so they don't change the min/max.
+            const uint32_t paddedVertexCount = (meshlet.vertexCount + 7) & ~7u;
+
+            for (uint32_t i = 0; i < paddedVertexCount; i++)
+            {
+                const uint32_t local = i < meshlet.vertexCount ? i : 0;
+                const glm::vec3& position = meshVertices[meshletVertices[meshlet.vertexOffset + local]].Position;
+
+                scratch.px[i] = position.x;
+                scratch.py[i] = position.y;
+                scratch.pz[i] = position.z;
             }
 
-            assert(meshlet.vertexCount == normals.size());
+            // --- Gather the triangles. The padding lanes are collapsed into a point, which makes them degenerate.
+            const uint32_t paddedTriangleCount = (meshlet.triangleCount + 7) & ~7u;
 
-            Vec3f avgNormal;
+            for (uint32_t i = 0; i < paddedTriangleCount; i++)
+            {
+                const uint32_t triangle = i < meshlet.triangleCount ? meshletTriangles[meshlet.triangleOffset + i] : 0;
+
+                const uint32_t a = triangle & 0xFF;
+                const uint32_t b = (triangle >> 8) & 0xFF;
+                const uint32_t c = (triangle >> 16) & 0xFF;
+
+                scratch.ax[i] = scratch.px[a];
+                scratch.ay[i] = scratch.py[a];
+                scratch.az[i] = scratch.pz[a];
+                scratch.bx[i] = scratch.px[b];
+                scratch.by[i] = scratch.py[b];
+                scratch.bz[i] = scratch.pz[b];
+                scratch.cx[i] = scratch.px[c];
+                scratch.cy[i] = scratch.py[c];
+                scratch.cz[i] = scratch.pz[c];
+            }
+
+            // --- AABB of the vertices.
+            __m256 minX = _mm256_loadu_ps(scratch.px), maxX = minX;
+            __m256 minY = _mm256_loadu_ps(scratch.py), maxY = minY;
+            __m256 minZ = _mm256_loadu_ps(scratch.pz), maxZ = minZ;
 
-            for (const auto& normal : normals)
+            for (uint32_t i = 0; i < paddedVertexCount; i += 8)
             {
-                avgNormal += normal;
+                const __m256 x = _mm256_loadu_ps(scratch.px + i);
+                const __m256 y = _mm256_loadu_ps(scratch.py + i);
+                const __m256 z = _mm256_loadu_ps(scratch.pz + i);
+
+                minX = _mm256_min_ps(minX, x);
+                minY = _mm256_min_ps(minY, y);
+                minZ = _mm256_min_ps(minZ, z);
+                maxX = _mm256_max_ps(maxX, x);
+                maxY = _mm256_max_ps(maxY, y);
+                maxZ = _mm256_max_ps(maxZ, z);
             }
 
-            avgNormal /= normals.size();
-            avgNormal = avgNormal.Normalize();
+            const glm::vec3 maxPoint(HorizontalMax(maxX), HorizontalMax(maxY), HorizontalMax(maxZ));
+            const glm::vec3 minPoint(HorizontalMin(minX), HorizontalMin(minY), HorizontalMin(minZ));
+
+            const glm::vec3 center = (maxPoint + minPoint) * 0.5f;
 
-            Vec3f coneNormal = avgNormal;
-            float minDot = 1.f;
+            const __m256 centerX = _mm256_set1_ps(center.x);
+            const __m256 centerY = _mm256_set1_ps(center.y);
+            const __m256 centerZ = _mm256_set1_ps(center.z);
 
-            for (const auto& normal : normals)
+            // --- The radius is the distance to the farthest vertex, which is tighter than the half of the diagonal.
+            __m256 maxDistance = _mm256_setzero_ps();
+
+            for (uint32_t i = 0; i < paddedVertexCount; i += 8)
             {
-                float dot = avgNormal.Dot(normal);
+                const __m256 x = _mm256_sub_ps(_mm256_loadu_ps(scratch.px + i), centerX);
+                const __m256 y = _mm256_sub_ps(_mm256_loadu_ps(scratch.py + i), centerY);
+                const __m256 z = _mm256_sub_ps(_mm256_loadu_ps(scratch.pz + i), centerZ);
 
-                if (dot < minDot)
-                {
-                    minDot = dot;
-                    coneNormal = normal;
-                }
+                __m256 distance = _mm256_mul_ps(x, x);
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(y, y));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(z, z));
+
+                maxDistance = _mm256_max_ps(maxDistance, distance);
             }
 
-            // We have to account for the fact that a triangle is visible to it's entire hemisphere.
-            // Therefore we need to add a 90 degree angle to the the most diverging normal.
-            // Could there exist an edge case base the normal would go beyond the triangle hemisphere? probably not.
-            float newMinDot = cos(3.141589 / 2 + acosf(minDot));
+            // --- Triangle normals and their sum. The vertex normals are not used, since they are interpolated
+            // and don't tell which side of the triangle is actually facing the camera.
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.f);
 
-            // Compute Bounding sphere.
+            __m256 sumX = zero, sumY = zero, sumZ = zero;
 
-            // Sphere boundingSphere = CreateBoundingSphere(vertices);
+            for (uint32_t i = 0; i < paddedTriangleCount; i += 8)
+            {
+                const __m256 ax = _mm256_loadu_ps(scratch.ax + i);
+                const __m256 ay = _mm256_loadu_ps(scratch.ay + i);
+                const __m256 az = _mm256_loadu_ps(scratch.az + i);
+
+                const __m256 e1x = _mm256_sub_ps(_mm256_loadu_ps(scratch.bx + i), ax);
+                const __m256 e1y = _mm256_sub_ps(_mm256_loadu_ps(scratch.by + i), ay);
+                const __m256 e1z = _mm256_sub_ps(_mm256_loadu_ps(scratch.bz + i), az);
+                const __m256 e2x = _mm256_sub_ps(_mm256_loadu_ps(scratch.cx + i), ax);
+                const __m256 e2y = _mm256_sub_ps(_mm256_loadu_ps(scratch.cy + i), ay);
+                const __m256 e2z = _mm256_sub_ps(_mm256_loadu_ps(scratch.cz + i), az);
+
+                const __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+                const __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+                const __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+
+                __m256 lengthSq = _mm256_mul_ps(nx, nx);
+                lengthSq = _mm256_add_ps(lengthSq, _mm256_mul_ps(ny, ny));
+                lengthSq = _mm256_add_ps(lengthSq, _mm256_mul_ps(nz, nz));
+
+                // Division by zero in the degenerate lanes is masked out.
+                const __m256 valid = _mm256_cmp_ps(lengthSq, zero, _CMP_GT_OQ);
+                const __m256 invLength = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(lengthSq)), valid);
+
+                const __m256 unitX = _mm256_mul_ps(nx, invLength);
+                const __m256 unitY = _mm256_mul_ps(ny, invLength);
+                const __m256 unitZ = _mm256_mul_ps(nz, invLength);
+
+                _mm256_storeu_ps(scratch.nx + i, unitX);
+                _mm256_storeu_ps(scratch.ny + i, unitY);
+                _mm256_storeu_ps(scratch.nz + i, unitZ);
+
+                sumX = _mm256_add_ps(sumX, unitX);
+                sumY = _mm256_add_ps(sumY, unitY);
+                sumZ = _mm256_add_ps(sumZ, unitZ);
+            }
 
-            Vec3f sphereCenter = (maxPoint + minPoint) / 2.0;
-            float sphereRadius = (sphereCenter - maxPoint).Magnitude();
+            glm::vec3 axis(HorizontalSum(sumX), HorizontalSum(sumY), HorizontalSum(sumZ));
 
+            const float axisLength = glm::length(axis);
+            axis = axisLength > 0.f ? axis / axisLength : glm::vec3(0.f, 0.f, 1.f);
 
-            meshletBounds.emplace_back(MeshletBounds{
-                .normal = {avgNormal.x, avgNormal.y, avgNormal.z},
-                .coneAngle = minDot,
-                .spherePos = {sphereCenter.x, sphereCenter.y, sphereCenter.z},
-                .sphereRadius = sphereRadius,
-            });
-        }
-    }
+            // --- The most diverging normal from the axis and the apex, which has to lie behind every triangle plane.
+            // The apex is moved back along the axis from the center: for every triangle the distance needed is
+            // dot(center - a, n) / dot(axis, n).
+            const __m256 axisX = _mm256_set1_ps(axis.x);
+            const __m256 axisY = _mm256_set1_ps(axis.y);
+            const __m256 axisZ = _mm256_set1_ps(axis.z);
+
+            __m256 minDot = one;
+            __m256 maxT = _mm256_set1_ps(-std::numeric_limits<float>::max());
+
+            for (uint32_t i = 0; i < paddedTriangleCount; i += 8)
+            {
+                const __m256 nx = _mm256_loadu_ps(scratch.nx + i);
+                const __m256 ny = _mm256_loadu_ps(scratch.ny + i);
+                const __m256 nz = _mm256_loadu_ps(scratch.nz + i);
+
+                __m256 lengthSq = _mm256_mul_ps(nx, nx);
+                lengthSq = _mm256_add_ps(lengthSq, _mm256_mul_ps(ny, ny));
+                lengthSq = _mm256_add_ps(lengthSq, _mm256_mul_ps(nz, nz));
+
+                const __m256 valid = _mm256_cmp_ps(lengthSq, _mm256_set1_ps(0.5f), _CMP_GT_OQ);
+
+                __m256 axisDot = _mm256_mul_ps(nx, axisX);
+                axisDot = _mm256_add_ps(axisDot, _mm256_mul_ps(ny, axisY));
+                axisDot = _mm256_add_ps(axisDot, _mm256_mul_ps(nz, axisZ));
 
-    ASSERT(meshletBounds.size() == meshlets.size(), "Meshlet bounds and meshlets vectors don't have the same size!");
+                __m256 centerDot = _mm256_mul_ps(_mm256_sub_ps(centerX, _mm256_loadu_ps(scratch.ax + i)), nx);
+                centerDot = _mm256_add_ps(centerDot,
+                                          _mm256_mul_ps(_mm256_sub_ps(centerY, _mm256_loadu_ps(scratch.ay + i)), ny));
+                centerDot = _mm256_add_ps(centerDot,
+                                          _mm256_mul_ps(_mm256_sub_ps(centerZ, _mm256_loadu_ps(scratch.az + i)), nz));
+
+                const __m256 t = _mm256_div_ps(centerDot, axisDot);
+
+                minDot = _mm256_min_ps(minDot, _mm256_blendv_ps(one, axisDot, valid));
+                maxT = _mm256_max_ps(maxT, _mm256_blendv_ps(maxT, t, valid));
+            }
+
+            const float coneDot = HorizontalMin(minDot);
+            const bool hasCone = axisLength > 0.f && coneDot >= MIN_CONE_AXIS_DOT;
+
+            meshletBounds[m] = MeshletBounds{
+                .normal = axis,
+                .coneCutoff = hasCone ? std::sqrt(1.f - coneDot * coneDot) : 2.f,
+                .spherePos = center,
+                .sphereRadius = std::sqrt(HorizontalMax(maxDistance)),
+                .coneApex = hasCone ? center - axis * HorizontalMax(maxT) : center,
+            };
+        }
+    });
 
     return meshletBounds;
 }
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "Mesh/MeshBuildOptions.h"
 #include "Mesh/MeshVertex.h"
 #include "Meshlet.h"
 #include "Model/Structures/Sphere.h"
@@ -16,14 +17,90 @@ class MeshletGeneration
                                                 const std::vector<uint32_t>& indices, const uint32_t verticesSize,
                                                 std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outIndices, const uint32_t vertexOffset = 0, const uint32_t triangleOffset = 0);
 
+    /**
+     * Same as above, but the indices don't have to be stored in a vector (they can be a memory mapped file for
+     * example). For feeding the indices in blocks use MeshletBuilder directly.
+     */
+    static std::vector<NewMeshlet> MeshletizeNv(uint32_t maxVerts, uint32_t maxIndices, const uint32_t* indices,
+                                                const size_t indexCount, const uint32_t verticesSize,
+                                                std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outIndices,
+                                                const uint32_t vertexOffset = 0, const uint32_t triangleOffset = 0);
+
+    /**
+     * Same algorithm as MeshletizeNv with the limits known at compile time. The state of the meshlet being built
+     * (vertex hash table, vertices and triangles) is kept in fixed-size stack arrays and the meshlet is copied into
+     * the output only once it is full. Instantiated for 64/84, 64/126, 64/128 and 128/256, MeshletizeNv uses it
+     * automatically for the default limits. The output is identical to the one of MeshletizeNv.
+     * @tparam MaxVerts - maximum number of vertices in a meshlet, at most 255.
+     * @tparam MaxTris - maximum number of triangles in a meshlet.
+     */
+    template <uint32_t MaxVerts, uint32_t MaxTris>
+    static std::vector<NewMeshlet> Meshletize(const uint32_t* indices, const size_t indexCount,
+                                              std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outTriangles,
+                                              const uint32_t vertexOffset = 0, const uint32_t triangleOffset = 0);
+
+    /**
+     * Parallel version of MeshletizeNv. The index buffer is split into chunks of
+     * Constants::MESHLETIZE_CHUNK_TRIANGLES triangles which are meshletized on separate threads and merged back in
+     * order. The chunks are cut in the order of the index buffer, not by a spatial key, so they are only spatially
+     * coherent if the buffer went through a vertex cache optimizer first (VertexCacheOptimizer, which emits the
+     * triangles in fans of neighbours), as it does in Mesh::Build and LODMesh::Build. For an index buffer in an
+     * arbitrary order, e.g. with EVertexCacheOptimizer::None, the output is still valid, but the meshlets of a chunk
+     * may be scattered over the mesh and cull worse.
+     *
+     * The chunk boundaries don't depend on the thread count, therefore the output is the same for any number of
+     * threads. Compared to MeshletizeNv, only the last meshlet of every chunk may not be filled up completely.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     */
+    static std::vector<NewMeshlet> MeshletizeNvParallel(uint32_t maxVerts, uint32_t maxIndices,
+                                                        const std::vector<uint32_t>& indices,
+                                                        const uint32_t verticesSize, std::vector<uint32_t>& outVertices,
+                                                        std::vector<uint32_t>& outIndices, const uint32_t threadCount = 0,
+                                                        const uint32_t vertexOffset = 0,
+                                                        const uint32_t triangleOffset = 0);
+
+    /**
+     * Builds meshlets by growing them over the triangle adjacency. Every step adds the neighbouring triangle which
+     * introduces the least new vertices and, among those, grows the meshlet's bounds and normal cone the least. The
+     * meshlets are spatially compact and have tighter bounding spheres and cones than the ones from MeshletizeNv,
+     * at the cost of a slower (serial) build.
+     * @param coneWeight - in the range [0, 1]. Balances between grouping the triangles by distance (0) and by their
+     * normals (1).
+     */
+    static std::vector<NewMeshlet> MeshletizeSpatial(uint32_t maxVerts, uint32_t maxIndices,
+                                                     const std::vector<uint32_t>& indices,
+                                                     const std::vector<MeshVertex>& vertices,
+                                                     std::vector<uint32_t>& outVertices,
+                                                     std::vector<uint32_t>& outIndices, const float coneWeight = 0.25f,
+                                                     const uint32_t vertexOffset = 0,
+                                                     const uint32_t triangleOffset = 0);
+
+    /**
+     * Meshletizes the mesh with the strategy selected in the options.
+     */
+    static std::vector<NewMeshlet> Meshletize(const MeshBuildOptions& options, uint32_t maxVerts,
+                                              uint32_t maxIndices, const std::vector<uint32_t>& indices,
+                                              const std::vector<MeshVertex>& vertices,
+                                              std::vector<uint32_t>& outVertices, std::vector<uint32_t>& outIndices,
+                                              const uint32_t vertexOffset = 0, const uint32_t triangleOffset = 0);
+
     static std::vector<Meshlet> MeshletizeUnoptimized(uint32_t maxVerts, uint32_t maxIndices,
                                                       const std::vector<uint32_t>& indices,
                                                       const uint32_t verticesCount);
 
     /**
-     * It is assumed that the indices are packed as trinagles. Not individual vertex indices!
+     * Computes the bounding sphere and the normal cone of every meshlet.
+     * The cone is built from the triangle normals (not the interpolated vertex normals) and consists of an axis,
+     * an apex lying behind all of the triangle planes and a cutoff, so that the meshlet is guaranteed to be
+     * backfacing when dot(normalize(apex - cameraPos), axis) >= cutoff. See MeshletCulling.
+     * The meshlets are processed in parallel. Positions and triangles of every meshlet are gathered into reusable
+     * per-thread SoA arrays and reduced with AVX, so no memory is allocated per meshlet.
+     * @param meshletTriangles - triangles packed into a uint (8 bits per local vertex index)
      */
-    static std::vector<MeshletBounds> ComputeMeshletBounds(const std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& meshletVertices, const std::vector<NewMeshlet>& meshlets);
+    static std::vector<MeshletBounds> ComputeMeshletBounds(const std::vector<MeshVertex>& meshVertices,
+                                                           const std::vector<uint32_t>& meshletVertices,
+                                                           const std::vector<uint32_t>& meshletTriangles,
+                                                           const std::vector<NewMeshlet>& meshlets);
 
 	static Sphere CreateBoundingSphere(const std::vector<Vec3f> points);
 };
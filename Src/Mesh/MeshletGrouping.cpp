@@ -0,0 +1,209 @@
+#include "MeshletGrouping.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../Log/Log.h"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+// Cutoff of a cone which can not cull anything, same as in MeshletGeneration::ComputeMeshletBounds.
+static constexpr float NO_CONE_CUTOFF = 2.f;
+
+// Added to the merged cone angle (in radians), so the rounding errors can't make it less conservative.
+static constexpr float CONE_ANGLE_EPSILON = 1e-3f;
+
+// Spreads the lower 10 bits of the value, so there are two zero bits between every two bits.
+static uint32_t SpreadBits(uint32_t value)
+{
+    value &= 0x3FF;
+    value = (value | (value << 16)) & 0x030000FF;
+    value = (value | (value << 8)) & 0x0300F00F;
+    value = (value | (value << 4)) & 0x030C30C3;
+    value = (value | (value << 2)) & 0x09249249;
+
+    return value;
+}
+
+std::vector<uint32_t> MeshletGrouping::SortIntoGroups(std::vector<NewMeshlet>& meshlets,
+                                                      std::vector<MeshletBounds>& bounds, const size_t first,
+                                                      const size_t count, std::vector<MeshletGroup>& outGroups,
+                                                      const uint32_t groupSize)
+{
+    ASSERT(meshlets.size() == bounds.size(), "Every meshlet has to have its bounds!")
+    ASSERT(first + count <= meshlets.size(), "The range of the meshlets is out of bounds!")
+    ASSERT(groupSize > 0, "The group has to hold at least one meshlet!")
+
+    std::vector<uint32_t> order(count);
+
+    if (count == 0)
+    {
+        return order;
+    }
+
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(-std::numeric_limits<float>::max());
+
+    for (size_t i = first; i < first + count; i++)
+    {
+        min = glm::min(min, bounds[i].spherePos);
+        max = glm::max(max, bounds[i].spherePos);
+    }
+
+    const glm::vec3 extent = max - min;
+    const float scale = 1023.f / std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-20f));
+
+    std::vector<uint32_t> codes(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const glm::vec3 cell = (bounds[first + i].spherePos - min) * scale;
+
+        codes[i] = SpreadBits(static_cast<uint32_t>(cell.x)) | (SpreadBits(static_cast<uint32_t>(cell.y)) << 1) |
+                   (SpreadBits(static_cast<uint32_t>(cell.z)) << 2);
+        order[i] = i;
+    }
+
+    // Stable, so the meshlets within a single cell keep the order of the index buffer.
+    std::stable_sort(order.begin(), order.end(), [&](const uint32_t a, const uint32_t b) { return codes[a] < codes[b]; });
+
+    std::vector<NewMeshlet> sortedMeshlets(count);
+    std::vector<MeshletBounds> sortedBounds(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        sortedMeshlets[i] = meshlets[first + order[i]];
+        sortedBounds[i] = bounds[first + order[i]];
+    }
+
+    std::copy(sortedMeshlets.begin(), sortedMeshlets.end(), meshlets.begin() + first);
+    std::copy(sortedBounds.begin(), sortedBounds.end(), bounds.begin() + first);
+
+    for (size_t start = 0; start < count; start += groupSize)
+    {
+        const size_t groupCount = std::min<size_t>(groupSize, count - start);
+
+        outGroups.emplace_back(MeshletGroup{
+            .bounds = MergeBounds(&bounds[first + start], groupCount),
+            .meshletOffset = static_cast<uint32_t>(first + start),
+            .meshletCount = static_cast<uint32_t>(groupCount),
+        });
+    }
+
+    return order;
+}
+
+MeshletBounds MeshletGrouping::MergeBounds(const MeshletBounds* bounds, const size_t count)
+{
+    ASSERT(count > 0, "There are no bounds to merge!")
+
+    // --- Sphere around the bounding box of the spheres
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(-std::numeric_limits<float>::max());
+
+    glm::vec3 axis(0.f);
+    bool hasCone = true;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        min = glm::min(min, bounds[i].spherePos - bounds[i].sphereRadius);
+        max = glm::max(max, bounds[i].spherePos + bounds[i].sphereRadius);
+
+        axis += bounds[i].normal;
+        hasCone &= bounds[i].coneCutoff <= 1.f;
+    }
+
+    const glm::vec3 center = (min + max) * 0.5f;
+    float radius = 0.f;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        radius = std::max(radius, glm::length(bounds[i].spherePos - center) + bounds[i].sphereRadius);
+    }
+
+    MeshletBounds merged = {
+        .normal = axis,
+        .coneCutoff = NO_CONE_CUTOFF,
+        .spherePos = center,
+        .sphereRadius = radius,
+        .coneApex = center,
+    };
+
+    const float axisLength = glm::length(axis);
+
+    if (!hasCone || axisLength <= 0.f)
+    {
+        return merged;
+    }
+
+    axis /= axisLength;
+    merged.normal = axis;
+
+    // --- Cone of the normals containing the normal cones of all the meshlets. The cutoff is the sine of its angle.
+    float coneAngle = 0.f;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const float axisAngle = std::acos(std::clamp(glm::dot(axis, bounds[i].normal), -1.f, 1.f));
+        coneAngle = std::max(coneAngle, axisAngle + std::asin(bounds[i].coneCutoff));
+    }
+
+    coneAngle += CONE_ANGLE_EPSILON;
+
+    if (coneAngle >= 1.5707963f)
+    {
+        return merged;
+    }
+
+    // --- The merged cone culls only the cameras culled by every meshlet, if its apex lies in the culled region of
+    // every meshlet. The apex is moved back along the axis until it does, the closer to the meshlets the better.
+    const auto isApexValid = [&](const float distance) {
+        const glm::vec3 apex = center - axis * distance;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::vec3 toApex = bounds[i].coneApex - apex;
+
+            if (glm::dot(toApex, bounds[i].normal) < bounds[i].coneCutoff * glm::length(toApex))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    // Since the axis lies inside every culled region, the valid distances form an interval [x, inf).
+    float low = -radius;
+    float high = std::max(radius, 1e-6f);
+
+    for (uint32_t i = 0; i < 32 && !isApexValid(high); i++)
+    {
+        low = high;
+        high *= 2.f;
+    }
+
+    if (!isApexValid(high))
+    {
+        return merged;
+    }
+
+    if (!isApexValid(low))
+    {
+        for (uint32_t i = 0; i < 24; i++)
+        {
+            const float middle = (low + high) * 0.5f;
+            (isApexValid(middle) ? high : low) = middle;
+        }
+    }
+    else
+    {
+        high = low;
+    }
+
+    merged.coneCutoff = std::sin(coneAngle);
+    merged.coneApex = center - axis * high;
+
+    return merged;
+}
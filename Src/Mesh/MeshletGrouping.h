@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Constants.h"
+#include "Meshlet.h"
+
+/**
+ * Splits the meshlets into the groups culled by one task shader workgroup. The test of the group mirrors the one of
+ * a single meshlet (MeshletCulling, Res/Shaders/include/meshlet_group.glsl), only with the merged bounds.
+ */
+class MeshletGrouping
+{
+  public:
+    /**
+     * @brief Sorts the meshlets in the range [first, first + count) along a Morton curve of their bounding sphere
+     * centers and appends a group for every run of groupSize meshlets of the range to outGroups. The meshlets
+     * and their bounds are reordered in place, the meshlet data (vertices, triangles) stays untouched.
+     * @param meshlets, bounds - parallel arrays, for example from MeshletGeneration::ComputeMeshletBounds
+     * @return new order of the range. order[i] is the index (relative to first) the i-th meshlet of the range had
+     * before sorting, so any other per-meshlet data (e.g. LODClusters) can be reordered the same way.
+     */
+    static std::vector<uint32_t> SortIntoGroups(std::vector<NewMeshlet>& meshlets, std::vector<MeshletBounds>& bounds,
+                                                const size_t first, const size_t count,
+                                                std::vector<MeshletGroup>& outGroups,
+                                                const uint32_t groupSize = Constants::MESHLET_GROUP_SIZE);
+
+    /**
+     * @brief Merges the bounds of several meshlets. The sphere contains all of the spheres. The cone is narrowed
+     * and its apex moved back, so the camera positions it culls are culled by every one of the merged cones.
+     * If the normals spread over a hemisphere or more, the cutoff is above 1 and the group is never culled by it.
+     */
+    static MeshletBounds MergeBounds(const MeshletBounds* bounds, const size_t count);
+};
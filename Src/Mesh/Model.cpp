@@ -1,26 +1,122 @@
 #include "Model.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 #include "../Log/Log.h"
+#include "../MemoryStats.h"
+#include "../ThreadUtils.h"
+#include "../Vk/Buffers/GeometryUploader.h"
+#include "MeshCache.h"
+#include "MeshUtils.h"
 #include "MeshVertex.h"
+#include "VertexWelder.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 #include "vulkan/vulkan.hpp"
 
-Model::Model(const std::string& filePath)
+Model::Model(const std::string& filePath, const MeshBuildOptions& options, VkCore::GeometryUploader* uploader)
+    : m_Options(options)
 {
+    // Waits for the upload in its destructor, if the caller didn't pass an uploader.
+    VkCore::GeometryUploader ownUploader;
+    VkCore::GeometryUploader& batch = uploader != nullptr ? *uploader : ownUploader;
+
+    MeshCache cache(EMeshCacheKind::Model, {filePath}, options);
+
+    if (cache.Load())
+    {
+        for (size_t i = 0; i < cache.GetMeshCount(); i++)
+        {
+            Mesh mesh(cache.GetMesh(i), &batch, options.residency);
+            m_MeshletCount += mesh.GetMeshletCount();
+            m_Meshes.emplace_back(std::move(mesh));
+        }
+
+        // Submitted before the cache file is unmapped.
+        m_UploadValue = batch.Submit();
+        return;
+    }
+
+    // The welding and the normals are done by us after the import, if enabled.
+    const unsigned int flags = aiProcess_Triangulate |
+                               (options.meshImport.generateNormals ? 0 : aiProcess_GenNormals) |
+                               (options.meshImport.weldVertices ? 0 : aiProcess_JoinIdenticalVertices);
+
+    // --- The scene stays owned by the importer and is freed by assimp once the data of its meshes is copied out.
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(filePath.data(), aiProcess_Triangulate | aiProcess_GenNormals |
-                                                                  aiProcess_JoinIdenticalVertices);
+    const aiScene* scene = importer.ReadFile(filePath.data(), flags);
 
     ASSERTF(scene != nullptr && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode != nullptr,
             "Failed to import a scene! %s", importer.GetErrorString())
 
-    ProcessNode(scene->mRootNode, scene);
+    MemoryStats::EndStage("Model: import");
+
+    std::vector<uint32_t> meshIndices;
+    ProcessNode(scene->mRootNode, scene, meshIndices);
+
+    // A scene mesh referenced by several nodes is processed only once, all of its references use the same MeshData.
+    std::vector<uint32_t> sceneMeshSlots(scene->mNumMeshes, UINT32_MAX);
+    std::vector<uint32_t> slotSceneMeshes;
+    std::vector<uint32_t> references(meshIndices.size());
+
+    for (size_t i = 0; i < meshIndices.size(); i++)
+    {
+        uint32_t& slot = sceneMeshSlots[meshIndices[i]];
+
+        if (slot == UINT32_MAX)
+        {
+            slot = slotSceneMeshes.size();
+            slotSceneMeshes.emplace_back(meshIndices[i]);
+        }
+
+        references[i] = slot;
+    }
+
+    std::vector<ImportedMesh> importedMeshes(slotSceneMeshes.size());
+
+    ThreadUtils::ParallelFor(importedMeshes.size(), 0, [&](const size_t slot, const uint32_t) {
+        importedMeshes[slot] = ConvertMesh(scene->mMeshes[slotSceneMeshes[slot]]);
+    });
+
+    // Only the copied vertices and indices are needed from now on.
+    importer.FreeScene();
+    scene = nullptr;
+
+    MemoryStats::EndStage("Model: convert");
+
+    // --- The CPU side of every mesh runs in parallel, each into its own slot, so the order of the meshes doesn't
+    // depend on the scheduling. The nested parallel loops of the pipeline get a share of the threads.
+    std::vector<MeshData> meshes(slotSceneMeshes.size());
+
+    ThreadUtils::ParallelFor(meshes.size(), 0, [&](const size_t slot, const uint32_t) {
+        meshes[slot] = ProcessMesh(std::move(importedMeshes[slot]));
+    });
+
+    MemoryStats::EndStage("Model: process");
+
+    cache.Store(meshes, references);
+
+    MemoryStats::EndStage("Model: cache store");
+
+    // --- The GPU resources are created only once all the meshes are processed.
+    m_Meshes.reserve(references.size());
+
+    for (const uint32_t reference : references)
+    {
+        Mesh mesh(meshes[reference].GetView(), &batch, options.residency);
+        m_MeshletCount += mesh.GetMeshletCount();
+        m_Meshes.emplace_back(std::move(mesh));
+    }
+
+    // All the meshes in one submission, before their data is freed.
+    m_UploadValue = batch.Submit();
+
+    MemoryStats::EndStage("Model: upload");
 }
 
 void Model::Draw(const vk::CommandBuffer& cmdBuffer, const vk::Pipeline& pipeline,
@@ -28,31 +124,41 @@ void Model::Draw(const vk::CommandBuffer& cmdBuffer, const vk::Pipeline& pipelin
 {
 }
 
-void Model::ProcessNode(const aiNode* node, const aiScene* scene)
+MeshMemoryStats Model::GetMemoryStats() const
 {
+    MeshMemoryStats stats;
 
-    for (uint32_t i = 0; i < node->mNumMeshes; i++)
+    for (const Mesh& mesh : m_Meshes)
     {
-        Mesh mesh = ProcessMesh(scene->mMeshes[node->mMeshes[i]], scene);
-        m_MeshletCount += mesh.GetMeshletCount();
-        m_Meshes.emplace_back(std::move(mesh));
+        stats += mesh.GetMemoryStats();
     }
 
-    for (uint32_t i = 0; i < node->mNumChildren; i++)
-    {
-        ProcessNode(node->mChildren[i], scene);
-    }
+    return stats;
 }
 
-Mesh Model::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
+void Model::ProcessNode(const aiNode* node, const aiScene* scene, std::vector<uint32_t>& outMeshIndices)
 {
 
-    if (mesh == nullptr)
+    for (uint32_t i = 0; i < node->mNumMeshes; i++)
     {
-        LOG(Assimp, Fatal, "Failed to process a mesh! aiMesh is null!")
-        throw std::runtime_error("Failed to process a mesh! aiMesh is null!");
+        // Checked here, an exception can't leave the worker threads.
+        if (scene->mMeshes[node->mMeshes[i]] == nullptr)
+        {
+            LOG(Assimp, Fatal, "Failed to process a mesh! aiMesh is null!")
+            throw std::runtime_error("Failed to process a mesh! aiMesh is null!");
+        }
+
+        outMeshIndices.emplace_back(node->mMeshes[i]);
     }
 
+    for (uint32_t i = 0; i < node->mNumChildren; i++)
+    {
+        ProcessNode(node->mChildren[i], scene, outMeshIndices);
+    }
+}
+
+Model::ImportedMesh Model::ConvertMesh(const aiMesh* mesh)
+{
     std::vector<MeshVertex> meshVertices{};
     meshVertices.reserve(mesh->mNumVertices);
 
@@ -66,9 +172,10 @@ Mesh Model::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
             normals = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
         }
 
-        glm::vec2 textureCoord;
-        glm::vec3 tangent;
-        glm::vec3 biTangent;
+        // Zeroed, so the missing attributes don't keep the vertices from being welded.
+        glm::vec2 textureCoord(0.f);
+        glm::vec3 tangent(0.f);
+        glm::vec3 biTangent(0.f);
 
         if (mesh->mTextureCoords[0] != nullptr)
         {
@@ -88,6 +195,8 @@ Mesh Model::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
     }
 
     std::vector<uint32_t> indices;
+    // Triangulated by the import.
+    indices.reserve(size_t(mesh->mNumFaces) * 3);
 
     for (uint32_t i = 0; i < mesh->mNumFaces; i++)
     {
@@ -100,5 +209,30 @@ Mesh Model::ProcessMesh(const aiMesh* mesh, const aiScene* scene)
         }
     }
 
-    return Mesh(indices, meshVertices);
+    return {
+        .vertices = std::move(meshVertices),
+        .indices = std::move(indices),
+        .hasNormals = mesh->HasNormals(),
+    };
+}
+
+MeshData Model::ProcessMesh(ImportedMesh&& mesh) const
+{
+    std::vector<MeshVertex> meshVertices = std::move(mesh.vertices);
+    std::vector<uint32_t> indices = std::move(mesh.indices);
+
+    const MeshImportOptions& importOptions = m_Options.meshImport;
+
+    if (importOptions.weldVertices)
+    {
+        VertexWelder::Weld(indices, meshVertices, importOptions.weldPositionEpsilon,
+                           importOptions.weldAttributeEpsilon);
+    }
+
+    if (importOptions.generateNormals && !mesh.hasNormals)
+    {
+        MeshUtils::GenerateNormals(indices, meshVertices);
+    }
+
+    return Mesh::Build(std::move(indices), std::move(meshVertices), m_Options);
 }
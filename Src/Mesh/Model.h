@@ -2,7 +2,9 @@
 
 #include <assimp/scene.h>
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "Mesh.h"
 
@@ -11,7 +13,15 @@ class Model
 
   public:
     Model() {};
-    Model(const std::string& filePath);
+    /**
+     * @brief Loads the processed meshes from the MeshCache, or imports and processes the model and stores it in the
+     * cache. The meshes are processed in parallel and uploaded afterwards in the order of the scene graph.
+     * @param options - applied to every mesh of the model.
+     * @param uploader - the meshes are recorded into it and submitted in one batch at the end of the constructor,
+     * without waiting (see GetUploadValue). If null, the model uploads its meshes on its own and waits for them.
+     */
+    Model(const std::string& filePath, const MeshBuildOptions& options = {},
+          VkCore::GeometryUploader* uploader = nullptr);
 
     std::vector<Mesh>& GetMeshes()
     {
@@ -21,6 +31,17 @@ class Model
     {
         return m_MeshletCount;
     }
+    /**
+     * @brief Value of the submission with the meshes of the model in the uploader passed to the constructor.
+     */
+    uint64_t GetUploadValue() const
+    {
+        return m_UploadValue;
+    }
+    /**
+     * @brief Sums the memory held by all the meshes (see EMeshResidency).
+     */
+    MeshMemoryStats GetMemoryStats() const;
 
     void Draw(const vk::CommandBuffer& cmdBuffer, const vk::Pipeline& pipeline,
               const vk::PipelineLayout& pipelineLayout);
@@ -36,7 +57,36 @@ class Model
   private:
     std::vector<Mesh> m_Meshes;
     uint32_t m_MeshletCount = 0;
+    uint64_t m_UploadValue = 0;
+    MeshBuildOptions m_Options = {};
+
+    /**
+     * @brief Collects the indices of the scene meshes of the node and of its children, in the order of the
+     * depth-first traversal.
+     */
+    void ProcessNode(const aiNode* node, const aiScene* scene, std::vector<uint32_t>& outMeshIndices);
+
+    /**
+     * Vertices and indices of a scene mesh, copied out of the scene, so the scene can be freed before the meshes are
+     * processed.
+     */
+    struct ImportedMesh
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+        bool hasNormals = false;
+    };
+
+    /**
+     * @brief Copies the vertices and the indices out of the scene mesh. The scene stays owned by the importer, its
+     * memory has to be freed by assimp (on Windows it lives on the heap of the assimp module).
+     */
+    static ImportedMesh ConvertMesh(const aiMesh* mesh);
 
-    void ProcessNode(const aiNode* node, const aiScene* scene);
-    Mesh ProcessMesh(const aiMesh* mesh, const aiScene* scene);
+    /**
+     * @brief Runs the CPU side of the pipeline on the mesh. Doesn't touch the GPU nor any state of the model besides
+     * the options, so the meshes can be processed in parallel. The pipeline works in place on the buffers of the
+     * mesh and frees them as soon as they are copied into the MeshData.
+     */
+    MeshData ProcessMesh(ImportedMesh&& mesh) const;
 };
@@ -0,0 +1,283 @@
+#include "OverdrawOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "../Log/Log.h"
+#include "glm/geometric.hpp"
+#include "glm/ext/vector_float3.hpp"
+
+static glm::vec3 GetPosition(const float* positions, const size_t stride, const uint32_t vertex)
+{
+    const float* position = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) +
+                                                           vertex * stride);
+    return glm::vec3(position[0], position[1], position[2]);
+}
+
+// Simulates a FIFO cache with time stamps (same as Tipsify) and returns the number of misses of the triangle.
+static uint32_t UpdateCache(const uint32_t* triangle, const uint32_t cacheSize, std::vector<uint32_t>& timeStamps,
+                            uint32_t& timeStamp)
+{
+    uint32_t misses = 0;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        if (timeStamp - timeStamps[triangle[i]] > cacheSize)
+        {
+            timeStamps[triangle[i]] = timeStamp++;
+            misses++;
+        }
+    }
+
+    return misses;
+}
+
+std::vector<uint32_t> OverdrawOptimizer::Optimize(const std::vector<uint32_t>& indices, const float* positions,
+                                                  const size_t vertexCount, const size_t stride,
+                                                  const uint32_t cacheSize, const float threshold)
+{
+    ASSERT(threshold >= 1.f, "The threshold can't be lower than 1, the ACMR of a cluster can only get worse!")
+
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0)
+    {
+        return {};
+    }
+
+    std::vector<uint32_t> timeStamps(vertexCount, 0);
+    uint32_t timeStamp = cacheSize + 1;
+
+    // --- Hard boundaries. A triangle missing all 3 vertices usually starts a new part of the mesh, the
+    // cache optimizer had to flush the cache there.
+    std::vector<uint32_t> hardBoundaries;
+
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        if (UpdateCache(&indices[t * 3], cacheSize, timeStamps, timeStamp) == 3 || t == 0)
+        {
+            hardBoundaries.emplace_back(t);
+        }
+    }
+
+    hardBoundaries.emplace_back(triangleCount);
+
+    // --- Soft boundaries. Every cluster is split whenever the ACMR of its part gets under the ACMR of the whole
+    // cluster multiplied by the threshold. Flushing the cache there costs at most the allowed ACMR.
+    std::vector<uint32_t> clusters;
+
+    for (size_t c = 0; c + 1 < hardBoundaries.size(); c++)
+    {
+        const uint32_t start = hardBoundaries[c];
+        const uint32_t end = hardBoundaries[c + 1];
+
+        // Moving the time stamp by more than the cache size flushes the cache.
+        timeStamp += cacheSize + 1;
+
+        uint32_t clusterMisses = 0;
+
+        for (uint32_t t = start; t < end; t++)
+        {
+            clusterMisses += UpdateCache(&indices[t * 3], cacheSize, timeStamps, timeStamp);
+        }
+
+        const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        clusters.emplace_back(start);
+
+        timeStamp += cacheSize + 1;
+
+        uint32_t misses = 0, triangles = 0;
+
+        for (uint32_t t = start; t < end; t++)
+        {
+            misses += UpdateCache(&indices[t * 3], cacheSize, timeStamps, timeStamp);
+            triangles++;
+
+            if (static_cast<float>(misses) / static_cast<float>(triangles) <= clusterThreshold)
+            {
+                clusters.emplace_back(t + 1);
+
+                timeStamp += cacheSize + 1;
+                misses = 0;
+                triangles = 0;
+            }
+        }
+
+        // The last part reached the threshold exactly at the end of the cluster.
+        if (clusters.back() == end)
+        {
+            clusters.pop_back();
+        }
+    }
+
+    clusters.emplace_back(triangleCount);
+
+    // --- Occlusion potential of every cluster. The clusters far from the center of the mesh, facing outside,
+    // are likely to occlude the rest.
+    glm::vec3 meshCentroid(0.f);
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        meshCentroid += GetPosition(positions, stride, v);
+    }
+
+    meshCentroid /= std::max<float>(vertexCount, 1.f);
+
+    const size_t clusterCount = clusters.size() - 1;
+    std::vector<float> potentials(clusterCount);
+
+    for (size_t cluster = 0; cluster < clusterCount; cluster++)
+    {
+        glm::vec3 centroid(0.f), normal(0.f);
+        float area = 0.f;
+
+        for (uint32_t t = clusters[cluster]; t < clusters[cluster + 1]; t++)
+        {
+            const glm::vec3 a = GetPosition(positions, stride, indices[t * 3]);
+            const glm::vec3 b = GetPosition(positions, stride, indices[t * 3 + 1]);
+            const glm::vec3 c = GetPosition(positions, stride, indices[t * 3 + 2]);
+
+            // Twice the area weighted normal.
+            const glm::vec3 triangleNormal = glm::cross(b - a, c - a);
+            const float triangleArea = glm::length(triangleNormal);
+
+            centroid += (a + b + c) * (triangleArea / 3.f);
+            normal += triangleNormal;
+            area += triangleArea;
+        }
+
+        const float normalLength = glm::length(normal);
+
+        if (area <= 0.f || normalLength <= 0.f)
+        {
+            potentials[cluster] = 0.f;
+            continue;
+        }
+
+        potentials[cluster] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(),
+                     [&](const uint32_t a, const uint32_t b) { return potentials[a] > potentials[b]; });
+
+    std::vector<uint32_t> outputIndices;
+    outputIndices.reserve(triangleCount * 3);
+
+    for (const uint32_t c : order)
+    {
+        outputIndices.insert(outputIndices.end(), indices.begin() + clusters[c] * 3,
+                             indices.begin() + clusters[c + 1] * 3);
+    }
+
+    return outputIndices;
+}
+
+OverdrawStatistics OverdrawOptimizer::EstimateOverdraw(const std::vector<uint32_t>& indices, const float* positions,
+                                                       const size_t vertexCount, const size_t stride,
+                                                       const uint32_t resolution)
+{
+    OverdrawStatistics statistics;
+
+    if (vertexCount == 0 || indices.size() < 3)
+    {
+        return statistics;
+    }
+
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(-std::numeric_limits<float>::max());
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        const glm::vec3 position = GetPosition(positions, stride, v);
+
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+
+    const glm::vec3 extent = max - min;
+    const float scale = 1.f / std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-20f));
+
+    std::vector<float> depthBuffer(resolution * resolution);
+
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        // The other two axes in the cyclic order, so (u, v) is counter-clockwise when looking from +axis.
+        const uint32_t uAxis = (axis + 1) % 3;
+        const uint32_t vAxis = (axis + 2) % 3;
+
+        for (const float direction : {1.f, -1.f})
+        {
+            std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::max());
+
+            // Looking along +axis mirrors u, so the front faces stay counter-clockwise on the screen.
+            const auto project = [&](const uint32_t vertex) {
+                const glm::vec3 normalized = (GetPosition(positions, stride, vertex) - min) * scale;
+                const float u = direction > 0.f ? 1.f - normalized[uAxis] : normalized[uAxis];
+
+                return glm::vec3(u * resolution, normalized[vAxis] * resolution, normalized[axis] * direction);
+            };
+
+            for (size_t t = 0; t + 2 < indices.size(); t += 3)
+            {
+                const glm::vec3 a = project(indices[t]);
+                const glm::vec3 b = project(indices[t + 1]);
+                const glm::vec3 c = project(indices[t + 2]);
+
+                const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+                // Backfacing or degenerate.
+                if (area <= 0.f)
+                {
+                    continue;
+                }
+
+                const int32_t minX = std::max(0, static_cast<int32_t>(std::floor(std::min({a.x, b.x, c.x}))));
+                const int32_t minY = std::max(0, static_cast<int32_t>(std::floor(std::min({a.y, b.y, c.y}))));
+                const int32_t maxX = std::min(static_cast<int32_t>(resolution) - 1,
+                                              static_cast<int32_t>(std::ceil(std::max({a.x, b.x, c.x}))));
+                const int32_t maxY = std::min(static_cast<int32_t>(resolution) - 1,
+                                              static_cast<int32_t>(std::ceil(std::max({a.y, b.y, c.y}))));
+
+                for (int32_t y = minY; y <= maxY; y++)
+                {
+                    for (int32_t x = minX; x <= maxX; x++)
+                    {
+                        const float px = x + 0.5f, py = y + 0.5f;
+
+                        // Barycentric coordinates from the edge functions.
+                        const float wa = (c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x);
+                        const float wb = (a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x);
+                        const float wc = area - wa - wb;
+
+                        if (wa < 0.f || wb < 0.f || wc < 0.f)
+                        {
+                            continue;
+                        }
+
+                        const float depth = (wa * a.z + wb * b.z + wc * c.z) / area;
+                        float& stored = depthBuffer[y * resolution + x];
+
+                        if (depth < stored)
+                        {
+                            statistics.pixelsCovered += stored == std::numeric_limits<float>::max();
+                            statistics.pixelsShaded++;
+                            stored = depth;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    statistics.overdraw =
+        statistics.pixelsCovered == 0 ? 0.f
+                                      : static_cast<float>(statistics.pixelsShaded) / statistics.pixelsCovered;
+
+    return statistics;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct OverdrawStatistics
+{
+    // Pixels covered by the mesh and pixels shaded (the depth test passed), summed over all the views.
+    size_t pixelsCovered = 0;
+    size_t pixelsShaded = 0;
+    // Shaded pixels per covered pixel. 1 is the best.
+    float overdraw = 0.f;
+};
+
+/**
+ * View-independent reordering of the triangles for the overdraw (the second part of Sander et al., Fast Triangle
+ * Reordering for Vertex Locality and Reduced Overdraw). Runs after the vertex cache optimization.
+ *
+ * The optimized index buffer is split into clusters at the points where the vertex cache gets flushed, which
+ * are then split further while their ACMR stays under the threshold. The clusters are sorted by their occlusion
+ * potential, the ones at the outside of the mesh facing away from its center are drawn first, so they occlude
+ * the rest from most of the views.
+ */
+class OverdrawOptimizer
+{
+  public:
+    /**
+     * @param cacheSize - size of the vertex cache the indices were optimized for
+     * @param threshold - how much worse the ACMR of a cluster can get, 1.05 allows 5 %. The higher the threshold,
+     * the smaller the clusters and the better the sorting.
+     */
+    template <typename TVertex>
+    static std::vector<uint32_t> Optimize(const std::vector<uint32_t>& indices, const std::vector<TVertex>& vertices,
+                                          const uint32_t cacheSize, const float threshold)
+    {
+        return Optimize(indices, vertices.empty() ? nullptr : &vertices[0].Position.x, vertices.size(),
+                        sizeof(TVertex), cacheSize, threshold);
+    }
+
+    /**
+     * @param positions - 3 floats of the position of the first vertex, the next one starts stride bytes after it.
+     */
+    static std::vector<uint32_t> Optimize(const std::vector<uint32_t>& indices, const float* positions,
+                                          const size_t vertexCount, const size_t stride, const uint32_t cacheSize,
+                                          const float threshold);
+
+    /**
+     * @brief Estimates the overdraw on the CPU. The mesh is rasterized from 6 orthographic views along the axes
+     * with backface culling and an early depth test, the same way the GPU would draw it with an opaque material.
+     * @param resolution - width and height of the rasterized views in pixels
+     */
+    template <typename TVertex>
+    static OverdrawStatistics EstimateOverdraw(const std::vector<uint32_t>& indices,
+                                               const std::vector<TVertex>& vertices, const uint32_t resolution = 256)
+    {
+        return EstimateOverdraw(indices, vertices.empty() ? nullptr : &vertices[0].Position.x, vertices.size(),
+                                sizeof(TVertex), resolution);
+    }
+
+    static OverdrawStatistics EstimateOverdraw(const std::vector<uint32_t>& indices, const float* positions,
+                                               const size_t vertexCount, const size_t stride,
+                                               const uint32_t resolution = 256);
+};
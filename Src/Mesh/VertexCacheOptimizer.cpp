@@ -0,0 +1,212 @@
+#include "VertexCacheOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Log/Log.h"
+
+// --- Constants of the Forsyth scoring function (from the original article).
+static constexpr float CACHE_DECAY_POWER = 1.5f;
+static constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+static constexpr float VALENCE_BOOST_SCALE = 2.f;
+static constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Vertices with more remaining triangles use the score of this valence.
+static constexpr uint32_t MAX_SCORED_VALENCE = 32;
+
+std::vector<uint32_t> VertexCacheOptimizer::Optimize(const MeshBuildOptions& options,
+                                                     const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                                     TipsifyScratch& scratch)
+{
+    switch (options.vertexCacheOptimizer)
+    {
+    case EVertexCacheOptimizer::Tipsify:
+        return MeshUtils::Tipsify(indices, vertexCount, options.vertexCacheSize, scratch);
+    case EVertexCacheOptimizer::Forsyth:
+        return Forsyth(indices, vertexCount, options.vertexCacheSize);
+    case EVertexCacheOptimizer::None:
+    default:
+        return indices;
+    }
+}
+
+std::vector<uint32_t> VertexCacheOptimizer::Optimize(const MeshBuildOptions& options,
+                                                     const std::vector<uint32_t>& indices, const uint32_t vertexCount)
+{
+    TipsifyScratch scratch;
+    return Optimize(options, indices, vertexCount, scratch);
+}
+
+std::vector<uint32_t> VertexCacheOptimizer::Forsyth(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                                    const uint32_t cacheSize)
+{
+    ASSERT(cacheSize > 3, "The Forsyth optimizer needs a cache of at least 4 vertices!")
+
+    const size_t triangleCount = indices.size() / 3;
+
+    std::vector<uint32_t> outputIndices;
+    outputIndices.reserve(triangleCount * 3);
+
+    // --- Score tables. The last triangle has a fixed score, so it isn't favoured over its neighbours.
+    std::vector<float> cacheScores(cacheSize);
+
+    for (uint32_t i = 0; i < cacheSize; i++)
+    {
+        cacheScores[i] =
+            i < 3 ? LAST_TRIANGLE_SCORE
+                  : std::pow(1.f - static_cast<float>(i - 3) / static_cast<float>(cacheSize - 3), CACHE_DECAY_POWER);
+    }
+
+    float valenceScores[MAX_SCORED_VALENCE + 1];
+    valenceScores[0] = 0.f;
+
+    for (uint32_t i = 1; i <= MAX_SCORED_VALENCE; i++)
+    {
+        valenceScores[i] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+    }
+
+    // The cache position is -1 when the vertex isn't in the cache.
+    const auto scoreVertex = [&](const uint32_t liveTriangles, const int32_t cachePosition) {
+        if (liveTriangles == 0)
+        {
+            return -1.f;
+        }
+
+        const float cacheScore = cachePosition < 0 ? 0.f : cacheScores[cachePosition];
+        return cacheScore + valenceScores[std::min(liveTriangles, MAX_SCORED_VALENCE)];
+    };
+
+    // The live triangles of a vertex are kept at the front of its adjacency list.
+    VertexTriangleAdjacency adjacency;
+    MeshUtils::BuildVertexTriangleAdjacency(indices.data(), indices.size(), vertexCount, adjacency);
+
+    std::vector<uint32_t>& liveTriangles = adjacency.vertexCount;
+
+    std::vector<float> vertexScores(vertexCount);
+
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        vertexScores[v] = scoreVertex(liveTriangles[v], -1);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        triangleScores[t] =
+            vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    }
+
+    std::vector<uint8_t> emittedTriangles(triangleCount, 0);
+
+    // Marks the vertices of the emitted triangle, so they aren't added to the cache twice.
+    std::vector<uint32_t> vertexMarks(vertexCount, 0);
+
+    // The triangle vertices are pushed to the front and up to 3 vertices fall out of the end.
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(cacheSize + 3);
+    nextCache.reserve(cacheSize + 3);
+
+    size_t cursor = 0;
+    int64_t bestTriangle = -1;
+
+    for (size_t emitted = 0; emitted < triangleCount; emitted++)
+    {
+        // Nothing in the cache has live triangles, continue with the first triangle not emitted yet.
+        if (bestTriangle < 0)
+        {
+            while (emittedTriangles[cursor])
+            {
+                cursor++;
+            }
+
+            bestTriangle = cursor;
+        }
+
+        const uint32_t* triangle = &indices[bestTriangle * 3];
+
+        emittedTriangles[bestTriangle] = 1;
+        outputIndices.insert(outputIndices.end(), triangle, triangle + 3);
+
+        nextCache.clear();
+
+        const uint32_t mark = emitted + 1;
+
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const uint32_t v = triangle[i];
+
+            // Degenerate triangles reference the vertex several times, but it takes a single cache entry.
+            if (vertexMarks[v] != mark)
+            {
+                vertexMarks[v] = mark;
+                nextCache.emplace_back(v);
+            }
+
+            // Swap the triangle out of the live part of the adjacency list.
+            uint32_t* first = adjacency.adjacencyList.data() + adjacency.offsets[v];
+            uint32_t* last = first + liveTriangles[v];
+            uint32_t* found = std::find(first, last, static_cast<uint32_t>(bestTriangle));
+
+            ASSERT(found != last, "The emitted triangle is missing in the adjacency of its vertex!")
+
+            std::swap(*found, *(last - 1));
+            liveTriangles[v]--;
+        }
+
+        for (const uint32_t v : cache)
+        {
+            if (vertexMarks[v] != mark)
+            {
+                nextCache.emplace_back(v);
+            }
+        }
+
+        std::swap(cache, nextCache);
+
+        // --- Rescore the vertices whose cache position changed (including the evicted ones) and their triangles.
+        for (size_t i = 0; i < cache.size(); i++)
+        {
+            const uint32_t v = cache[i];
+
+            const float score = scoreVertex(liveTriangles[v], i < cacheSize ? static_cast<int32_t>(i) : -1);
+            const float delta = score - vertexScores[v];
+
+            vertexScores[v] = score;
+
+            const uint32_t* first = adjacency.adjacencyList.data() + adjacency.offsets[v];
+
+            for (const uint32_t* t = first; t != first + liveTriangles[v]; t++)
+            {
+                triangleScores[*t] += delta;
+            }
+        }
+
+        // A triangle can be adjacent to several of the cached vertices, so the best one is searched only once all
+        // the scores are final.
+        bestTriangle = -1;
+        float bestScore = -1.f;
+
+        for (size_t i = 0; i < std::min<size_t>(cache.size(), cacheSize); i++)
+        {
+            const uint32_t v = cache[i];
+            const uint32_t* first = adjacency.adjacencyList.data() + adjacency.offsets[v];
+
+            for (const uint32_t* t = first; t != first + liveTriangles[v]; t++)
+            {
+                if (triangleScores[*t] > bestScore)
+                {
+                    bestScore = triangleScores[*t];
+                    bestTriangle = *t;
+                }
+            }
+        }
+
+        if (cache.size() > cacheSize)
+        {
+            cache.resize(cacheSize);
+        }
+    }
+
+    return outputIndices;
+}
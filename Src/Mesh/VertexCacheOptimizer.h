@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh/MeshBuildOptions.h"
+#include "MeshUtils.h"
+
+/**
+ * Reorders the triangles of an index buffer for the post-transform vertex cache with the algorithm selected by
+ * MeshBuildOptions::vertexCacheOptimizer. Compare the results with MeshUtils::AnalyzeVertexCache.
+ */
+class VertexCacheOptimizer
+{
+  public:
+    /**
+     * @brief Optimizes the indices with the selected optimizer and options.vertexCacheSize.
+     * @param scratch - reused by Tipsify, so the LODs of a mesh can share it.
+     */
+    static std::vector<uint32_t> Optimize(const MeshBuildOptions& options, const std::vector<uint32_t>& indices,
+                                          const uint32_t vertexCount, TipsifyScratch& scratch);
+
+    static std::vector<uint32_t> Optimize(const MeshBuildOptions& options, const std::vector<uint32_t>& indices,
+                                          const uint32_t vertexCount);
+
+    /**
+     * @brief Tom Forsyth's Linear-Speed Vertex Cache Optimisation. Greedily emits the triangle with the highest sum
+     * of the scores of its vertices. A vertex scores by its position in a simulated LRU cache and by the number of
+     * its remaining triangles, so the lonely vertices get finished early.
+     * @param cacheSize - number of entries of the simulated cache, at least 4.
+     */
+    static std::vector<uint32_t> Forsyth(const std::vector<uint32_t>& indices, const uint32_t vertexCount,
+                                         const uint32_t cacheSize);
+};
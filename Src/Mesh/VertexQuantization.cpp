@@ -0,0 +1,442 @@
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../Log/Log.h"
+#include "MeshUtils.h"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+static constexpr float UNORM16_MAX = 65535.f;
+static constexpr float SNORM16_MAX = 32767.f;
+static constexpr float SNORM8_MAX = 127.f;
+
+// Same conversions as unpackSnorm2x16 and unpackSnorm4x8 in GLSL.
+static int16_t ToSnorm16(const float value)
+{
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * SNORM16_MAX));
+}
+
+static float FromSnorm16(const int16_t value)
+{
+    return std::max(value / SNORM16_MAX, -1.f);
+}
+
+static int8_t ToSnorm8(const float value)
+{
+    return static_cast<int8_t>(std::lround(std::clamp(value, -1.f, 1.f) * SNORM8_MAX));
+}
+
+static float FromSnorm8(const int8_t value)
+{
+    return std::max(value / SNORM8_MAX, -1.f);
+}
+
+static VertexQuantizationInfo ReadInfo(const MeshDataView& data)
+{
+    ASSERT(data.GetSize(EMeshSection::VertexQuantization) == sizeof(VertexQuantizationInfo),
+           "The quantization of the vertices of the mesh is missing!")
+
+    VertexQuantizationInfo info;
+    std::memcpy(&info, data.GetData(EMeshSection::VertexQuantization), sizeof(VertexQuantizationInfo));
+
+    return info;
+}
+
+static void EncodePosition(const glm::vec3& position, const VertexQuantizationInfo& info, uint16_t outEncoded[3])
+{
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        // A flat axis has a zero scale, all of its positions are at the offset.
+        const float scale = info.positionScale[axis];
+        const float value = scale > 0.f ? (position[axis] - info.positionOffset[axis]) / scale : 0.f;
+
+        outEncoded[axis] = static_cast<uint16_t>(std::lround(std::clamp(value, 0.f, UNORM16_MAX)));
+    }
+}
+
+VertexQuantizationInfo VertexQuantization::ComputeInfo(const std::vector<MeshVertex>& vertices)
+{
+    const AABB bounds = MeshUtils::CreateBoundingBox(vertices);
+
+    return {
+        .positionOffset = glm::vec4(bounds.minPoint.x, bounds.minPoint.y, bounds.minPoint.z, 0.f),
+        .positionScale = glm::vec4((bounds.maxPoint.x - bounds.minPoint.x) / UNORM16_MAX,
+                                   (bounds.maxPoint.y - bounds.minPoint.y) / UNORM16_MAX,
+                                   (bounds.maxPoint.z - bounds.minPoint.z) / UNORM16_MAX, 0.f),
+    };
+}
+
+std::vector<QuantizedVertex> VertexQuantization::Encode(const std::vector<MeshVertex>& vertices,
+                                                        const VertexQuantizationInfo& info)
+{
+    std::vector<QuantizedVertex> quantized(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const MeshVertex& vertex = vertices[i];
+        QuantizedVertex& encoded = quantized[i];
+
+        EncodePosition(vertex.Position, info, encoded.position);
+        encoded.padding = 0;
+
+        EncodeOctahedral(vertex.Normal, encoded.normal);
+        EncodeTangentFrame(vertex.Normal, vertex.Tangent, vertex.BiTangent, encoded.tangentFrame);
+
+        encoded.texCoords[0] = FloatToHalf(vertex.TexCoords.x);
+        encoded.texCoords[1] = FloatToHalf(vertex.TexCoords.y);
+    }
+
+    return quantized;
+}
+
+VertexQuantizationInfo VertexQuantization::QuantizePositions(const EVertexFormat format,
+                                                             std::vector<MeshVertex>& vertices)
+{
+    if (format == EVertexFormat::Full)
+    {
+        return {
+            .positionOffset = glm::vec4(0.f, 0.f, 0.f, 0.f),
+            .positionScale = glm::vec4(1.f, 1.f, 1.f, 0.f),
+        };
+    }
+
+    const VertexQuantizationInfo info = ComputeInfo(vertices);
+
+    for (MeshVertex& vertex : vertices)
+    {
+        QuantizedVertex encoded;
+        EncodePosition(vertex.Position, info, encoded.position);
+
+        vertex.Position = DecodePosition(encoded, info);
+    }
+
+    return info;
+}
+
+void VertexQuantization::SetVertices(MeshData& data, const EVertexFormat format, std::vector<MeshVertex>&& vertices,
+                                     const VertexQuantizationInfo& info)
+{
+    data.header.vertexFormat = format;
+
+    if (format == EVertexFormat::Full)
+    {
+        data.Set(EMeshSection::Vertices, std::move(vertices));
+        return;
+    }
+
+    data.Set(EMeshSection::Vertices, Encode(vertices, info));
+    data.Set(EMeshSection::VertexQuantization, &info, 1);
+
+    std::vector<MeshVertex>().swap(vertices);
+}
+
+MeshVertex VertexQuantization::Decode(const QuantizedVertex& vertex, const VertexQuantizationInfo& info)
+{
+    MeshVertex decoded{};
+    decoded.Position = DecodePosition(vertex, info);
+    decoded.Normal = DecodeOctahedral(vertex.normal);
+    DecodeTangentFrame(vertex.tangentFrame, decoded.Tangent, decoded.BiTangent);
+    decoded.TexCoords = {HalfToFloat(vertex.texCoords[0]), HalfToFloat(vertex.texCoords[1])};
+
+    return decoded;
+}
+
+glm::vec3 VertexQuantization::DecodePosition(const QuantizedVertex& vertex, const VertexQuantizationInfo& info)
+{
+    return {
+        info.positionOffset.x + vertex.position[0] * info.positionScale.x,
+        info.positionOffset.y + vertex.position[1] * info.positionScale.y,
+        info.positionOffset.z + vertex.position[2] * info.positionScale.z,
+    };
+}
+
+float VertexQuantization::GetMaxPositionError(const VertexQuantizationInfo& info)
+{
+    const glm::vec3 offset(info.positionOffset.x, info.positionOffset.y, info.positionOffset.z);
+    const glm::vec3 scale(info.positionScale.x, info.positionScale.y, info.positionScale.z);
+    const glm::vec3 farthest = glm::abs(offset) + scale * UNORM16_MAX;
+
+    // Rounded to the nearest step on every axis, plus the rounding of the float math of the decoding.
+    return 0.5f * glm::length(scale) + 2.f * std::numeric_limits<float>::epsilon() * glm::length(farthest);
+}
+
+std::vector<MeshVertex> VertexQuantization::ReadVertices(const MeshDataView& data)
+{
+    if (data.header.vertexFormat == EVertexFormat::Full)
+    {
+        return data.Copy<MeshVertex>(EMeshSection::Vertices);
+    }
+
+    const VertexQuantizationInfo info = ReadInfo(data);
+    const QuantizedVertex* quantized = data.Get<QuantizedVertex>(EMeshSection::Vertices);
+
+    std::vector<MeshVertex> vertices(data.GetCount<QuantizedVertex>(EMeshSection::Vertices));
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        vertices[i] = Decode(quantized[i], info);
+    }
+
+    return vertices;
+}
+
+void VertexQuantization::ReadPositions(const MeshDataView& data, MeshPositions& outPositions)
+{
+    if (data.header.vertexFormat == EVertexFormat::Full)
+    {
+        outPositions.Assign(data.Get<MeshVertex>(EMeshSection::Vertices),
+                            data.GetCount<MeshVertex>(EMeshSection::Vertices));
+        return;
+    }
+
+    const VertexQuantizationInfo info = ReadInfo(data);
+    const QuantizedVertex* quantized = data.Get<QuantizedVertex>(EMeshSection::Vertices);
+    const size_t count = data.GetCount<QuantizedVertex>(EMeshSection::Vertices);
+
+    outPositions.x.resize(count);
+    outPositions.y.resize(count);
+    outPositions.z.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const glm::vec3 position = DecodePosition(quantized[i], info);
+
+        outPositions.x[i] = position.x;
+        outPositions.y[i] = position.y;
+        outPositions.z[i] = position.z;
+    }
+}
+
+void VertexQuantization::EncodeOctahedral(const glm::vec3& normal, int16_t outEncoded[2])
+{
+    const float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+
+    // A missing normal is stored as +Z, the encoding has no zero vector.
+    if (l1 == 0.f)
+    {
+        outEncoded[0] = outEncoded[1] = 0;
+        return;
+    }
+
+    float u = normal.x / l1;
+    float v = normal.y / l1;
+
+    // The lower hemisphere is folded over the diagonals.
+    if (normal.z < 0.f)
+    {
+        const float foldedU = (1.f - std::fabs(v)) * (u >= 0.f ? 1.f : -1.f);
+        const float foldedV = (1.f - std::fabs(u)) * (v >= 0.f ? 1.f : -1.f);
+
+        u = foldedU;
+        v = foldedV;
+    }
+
+    outEncoded[0] = ToSnorm16(u);
+    outEncoded[1] = ToSnorm16(v);
+}
+
+glm::vec3 VertexQuantization::DecodeOctahedral(const int16_t encoded[2])
+{
+    glm::vec3 normal(FromSnorm16(encoded[0]), FromSnorm16(encoded[1]), 0.f);
+    normal.z = 1.f - std::fabs(normal.x) - std::fabs(normal.y);
+
+    const float fold = std::max(-normal.z, 0.f);
+
+    normal.x += normal.x >= 0.f ? -fold : fold;
+    normal.y += normal.y >= 0.f ? -fold : fold;
+
+    return glm::normalize(normal);
+}
+
+void VertexQuantization::EncodeTangentFrame(const glm::vec3& normal, const glm::vec3& tangent,
+                                            const glm::vec3& biTangent, int8_t outFrame[4])
+{
+    const glm::vec3 n = glm::dot(normal, normal) > 0.f ? glm::normalize(normal) : glm::vec3(0.f, 0.f, 1.f);
+
+    glm::vec3 t = tangent - n * glm::dot(n, tangent);
+
+    if (glm::dot(t, t) < 1e-12f)
+    {
+        t = glm::cross(std::fabs(n.x) < 0.9f ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f), n);
+    }
+
+    t = glm::normalize(t);
+
+    const glm::vec3 b = glm::cross(n, t);
+    const bool leftHanded = glm::dot(b, biTangent) < 0.f;
+
+    // --- Quaternion of the rotation matrix with the columns t, b and n.
+    const float m00 = t.x, m01 = b.x, m02 = n.x;
+    const float m10 = t.y, m11 = b.y, m12 = n.y;
+    const float m20 = t.z, m21 = b.z, m22 = n.z;
+
+    float q[4];
+    const float trace = m00 + m11 + m22;
+
+    if (trace > 0.f)
+    {
+        const float s = std::sqrt(trace + 1.f) * 2.f;
+        q[0] = (m21 - m12) / s;
+        q[1] = (m02 - m20) / s;
+        q[2] = (m10 - m01) / s;
+        q[3] = 0.25f * s;
+    }
+    else if (m00 > m11 && m00 > m22)
+    {
+        const float s = std::sqrt(1.f + m00 - m11 - m22) * 2.f;
+        q[0] = 0.25f * s;
+        q[1] = (m01 + m10) / s;
+        q[2] = (m02 + m20) / s;
+        q[3] = (m21 - m12) / s;
+    }
+    else if (m11 > m22)
+    {
+        const float s = std::sqrt(1.f + m11 - m00 - m22) * 2.f;
+        q[0] = (m01 + m10) / s;
+        q[1] = 0.25f * s;
+        q[2] = (m12 + m21) / s;
+        q[3] = (m02 - m20) / s;
+    }
+    else
+    {
+        const float s = std::sqrt(1.f + m22 - m00 - m11) * 2.f;
+        q[0] = (m02 + m20) / s;
+        q[1] = (m12 + m21) / s;
+        q[2] = 0.25f * s;
+        q[3] = (m10 - m01) / s;
+    }
+
+    // q and -q are the same rotation, so the sign of w is free for the handedness. w is kept away from zero,
+    // otherwise its sign would be lost by the quantization.
+    const float sign = q[3] < 0.f ? -1.f : 1.f;
+
+    for (float& component : q)
+    {
+        component *= sign;
+    }
+
+    constexpr float W_BIAS = 1.f / SNORM8_MAX;
+
+    if (q[3] < W_BIAS)
+    {
+        const float xyzLength = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+        const float scale = std::sqrt(1.f - W_BIAS * W_BIAS) / xyzLength;
+
+        q[0] *= scale;
+        q[1] *= scale;
+        q[2] *= scale;
+        q[3] = W_BIAS;
+    }
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        outFrame[i] = ToSnorm8(leftHanded ? -q[i] : q[i]);
+    }
+}
+
+void VertexQuantization::DecodeTangentFrame(const int8_t frame[4], glm::vec3& outTangent, glm::vec3& outBiTangent)
+{
+    float x = FromSnorm8(frame[0]), y = FromSnorm8(frame[1]), z = FromSnorm8(frame[2]), w = FromSnorm8(frame[3]);
+
+    const float length = std::sqrt(x * x + y * y + z * z + w * w);
+    x /= length;
+    y /= length;
+    z /= length;
+    w /= length;
+
+    const float handedness = w < 0.f ? -1.f : 1.f;
+
+    // The first two columns of the rotation matrix.
+    outTangent = {1.f - 2.f * (y * y + z * z), 2.f * (x * y + w * z), 2.f * (x * z - w * y)};
+    outBiTangent = glm::vec3(2.f * (x * y - w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z + w * x)) * handedness;
+}
+
+uint16_t VertexQuantization::FloatToHalf(const float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN.
+    if (exponent == 0xFF)
+    {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+    }
+
+    const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+    if (halfExponent >= 31)
+    {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // --- Rounded to the nearest even, a carry out of the mantissa correctly raises the exponent.
+    if (halfExponent <= 0)
+    {
+        // Denormal or zero.
+        if (halfExponent < -10)
+        {
+            return static_cast<uint16_t>(sign);
+        }
+
+        mantissa |= 0x800000;
+
+        const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+
+        if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+        {
+            half++;
+        }
+
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFF;
+
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+    {
+        half++;
+    }
+
+    return static_cast<uint16_t>(sign | half);
+}
+
+float VertexQuantization::HalfToFloat(const uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1F;
+    const uint32_t mantissa = value & 0x3FF;
+
+    if (exponent == 0)
+    {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+
+    uint32_t bits;
+
+    if (exponent == 31)
+    {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(float));
+
+    return result;
+}
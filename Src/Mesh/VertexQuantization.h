@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MeshData.h"
+#include "MeshResidency.h"
+#include "MeshVertex.h"
+#include "glm/ext/vector_float4.hpp"
+
+/**
+ * Vertex of EVertexFormat::Quantized, 20 bytes instead of the 80 of MeshVertex. Read by the shaders as 5 uints with
+ * Res/Shaders/include/vertex_quantization.glsl.
+ */
+struct QuantizedVertex
+{
+    // unorm16 in the bounds of the mesh (see VertexQuantizationInfo).
+    uint16_t position[3];
+    uint16_t padding;
+    // Octahedral encoding, snorm16.
+    int16_t normal[2];
+    // Quaternion rotating the X and Y axes onto the tangent and the bitangent, snorm8. The sign of w is the
+    // handedness of the bitangent.
+    int8_t tangentFrame[4];
+    // Half floats.
+    uint16_t texCoords[2];
+};
+
+static_assert(sizeof(QuantizedVertex) == 20, "The shaders read the quantized vertices as 5 uints!");
+
+/**
+ * Dequantization of the positions, uploaded next to the vertices. Follows the std430 layout.
+ */
+struct VertexQuantizationInfo
+{
+    // position = offset + quantized * scale
+    glm::vec4 positionOffset;
+    glm::vec4 positionScale;
+};
+
+/**
+ * Converts the vertices between MeshVertex and QuantizedVertex. The decoding mirrors the one in
+ * Res/Shaders/include/vertex_quantization.glsl.
+ *
+ * The positions are quantized to the bounds of the whole mesh, not of the meshlets, because the meshlets share
+ * their vertices. The normal keeps 16 bits per component of its octahedral encoding, the tangent frame only needs 8
+ * bits per component of its quaternion.
+ */
+class VertexQuantization
+{
+  public:
+    /**
+     * @brief Computes the bounds the positions are quantized to.
+     */
+    static VertexQuantizationInfo ComputeInfo(const std::vector<MeshVertex>& vertices);
+
+    static std::vector<QuantizedVertex> Encode(const std::vector<MeshVertex>& vertices,
+                                               const VertexQuantizationInfo& info);
+
+    /**
+     * @brief Computes the quantization for the format and moves the positions onto the ones the shaders decode. Has
+     * to be called before the meshlet bounds are computed, so their spheres and normal cones hold for the decoded
+     * triangles. Leaves the vertices as they are for EVertexFormat::Full.
+     * @return the quantization to pass to SetVertices
+     */
+    static VertexQuantizationInfo QuantizePositions(const EVertexFormat format, std::vector<MeshVertex>& vertices);
+
+    /**
+     * @brief Sets the Vertices section of the cooked mesh in the format, together with the VertexQuantization
+     * section for the quantized one.
+     * @param vertices - freed afterwards
+     * @param info - returned by QuantizePositions for the same vertices
+     */
+    static void SetVertices(MeshData& data, const EVertexFormat format, std::vector<MeshVertex>&& vertices,
+                            const VertexQuantizationInfo& info);
+
+    static MeshVertex Decode(const QuantizedVertex& vertex, const VertexQuantizationInfo& info);
+
+    static glm::vec3 DecodePosition(const QuantizedVertex& vertex, const VertexQuantizationInfo& info);
+
+    /**
+     * @brief Largest distance of a decoded position from the original one.
+     */
+    static float GetMaxPositionError(const VertexQuantizationInfo& info);
+
+    /**
+     * @brief Returns the vertices of the view as MeshVertex, decoded if they are quantized.
+     */
+    static std::vector<MeshVertex> ReadVertices(const MeshDataView& data);
+
+    /**
+     * @brief Keeps only the positions of the vertices of the view, decoded if they are quantized.
+     */
+    static void ReadPositions(const MeshDataView& data, MeshPositions& outPositions);
+
+    static void EncodeOctahedral(const glm::vec3& normal, int16_t outEncoded[2]);
+    static glm::vec3 DecodeOctahedral(const int16_t encoded[2]);
+
+    /**
+     * @brief Encodes the frame into a quaternion, see QuantizedVertex::tangentFrame. The tangent is made orthogonal
+     * to the normal first, a missing tangent is replaced by any axis orthogonal to the normal.
+     */
+    static void EncodeTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& biTangent,
+                                   int8_t outFrame[4]);
+    static void DecodeTangentFrame(const int8_t frame[4], glm::vec3& outTangent, glm::vec3& outBiTangent);
+
+    static uint16_t FloatToHalf(const float value);
+    static float HalfToFloat(const uint16_t value);
+};
@@ -20,11 +20,48 @@ struct VertexTriangleAdjacency
         }
     };
 
-    std::vector<uint32_t> indices;
+    /**
+     * Non-owning range of the triangle indices adjacent to a vertex. Stays valid until the adjacency is modified.
+     */
+    struct TriangleSpan
+    {
+        const uint32_t* first = nullptr;
+        const uint32_t* last = nullptr;
+
+        const uint32_t* begin() const
+        {
+            return first;
+        }
+
+        const uint32_t* end() const
+        {
+            return last;
+        }
+
+        size_t size() const
+        {
+            return last - first;
+        }
+    };
+
+    // Non-owning view of the index buffer the adjacency was built from. It has to outlive the adjacency for
+    // GetTriangles to work.
+    const uint32_t* indices = nullptr;
+    size_t indexCount = 0;
+
     std::vector<uint32_t> vertexCount;
     std::vector<uint32_t> offsets;
     std::vector<uint32_t> adjacencyList;
 
+    /**
+     * @brief Same as GetTriangleIndices without copying them.
+     */
+    TriangleSpan GetTriangleSpan(const size_t vertexIndex) const
+    {
+        const uint32_t* first = adjacencyList.data() + offsets[vertexIndex];
+        return {.first = first, .last = first + vertexCount[vertexIndex]};
+    }
+
     std::vector<uint32_t> GetTriangleIndices(const size_t vertexIndex)
     {
         const uint32_t offset = offsets[vertexIndex];
@@ -49,6 +86,7 @@ struct VertexTriangleAdjacency
 
         ASSERT(offset < adjacencyList.size() && (offset + triangleCount) <= adjacencyList.size(),
                "Failed to get triangles! Triangle accessing out of bounds of the indices array!");
+        ASSERT(indices != nullptr, "Failed to get triangles! The adjacency has no index buffer!");
 
         for (int i = offset; i < offset + triangleCount; i++)
         {
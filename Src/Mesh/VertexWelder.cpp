@@ -0,0 +1,197 @@
+#include "VertexWelder.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "../ThreadUtils.h"
+
+// Below this many vertices everything is welded in one partition on the calling thread.
+static constexpr size_t MIN_PARALLEL_WELD_VERTICES = 1 << 15;
+
+// Vertices handled by one work item of the quantization and the partitioning.
+static constexpr size_t WELD_CHUNK_VERTICES = 1 << 14;
+
+// Indices handled by one work item of RemapIndices.
+static constexpr size_t REMAP_CHUNK_INDICES = 1 << 16;
+
+// Never a valid slot, the vertex indices are below 0xFFFFFFFF.
+static constexpr uint64_t EMPTY_SLOT = 0xFFFFFFFFFFFFFFFFull;
+
+static uint64_t HashAttributes(const float* attributes, const size_t attributeCount)
+{
+    // FNV-1a over the 32-bit words, finished with the murmur mix so the top bits are usable for the partitioning.
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < attributeCount; i++)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &attributes[i], sizeof(uint32_t));
+
+        hash = (hash ^ bits) * 0x100000001B3ull;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+size_t VertexWelder::BuildWeldRemap(float* attributes, const size_t attributeCount, const size_t vertexCount,
+                                    const float* steps, uint32_t threadCount, std::vector<uint32_t>& outRemap)
+{
+    if (threadCount == 0)
+    {
+        threadCount = ThreadUtils::GetThreadCount();
+    }
+
+    outRemap.resize(vertexCount);
+
+    // --- Quantization and hashing. Adding 0 turns -0 into +0, so both of them hash the same.
+    std::vector<uint64_t> hashes(vertexCount);
+
+    const size_t chunkCount = (vertexCount + WELD_CHUNK_VERTICES - 1) / WELD_CHUNK_VERTICES;
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        const size_t end = std::min(vertexCount, (chunk + 1) * WELD_CHUNK_VERTICES);
+
+        for (size_t v = chunk * WELD_CHUNK_VERTICES; v < end; v++)
+        {
+            float* attribute = attributes + v * attributeCount;
+
+            for (size_t a = 0; a < attributeCount; a++)
+            {
+                attribute[a] = (steps[a] > 0.f ? std::round(attribute[a] / steps[a]) : attribute[a]) + 0.f;
+            }
+
+            hashes[v] = HashAttributes(attribute, attributeCount);
+        }
+    });
+
+    // --- Vertices sorted by the partition of their hash, keeping their order within the partition.
+    uint32_t partitionBits = 0;
+
+    while (vertexCount >= MIN_PARALLEL_WELD_VERTICES && (1u << partitionBits) < threadCount * 4 &&
+           partitionBits < 8)
+    {
+        partitionBits++;
+    }
+
+    const size_t partitionCount = size_t(1) << partitionBits;
+    const auto getPartition = [&](const size_t v) {
+        return partitionBits == 0 ? 0 : static_cast<size_t>(hashes[v] >> (64 - partitionBits));
+    };
+
+    std::vector<uint32_t> histograms(chunkCount * partitionCount, 0);
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        const size_t end = std::min(vertexCount, (chunk + 1) * WELD_CHUNK_VERTICES);
+
+        for (size_t v = chunk * WELD_CHUNK_VERTICES; v < end; v++)
+        {
+            histograms[chunk * partitionCount + getPartition(v)]++;
+        }
+    });
+
+    // The chunks follow each other within every partition.
+    std::vector<uint32_t> partitionOffsets(partitionCount + 1);
+    uint32_t offset = 0;
+
+    for (size_t p = 0; p < partitionCount; p++)
+    {
+        partitionOffsets[p] = offset;
+
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            const uint32_t count = histograms[chunk * partitionCount + p];
+            histograms[chunk * partitionCount + p] = offset;
+            offset += count;
+        }
+    }
+
+    partitionOffsets[partitionCount] = offset;
+
+    std::vector<uint32_t> order(vertexCount);
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        uint32_t* cursors = histograms.data() + chunk * partitionCount;
+        const size_t end = std::min(vertexCount, (chunk + 1) * WELD_CHUNK_VERTICES);
+
+        for (size_t v = chunk * WELD_CHUNK_VERTICES; v < end; v++)
+        {
+            order[cursors[getPartition(v)]++] = v;
+        }
+    });
+
+    // --- Every partition points its vertices to the first vertex with the same attributes.
+    ThreadUtils::ParallelFor(partitionCount, threadCount, [&](const size_t partition, const uint32_t) {
+        const uint32_t first = partitionOffsets[partition];
+        const uint32_t count = partitionOffsets[partition + 1] - first;
+
+        size_t tableSize = 16;
+
+        while (tableSize < count * 2)
+        {
+            tableSize *= 2;
+        }
+
+        // The slots keep the upper half of the hash next to the vertex, so most of the mismatches are rejected
+        // without touching the attributes of the other vertex.
+        std::vector<uint64_t> table(tableSize, EMPTY_SLOT);
+
+        for (uint32_t i = first; i < first + count; i++)
+        {
+            const uint32_t v = order[i];
+            const float* attribute = attributes + v * attributeCount;
+            const uint64_t hashTag = hashes[v] & 0xFFFFFFFF00000000ull;
+
+            size_t slot = hashes[v] & (tableSize - 1);
+
+            while (table[slot] != EMPTY_SLOT)
+            {
+                const uint32_t candidate = static_cast<uint32_t>(table[slot]);
+
+                if ((table[slot] & 0xFFFFFFFF00000000ull) == hashTag &&
+                    std::memcmp(attributes + candidate * attributeCount, attribute, attributeCount * sizeof(float)) ==
+                        0)
+                {
+                    break;
+                }
+
+                slot = (slot + 1) & (tableSize - 1);
+            }
+
+            if (table[slot] == EMPTY_SLOT)
+            {
+                table[slot] = hashTag | v;
+            }
+
+            outRemap[v] = static_cast<uint32_t>(table[slot]);
+        }
+    });
+
+    // --- The first vertex of every set gets the next new index, the others take over the index of their first one.
+    uint32_t uniqueCount = 0;
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        outRemap[v] = outRemap[v] == v ? uniqueCount++ : outRemap[outRemap[v]];
+    }
+
+    return uniqueCount;
+}
+
+void VertexWelder::RemapIndices(uint32_t* indices, const size_t indexCount, const uint32_t* remap,
+                                const uint32_t threadCount)
+{
+    const size_t chunkCount = (indexCount + REMAP_CHUNK_INDICES - 1) / REMAP_CHUNK_INDICES;
+
+    ThreadUtils::ParallelFor(chunkCount, threadCount, [&](const size_t chunk, const uint32_t) {
+        const size_t end = std::min(indexCount, (chunk + 1) * REMAP_CHUNK_INDICES);
+
+        for (size_t i = chunk * REMAP_CHUNK_INDICES; i < end; i++)
+        {
+            indices[i] = remap[indices[i]];
+        }
+    });
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Merges the vertices with the same attributes, replaces aiProcess_JoinIdenticalVertices. The attributes are snapped
+ * to a grid with the step of the epsilon and hashed. The vertices are split into partitions by their hash and every
+ * partition is welded with its own hash table, so the partitions run in parallel.
+ */
+class VertexWelder
+{
+  public:
+    // Position, normal, tangent, bitangent (3 floats each) and texture coordinates (2 floats).
+    static constexpr uint32_t ATTRIBUTE_COUNT = 14;
+
+    /**
+     * @brief Welds the vertices and rewrites the indices to the welded ones. The welded vertices keep the order of
+     * their first occurrence and the attributes of the first vertex of every merged set.
+     * @param positionEpsilon - step of the position grid in the units of the mesh. 0 merges only the equal
+     * positions.
+     * @param attributeEpsilon - same for the other attributes.
+     * @param threadCount - maximum number of threads to use. 0 means use all the hardware threads.
+     * @return number of the vertices after welding.
+     */
+    template <typename TVertex>
+    static size_t Weld(std::vector<uint32_t>& indices, std::vector<TVertex>& vertices, const float positionEpsilon,
+                       const float attributeEpsilon, const uint32_t threadCount = 0)
+    {
+        std::vector<float> attributes(vertices.size() * ATTRIBUTE_COUNT);
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            const TVertex& vertex = vertices[i];
+
+            float* attribute = attributes.data() + i * ATTRIBUTE_COUNT;
+
+            const float values[ATTRIBUTE_COUNT] = {
+                vertex.Position.x,  vertex.Position.y,  vertex.Position.z,  vertex.Normal.x,    vertex.Normal.y,
+                vertex.Normal.z,    vertex.Tangent.x,   vertex.Tangent.y,   vertex.Tangent.z,   vertex.BiTangent.x,
+                vertex.BiTangent.y, vertex.BiTangent.z, vertex.TexCoords.x, vertex.TexCoords.y,
+            };
+
+            std::copy(values, values + ATTRIBUTE_COUNT, attribute);
+        }
+
+        float steps[ATTRIBUTE_COUNT];
+        std::fill(steps, steps + 3, positionEpsilon);
+        std::fill(steps + 3, steps + ATTRIBUTE_COUNT, attributeEpsilon);
+
+        std::vector<uint32_t> remap;
+        const size_t uniqueCount =
+            BuildWeldRemap(attributes.data(), ATTRIBUTE_COUNT, vertices.size(), steps, threadCount, remap);
+
+        // The first occurrences of the welded vertices come in the order of their new indices.
+        size_t written = 0;
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            if (remap[i] == written)
+            {
+                vertices[written++] = vertices[i];
+            }
+        }
+
+        vertices.resize(uniqueCount);
+
+        RemapIndices(indices.data(), indices.size(), remap.data(), threadCount);
+
+        return uniqueCount;
+    }
+
+    /**
+     * @brief Finds the vertices with the same quantized attributes.
+     * @param attributes - attributeCount floats per vertex. They are quantized in place.
+     * @param steps - quantization step of every attribute, 0 keeps the attribute as it is.
+     * @param outRemap - new index of every vertex. The new indices are assigned in the order of the first
+     * occurrence.
+     * @return number of the unique vertices.
+     */
+    static size_t BuildWeldRemap(float* attributes, const size_t attributeCount, const size_t vertexCount,
+                                 const float* steps, const uint32_t threadCount, std::vector<uint32_t>& outRemap);
+
+    /**
+     * @brief Replaces every index i with remap[i] in parallel.
+     */
+    static void RemapIndices(uint32_t* indices, const size_t indexCount, const uint32_t* remap,
+                             const uint32_t threadCount = 0);
+};
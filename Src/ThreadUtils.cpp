@@ -0,0 +1,75 @@
+#include "ThreadUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Threads available to the current thread, 0 means all the hardware threads.
+static thread_local uint32_t t_ThreadBudget = 0;
+
+uint32_t ThreadUtils::GetThreadCount()
+{
+    if (t_ThreadBudget > 0)
+    {
+        return t_ThreadBudget;
+    }
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadUtils::ParallelFor(const size_t count, uint32_t threadCount,
+                              const std::function<void(const size_t index, const uint32_t threadIndex)>& func)
+{
+    if (threadCount == 0)
+    {
+        threadCount = GetThreadCount();
+    }
+
+    const uint32_t budget = threadCount;
+    threadCount = static_cast<uint32_t>(std::min<size_t>(threadCount, count));
+
+    // --- Every worker gets its share of the budget, the calling thread gets its own one back at the end.
+    const uint32_t workerBudget = std::max(1u, budget / std::max(1u, threadCount));
+    const uint32_t callerBudget = t_ThreadBudget;
+
+    if (threadCount <= 1)
+    {
+        t_ThreadBudget = workerBudget;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            func(i, 0);
+        }
+
+        t_ThreadBudget = callerBudget;
+        return;
+    }
+
+    std::atomic<size_t> nextIndex = 0;
+
+    auto worker = [&](const uint32_t threadIndex) {
+        t_ThreadBudget = workerBudget;
+
+        for (size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            func(i, threadIndex);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+
+    for (uint32_t t = 1; t < threadCount; t++)
+    {
+        threads.emplace_back(worker, t);
+    }
+
+    worker(0);
+    t_ThreadBudget = callerBudget;
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
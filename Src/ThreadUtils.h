@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+class ThreadUtils
+{
+
+  public:
+    /**
+     * @brief Returns the number of threads available to the calling thread. Always at least 1. It is the number of
+     * the hardware threads, except inside of ParallelFor, where every worker gets its share of the threads the loop
+     * was given, so nested parallel loops and per-thread scratch buffers don't oversubscribe the CPU.
+     */
+    static uint32_t GetThreadCount();
+
+    /**
+     * @brief Calls the function for every index in the range [0, count) on up to threadCount threads. Indices are
+     * handed out dynamically, so the order in which they get processed is not defined. The calling thread also takes
+     * part in the work. Returns after all of the indices have been processed.
+     * @param count - number of work items.
+     * @param threadCount - maximum number of threads to use. 0 means use all the threads available (GetThreadCount).
+     * @param func - function taking the work item index and the index of the thread (in the range [0, threadCount))
+     * it is running on. The thread index can be used for picking per-thread scratch memory.
+     */
+    static void ParallelFor(const size_t count, uint32_t threadCount,
+                            const std::function<void(const size_t index, const uint32_t threadIndex)>& func);
+};
@@ -23,6 +23,7 @@ namespace VkCore
             m_UsageFlags = other.m_UsageFlags;
             m_IsHostVisible = other.m_IsHostVisible;
             m_IsMapped = other.m_IsMapped;
+            m_WasDestroyed = other.m_WasDestroyed;
 
             m_Buffer = other.m_Buffer;
             other.m_Buffer = VK_NULL_HANDLE;
@@ -48,6 +49,7 @@ namespace VkCore
             m_UsageFlags = other.m_UsageFlags;
             m_IsHostVisible = other.m_IsHostVisible;
             m_IsMapped = other.m_IsMapped;
+            m_WasDestroyed = other.m_WasDestroyed;
 
             m_Buffer = other.m_Buffer;
             other.m_Buffer = VK_NULL_HANDLE;
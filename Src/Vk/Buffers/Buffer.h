@@ -106,13 +106,13 @@ namespace VkCore
         void Destroy();
 
       private:
-        size_t m_Size;
-        bool m_IsDeviceLocal;
+        size_t m_Size = 0;
+        bool m_IsDeviceLocal = false;
         vk::BufferUsageFlags m_UsageFlags;
-        bool m_IsHostVisible, m_IsMapped, m_WasDestroyed;
-        VkBuffer m_Buffer;
-        VmaAllocation m_Allocation;
-        VmaAllocationInfo m_AllocationInfo;
+        bool m_IsHostVisible = false, m_IsMapped = false, m_WasDestroyed = false;
+        VkBuffer m_Buffer = VK_NULL_HANDLE;
+        VmaAllocation m_Allocation = VK_NULL_HANDLE;
+        VmaAllocationInfo m_AllocationInfo = {};
     };
 
     class VertexBuffer : public Buffer
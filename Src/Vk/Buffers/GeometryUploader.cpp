@@ -0,0 +1,157 @@
+#include "GeometryUploader.h"
+
+#include <cstring>
+#include <utility>
+
+#include "../../Log/Log.h"
+#include "../Devices/DeviceManager.h"
+#include "vulkan/vulkan_enums.hpp"
+#include "vulkan/vulkan_structs.hpp"
+
+namespace VkCore
+{
+
+    GeometryUploader::~GeometryUploader()
+    {
+        ASSERT(m_Pending.empty(), "Destroying a GeometryUploader with uploads which were never submitted!")
+
+        WaitAll();
+    }
+
+    void GeometryUploader::Upload(Buffer& buffer, const void* data, const size_t size)
+    {
+        ASSERT(data != nullptr, "Uploading an empty buffer on the GPU! Pointer to the data is nullptr!")
+
+        Upload(buffer, size, [data, size](void* mappedData) { std::memcpy(mappedData, data, size); });
+    }
+
+    void GeometryUploader::Upload(Buffer& buffer, const size_t size,
+                                  const std::function<void(void* mappedData)>& fill)
+    {
+        buffer.SetUsageFlags(buffer.GetUsageFlags() | vk::BufferUsageFlagBits::eTransferDst);
+        buffer.InitializeOnGpu(size);
+
+        m_Pending.emplace_back(PendingUpload{
+            .dstBuffer = buffer.GetVkBuffer(),
+            .size = size,
+            .fill = fill,
+        });
+
+        m_PendingSize = (m_PendingSize + size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    }
+
+    uint64_t GeometryUploader::Submit()
+    {
+        if (m_Pending.empty())
+        {
+            return m_LastValue;
+        }
+
+        Collect();
+
+        Device& device = DeviceManager::GetDevice();
+
+        Submission submission;
+        submission.value = ++m_LastValue;
+
+        submission.stagingBuffer = Buffer(vk::BufferUsageFlagBits::eTransferSrc);
+        submission.stagingBuffer.InitializeOnCpu(m_PendingSize);
+
+        uint8_t* staging = static_cast<uint8_t*>(submission.stagingBuffer.GetVmaAllocationInfo().pMappedData);
+
+        vk::CommandPoolCreateInfo poolInfo{};
+        poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+        poolInfo.queueFamilyIndex = DeviceManager::GetPhysicalDevice().GetQueueFamilyIndices().m_GraphicsFamily.value();
+
+        submission.cmdPool = device.CreateCommandPool(poolInfo);
+        submission.cmdBuffer = device.AllocateCommandBuffers(
+            vk::CommandBufferAllocateInfo{submission.cmdPool, vk::CommandBufferLevel::ePrimary, 1})[0];
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+        submission.cmdBuffer.begin(beginInfo);
+
+        // --- Fills the staging buffer front to back and records a copy per upload.
+        size_t offset = 0;
+
+        for (const PendingUpload& upload : m_Pending)
+        {
+            upload.fill(staging + offset);
+
+            const vk::BufferCopy copyRegion{offset, 0, upload.size};
+            submission.cmdBuffer.copyBuffer(submission.stagingBuffer.GetVkBuffer(), upload.dstBuffer, copyRegion);
+
+            offset = (offset + upload.size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+        }
+
+        // Makes the copies visible to everything submitted to the queue after them, so nobody has to wait for the
+        // fence before using the buffers.
+        const vk::MemoryBarrier memoryBarrier{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead};
+        submission.cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                             vk::PipelineStageFlagBits::eAllCommands, {}, memoryBarrier, {}, {});
+
+        submission.cmdBuffer.end();
+
+        submission.fence = device.CreateFence(vk::FenceCreateInfo{});
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(submission.cmdBuffer);
+
+        device.GetGraphicsQueue().submit(submitInfo, submission.fence);
+
+        LOGF(Allocation, Verbose, "Submitted %zu buffer uploads in one batch. Staging size: %zu", m_Pending.size(),
+             m_PendingSize)
+
+        m_Pending.clear();
+        m_PendingSize = 0;
+
+        m_Submissions.emplace_back(std::move(submission));
+
+        return m_LastValue;
+    }
+
+    bool GeometryUploader::IsComplete(const uint64_t value)
+    {
+        Collect();
+
+        return value <= m_CompletedValue;
+    }
+
+    void GeometryUploader::Wait(const uint64_t value)
+    {
+        Device& device = DeviceManager::GetDevice();
+
+        while (!m_Submissions.empty() && m_Submissions.front().value <= value)
+        {
+            const vk::Result result = device.WaitForFences(m_Submissions.front().fence, true);
+
+            ASSERT(result == vk::Result::eSuccess, "Failed to wait for the geometry upload!")
+
+            Release(m_Submissions.front());
+            m_Submissions.erase(m_Submissions.begin());
+        }
+    }
+
+    void GeometryUploader::Collect()
+    {
+        while (!m_Submissions.empty() &&
+               (*DeviceManager::GetDevice()).getFenceStatus(m_Submissions.front().fence) == vk::Result::eSuccess)
+        {
+            Release(m_Submissions.front());
+            m_Submissions.erase(m_Submissions.begin());
+        }
+    }
+
+    void GeometryUploader::Release(Submission& submission)
+    {
+        Device& device = DeviceManager::GetDevice();
+
+        device.DestroyFence(submission.fence);
+        device.FreeCommandBuffer(submission.cmdPool, submission.cmdBuffer);
+        device.DestroyCommandPool(submission.cmdPool);
+        submission.stagingBuffer.Destroy();
+
+        m_CompletedValue = submission.value;
+    }
+} // namespace VkCore
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Buffer.h"
+#include "vulkan/vulkan.hpp"
+
+namespace VkCore
+{
+
+    /**
+     * Uploads the data of many device local buffers at once. Instead of a staging buffer, a command buffer and a
+     * stall of the queue per buffer, every batch of uploads gets one staging buffer and one submission to the
+     * graphics queue.
+     *
+     * The uploads are only recorded until Submit is called, so the data passed in has to stay valid until then.
+     * Submit doesn't wait for the copies, it returns a value which grows with every submission. The submission ends
+     * with a memory barrier, so the buffers can be used right away by anything submitted to the graphics queue later,
+     * only the staging memory is kept until the copies are done (see IsComplete and Wait).
+     */
+    class GeometryUploader
+    {
+      public:
+        // Alignment of every upload in the staging buffer.
+        static constexpr size_t STAGING_ALIGNMENT = 16;
+
+        GeometryUploader() = default;
+        GeometryUploader(const GeometryUploader& other) = delete;
+        GeometryUploader& operator=(const GeometryUploader& other) = delete;
+
+        /**
+         * @brief Waits for all the submitted uploads and frees their staging memory. Everything recorded has to be
+         * submitted by now.
+         */
+        ~GeometryUploader();
+
+        /**
+         * @brief Creates the device local buffer right away and records the upload of its data. The buffer can be
+         * bound to descriptor sets straight after.
+         * @param buffer - buffer with the usage flags already set (see the Buffer(usageFlags) constructor).
+         * @param data - read at the next Submit, not copied before that!
+         * @param size - size of data in BYTES
+         */
+        void Upload(Buffer& buffer, const void* data, const size_t size);
+
+        /**
+         * @brief Creates the device local buffer right away and records the upload of its data, which is written by
+         * the fill function straight into the staging buffer at the next Submit.
+         * @param fill - writes exactly size bytes to the mapped memory. The memory is write combined, so it should be
+         * written front to back and never read.
+         */
+        void Upload(Buffer& buffer, const size_t size, const std::function<void(void* mappedData)>& fill);
+
+        /**
+         * @brief Packs the data of all the recorded uploads into one staging buffer and copies them in one submission.
+         * Doesn't wait for the copies to finish.
+         * @return value of the submission for IsComplete and Wait. The value of the last submission if nothing was
+         * recorded.
+         */
+        uint64_t Submit();
+
+        /**
+         * @brief Checks whether the submission with the value (and all the ones before) has finished, without
+         * waiting. Frees the staging memory of all the finished submissions.
+         */
+        bool IsComplete(const uint64_t value);
+
+        /**
+         * @brief Waits for the submission with the value and all the ones before it and frees their staging memory.
+         */
+        void Wait(const uint64_t value);
+
+        void WaitAll()
+        {
+            Wait(m_LastValue);
+        }
+
+        /**
+         * @brief Size in BYTES of the staging buffer needed by the recorded uploads.
+         */
+        size_t GetPendingSize() const
+        {
+            return m_PendingSize;
+        }
+
+      private:
+        struct PendingUpload
+        {
+            vk::Buffer dstBuffer;
+            size_t size;
+            std::function<void(void* mappedData)> fill;
+        };
+
+        struct Submission
+        {
+            uint64_t value = 0;
+            vk::Fence fence;
+            vk::CommandPool cmdPool;
+            vk::CommandBuffer cmdBuffer;
+            Buffer stagingBuffer;
+        };
+
+        std::vector<PendingUpload> m_Pending;
+        size_t m_PendingSize = 0;
+
+        // Submissions in flight, in the order of their values.
+        std::vector<Submission> m_Submissions;
+        uint64_t m_LastValue = 0;
+        uint64_t m_CompletedValue = 0;
+
+        /**
+         * @brief Frees the submissions from the front, whose fences are signaled.
+         */
+        void Collect();
+
+        void Release(Submission& submission);
+    };
+} // namespace VkCore
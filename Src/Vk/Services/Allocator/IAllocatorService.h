@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "../../Buffers/Buffer.h"
 #include "vulkan/vulkan_core.h"
 #include "vulkan/vulkan_structs.hpp"
@@ -22,6 +24,16 @@ namespace VkCore
         virtual VkBuffer CreateBufferOnGpu(const void* data, const size_t size, const vk::BufferUsageFlags usageFlags,
                                            VmaAllocation& allocation, VmaAllocationInfo* allocationInfo) = 0;
 
+        /**
+         * @brief Creates a new GPU-only visible buffer and lets the caller write the data straight into the mapped
+         * staging buffer, so the data doesn't need another copy on the CPU (for example when it is decoded).
+         * @param fill - writes exactly size bytes to the mapped memory. The memory is write combined, so it should
+         * be written front to back and never read.
+         */
+        virtual VkBuffer CreateBufferOnGpu(const size_t size, const std::function<void(void* mappedData)>& fill,
+                                           const vk::BufferUsageFlags usageFlags, VmaAllocation& allocation,
+                                           VmaAllocationInfo* allocationInfo) = 0;
+
         virtual void UpdateBufferOnGpu(const Buffer& buffer, const void* data, size_t size) = 0;
 
         /**
@@ -83,6 +83,18 @@ namespace VkCore
 
         return VK_NULL_HANDLE;
     }
+
+    VkBuffer NullAllocatorService::CreateBufferOnGpu(const size_t size,
+                                                     const std::function<void(void* mappedData)>& fill,
+                                                     const vk::BufferUsageFlags usageFlags, VmaAllocation& allocation,
+                                                     VmaAllocationInfo* allocationInfo)
+    {
+        LOG(Allocation, Fatal,
+            "Allocation service couldn't be located! Please make sure you have provided an allocation service!")
+
+        return VK_NULL_HANDLE;
+    }
+
     void NullAllocatorService::UpdateBufferOnGpu(const Buffer& buffer, const void* data, size_t size)
     {
 
@@ -63,6 +63,10 @@ namespace VkCore
         VkBuffer CreateBufferOnGpu(const void* data, const size_t size, const vk::BufferUsageFlags usageFlags,
                                    VmaAllocation& allocation, VmaAllocationInfo* allocationInfo) override;
 
+        VkBuffer CreateBufferOnGpu(const size_t size, const std::function<void(void* mappedData)>& fill,
+                                   const vk::BufferUsageFlags usageFlags, VmaAllocation& allocation,
+                                   VmaAllocationInfo* allocationInfo) override;
+
         void UpdateBufferOnGpu(const Buffer& buffer, const void* data, size_t size) override;
 
         /**
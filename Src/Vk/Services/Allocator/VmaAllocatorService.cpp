@@ -248,6 +248,17 @@ namespace VkCore
     {
 
         ASSERT(data != nullptr, "Allocating an empty buffer on the GPU! Pointer to the data is nullptr!")
+
+        return CreateBufferOnGpu(
+            size, [&](void* mappedData) { std::memcpy(mappedData, data, size); }, usageFlags, allocation,
+            allocationInfo);
+    }
+
+    VkBuffer VmaAllocatorService::CreateBufferOnGpu(const size_t size,
+                                                    const std::function<void(void* mappedData)>& fill,
+                                                    const vk::BufferUsageFlags usageFlags, VmaAllocation& allocation,
+                                                    VmaAllocationInfo* allocationInfo)
+    {
         ASSERTF(size > 0, "Couldn't allocate buffer on the GPU! Buffer size is invalid! (size <= 0)! Given size was %d",
                 size)
 
@@ -261,8 +272,8 @@ namespace VkCore
                 VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
             stagingAllocation, &stagingAllocationInfo);
 
-        // Copy the data from the memory to the staging buffer.
-        std::memcpy(stagingAllocationInfo.pMappedData, data, size);
+        // Let the caller fill the staging buffer.
+        fill(stagingAllocationInfo.pMappedData);
 
         // Create the GPU Buffer.
         VkBuffer gpuBuffer = CreateBuffer(size, {}, usageFlags | vk::BufferUsageFlagBits::eTransferDst, {},
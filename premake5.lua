@@ -114,3 +114,84 @@ project("VulkanCore")
     filter { "action:vs*", "architecture:x86_64" }
         buildoptions { "/arch:AVX" }
 
+
+filter{}
+
+-- Headless benchmark of the CPU side of the geometry pipeline. It doesn't create any Vulkan objects,
+-- so it can be run on a machine without a GPU.
+project("MeshletBench")
+	kind("ConsoleApp")
+	architecture("x86_64")
+
+	language("C++")
+	cppdialect("C++17")
+
+	targetdir("../bin/" .. output_dir .. "/%{prj.name}")
+	objdir("../obj/" .. output_dir .. "/%{prj.name}")
+
+	links{ "VulkanCore", "GLFW", "GLM" }
+
+	includedirs{
+		"Vendor/glfw/include/",
+		"Vendor/glm/",
+		"Vendor/stb/",
+		"Vendor/vma/",
+		"Vendor/assimp/include/",
+		"Vendor/ZMath/",
+		"Vendor/meshoptimizer",
+		"Src/",
+	}
+
+	files{
+		"./Bench/MeshletBench/**.cpp",
+		"./Bench/MeshletBench/**.h",
+	}
+
+	filter{ "system:linux" }
+
+		includedirs{
+			"$(VULKAN_SDK)/include/",
+		}
+
+		libdirs{
+			"$(VULKAN_SDK)/lib/",
+		}
+
+		links{ "vulkan", "pthread", "libshaderc_shared", "assimp" }
+
+		defines{
+			"_X11",
+		}
+
+	filter{ "system:windows" }
+
+		includedirs{
+			"$(VULKAN_SDK)/Include",
+			"$(VK_SDK_PATH)/Include",
+		}
+
+		libdirs{
+			"$(VULKAN_SDK)/Lib",
+			"$(VK_SDK_PATH)/Lib",
+			"Vendor/assimp/lib/windows-x64",
+		}
+
+		links{ "vulkan-1", "shaderc_combined", "assimp-vc143-mtd" }
+
+		defines{ "_WIN32" }
+
+		buildoptions{ "/MD" }
+
+	filter("configurations:Release")
+		defines{ "NDEBUG" }
+		optimize("on")
+
+	filter("configurations:Debug")
+		defines{ "DEBUG" }
+		symbols("on")
+
+    filter { "action:gmake2", "architecture:x86_64" }
+        buildoptions { "-mavx" }
+
+    filter { "action:vs*", "architecture:x86_64" }
+        buildoptions { "/arch:AVX" }